@@ -8,11 +8,15 @@
 
 
 #include "BGPMessage.hpp"
+#include <utility>
 
 
-BGPMessage::BGPMessage(BGPMessage& p_Msg)
+BGPMessage::BGPMessage(const BGPMessage& p_Msg):m_Type(p_Msg.m_Type), m_BGPIdentifier(p_Msg.m_BGPIdentifier), m_OutboundInterface(p_Msg.m_OutboundInterface), m_AS(p_Msg.m_AS), m_HoldDownTime(p_Msg.m_HoldDownTime), m_MsgId(p_Msg.m_MsgId), m_Epoch(p_Msg.m_Epoch), m_Message(p_Msg.m_Message), m_Update(p_Msg.m_Update)
+{
+}
+
+BGPMessage::BGPMessage(BGPMessage&& p_Msg):m_Type(p_Msg.m_Type), m_BGPIdentifier(std::move(p_Msg.m_BGPIdentifier)), m_OutboundInterface(p_Msg.m_OutboundInterface), m_AS(p_Msg.m_AS), m_HoldDownTime(p_Msg.m_HoldDownTime), m_MsgId(p_Msg.m_MsgId), m_Epoch(p_Msg.m_Epoch), m_Message(std::move(p_Msg.m_Message)), m_Update(std::move(p_Msg.m_Update))
 {
-    *this = p_Msg;
 }
 
 
@@ -23,10 +27,28 @@ BGPMessage& BGPMessage::operator = (const BGPMessage& p_Msg)
     m_BGPIdentifier = p_Msg.m_BGPIdentifier;
     m_OutboundInterface = p_Msg.m_OutboundInterface;
     m_Message = p_Msg.m_Message;
+    m_Update = p_Msg.m_Update;
 	m_AS = p_Msg.m_AS;
 	m_HoldDownTime = p_Msg.m_HoldDownTime;
 	m_MsgId = p_Msg.m_MsgId;
+	m_Epoch = p_Msg.m_Epoch;
+
+
+    return *this;
+}
 
+BGPMessage& BGPMessage::operator = (BGPMessage&& p_Msg)
+{
+    //Remember to add all members fields here
+    m_Type = p_Msg.m_Type;
+    m_BGPIdentifier = std::move(p_Msg.m_BGPIdentifier);
+    m_OutboundInterface = p_Msg.m_OutboundInterface;
+    m_Message = std::move(p_Msg.m_Message);
+    m_Update = std::move(p_Msg.m_Update);
+	m_AS = p_Msg.m_AS;
+	m_HoldDownTime = p_Msg.m_HoldDownTime;
+	m_MsgId = p_Msg.m_MsgId;
+	m_Epoch = p_Msg.m_Epoch;
 
     return *this;
 }
@@ -34,7 +56,7 @@ BGPMessage& BGPMessage::operator = (const BGPMessage& p_Msg)
 
 
 bool BGPMessage::operator == (const BGPMessage& p_Msg) const {
-    return (m_Type == p_Msg.m_Type && m_BGPIdentifier == p_Msg.m_BGPIdentifier && m_OutboundInterface == p_Msg.m_OutboundInterface && m_Message == p_Msg.m_Message && m_AS == p_Msg.m_AS && m_HoldDownTime == p_Msg.m_HoldDownTime && m_MsgId == p_Msg.m_MsgId);
+    return (m_Type == p_Msg.m_Type && m_BGPIdentifier == p_Msg.m_BGPIdentifier && m_OutboundInterface == p_Msg.m_OutboundInterface && m_Message == p_Msg.m_Message && m_Update == p_Msg.m_Update && m_AS == p_Msg.m_AS && m_HoldDownTime == p_Msg.m_HoldDownTime && m_MsgId == p_Msg.m_MsgId && m_Epoch == p_Msg.m_Epoch);
 }
 
 void BGPMessage::clearMessage(void)
@@ -43,7 +65,9 @@ void BGPMessage::clearMessage(void)
 	m_Type = -1;
     m_OutboundInterface = 0;
     m_Message = "";
+    m_Update.clear();
 	m_MsgId = 0;
+	m_Epoch = 0;
     m_BGPIdentifier = "";
 	m_AS = -1;
 	m_HoldDownTime = 0;
@@ -13,6 +13,8 @@
 
 
 #include <systemc>
+#include <memory>
+#include "BGPUpdate.hpp"
 
 
 using std::cout;
@@ -104,6 +106,13 @@ public:
 
     unsigned long m_MsgId;
 
+    /*! \property unsigned long m_Epoch
+     * \brief The incarnation of the sending control plane
+     * \details The message ids start from 1 again in each epoch
+     * \public
+     */
+    unsigned long m_Epoch;
+
     /*! \property string m_Message 
      * \brief BGP message fields
      * \details 
@@ -111,11 +120,32 @@ public:
      */
     string m_Message;
 
-    BGPMessage():m_Type(-1), m_OutboundInterface(-1){};
+    /*! \property BGPUpdate m_Update
+     * \brief Withdrawn routes, path attributes and NLRI of an UPDATE
+     * \details
+     * \public
+     */
+    BGPUpdate m_Update;
+
+    BGPMessage():m_Type(-1), m_OutboundInterface(-1), m_AS(-1), m_HoldDownTime(0), m_MsgId(0), m_Epoch(0){};
 
     ~BGPMessage(){};
 
-    BGPMessage(BGPMessage& p_Msg);
+    /*!
+     * \brief Copy constructor
+     * \details The dotted-quad identifiers fit in the small string
+     * buffer of std::string, so only the update and a long m_Message
+     * allocate memory
+     * \public
+     */
+    BGPMessage(const BGPMessage& p_Msg);
+
+    /*!
+     * \brief Move constructor
+     * \details Takes over the strings and the update of p_Msg
+     * \public
+     */
+    BGPMessage(BGPMessage&& p_Msg);
 
 
 
@@ -135,7 +165,9 @@ public:
     inline friend ostream& operator << (ostream& os,  BGPMessage const & p_Msg )
     {
 
-        os << endl  << "BGP type: " << p_Msg.m_Type  << " BGP identifier: " << p_Msg.m_BGPIdentifier  << " BGP session interface: " << p_Msg.m_OutboundInterface  << " AS number: " << p_Msg.m_AS  << endl <<"MsgId: " << p_Msg.m_MsgId << " Hold-down: " << p_Msg.m_HoldDownTime << " Message: " << p_Msg.m_Message;
+        os << endl  << "BGP type: " << p_Msg.m_Type  << " BGP identifier: " << p_Msg.m_BGPIdentifier  << " BGP session interface: " << p_Msg.m_OutboundInterface  << " AS number: " << p_Msg.m_AS  << endl <<"MsgId: " << p_Msg.m_MsgId << " Epoch: " << p_Msg.m_Epoch << " Hold-down: " << p_Msg.m_HoldDownTime << " Message: " << p_Msg.m_Message;
+        if(p_Msg.m_Type == UPDATE)
+            os << " Update: " << p_Msg.m_Update.toString();
         return os;
     }
 
@@ -164,6 +196,14 @@ public:
      */
     BGPMessage& operator = (const BGPMessage& p_Msg);
 
+    /*!
+     * \brief Overload of move assign operator
+     * \details Takes over the strings and the update of p_Msg, which
+     * are left empty
+     * \public
+     */
+    BGPMessage& operator = (BGPMessage&& p_Msg);
+
 
 
     /*!
@@ -183,4 +223,13 @@ private:
 };
 
 
+/*!
+ * \brief Owning handle of a BGPMessage
+ * \details The modules of a router pass the received and the sent
+ * messages to each other as handles, which are moved from one buffer
+ * to the next instead of copying the message
+ */
+typedef std::unique_ptr<BGPMessage> BGPMessageHandle;
+
+
 #endif
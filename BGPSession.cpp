@@ -9,8 +9,9 @@
 
 #include "BGPSession.hpp"
 #include "ReportGlobals.hpp"
+#include "ClockTick.hpp"
 
-BGPSession::BGPSession(sc_module_name p_ModuleName, BGPSessionParameters * const p_SessionParam):sc_module(p_ModuleName), m_PeerAS(-1), m_PeeringInterface(0), m_Config(p_SessionParam), m_ReSend(false), m_RetransmissonCount(0), m_KeepaliveFlag(false), m_Client(false), m_NewFsmInput(false)
+BGPSession::BGPSession(sc_module_name p_ModuleName, BGPSessionParameters * const p_SessionParam):sc_module(p_ModuleName), m_PeerAS(-1), m_PeeringInterface(0), m_SessionValidity(false), m_Config(p_SessionParam), m_UpdateSent(false), m_ReSend(false), m_RetransmissonCount(0), m_KeepaliveFlag(false), m_Client(false), m_NewFsmInput(false), m_FsmWait(WAIT_START)
 {
 
 	setBGPCurrentState(IDLE);
@@ -18,35 +19,28 @@ BGPSession::BGPSession(sc_module_name p_ModuleName, BGPSessionParameters * const
 	m_ConnectionCurrentState = SYN;
 	m_ConnectionPreviousState = ACK;
 
-    m_KeepaliveMsg.m_OutboundInterface = m_PeeringInterface;
-    m_KeepaliveMsg.m_Type = KEEPALIVE;
-
 	m_RTool.setBaseName(name());
     m_RTool.setStampTime(true);
     
     srand(time(NULL));
     m_TCPId = rand()%0xFFFF;
 
-    //Register keepaliveTimer method to the SystemC kernel
-    SC_THREAD(keepaliveTimer);
-    //    dont_initialize();
-    // sensitive << m_BGPKeepalive;
-
-    //Register sessionInvalidation method to the SystemC kernel
-    SC_THREAD(sessionInvalidation);
-    // dont_initialize();
-    // sensitive << m_BGPHoldDown;
-
-    //Register retransmissionTimer method to the SystemC kernel
-    SC_THREAD(retransmissionTimer);
+    //The timers are run by the timer service of the router
+    m_BGPKeepalive.client = m_BGPHoldDown.client = m_Retransmission.client = this;
+    m_BGPKeepalive.id = KEEPALIVE_TIMER;
+    m_BGPHoldDown.id = HOLDDOWN_TIMER;
+    m_Retransmission.id = RETRANSMISSION_TIMER;
 
-    SC_THREAD(fsmRoutine);
+    SC_METHOD(fsmRoutine);
+#ifndef _EVENT_DRIVEN
     sensitive << port_Clk;
+    dont_initialize();
+#endif
 
 
 }
 
-BGPSession::BGPSession(sc_module_name p_ModuleName, int p_PeeringInterface, BGPSessionParameters * const p_SessionParam):sc_module(p_ModuleName), m_PeerAS(-1), m_PeeringInterface(p_PeeringInterface), m_Config(p_SessionParam), m_ReSend(false), m_RetransmissonCount(0), m_KeepaliveFlag(false), m_Client(false), m_NewFsmInput(false)
+BGPSession::BGPSession(sc_module_name p_ModuleName, int p_PeeringInterface, BGPSessionParameters * const p_SessionParam):sc_module(p_ModuleName), m_PeerAS(-1), m_PeeringInterface(p_PeeringInterface), m_SessionValidity(false), m_Config(p_SessionParam), m_UpdateSent(false), m_ReSend(false), m_RetransmissonCount(0), m_KeepaliveFlag(false), m_Client(false), m_NewFsmInput(false), m_FsmWait(WAIT_START)
 {
 
 	setBGPCurrentState(IDLE);
@@ -54,11 +48,6 @@ BGPSession::BGPSession(sc_module_name p_ModuleName, int p_PeeringInterface, BGPS
 	m_ConnectionCurrentState = SYN;
 	m_ConnectionPreviousState = ACK;
 
-	m_BGPOut.m_OutboundInterface = m_PeeringInterface;
-
-    m_KeepaliveMsg.m_OutboundInterface = m_PeeringInterface;
-    m_KeepaliveMsg.m_Type = KEEPALIVE;
-
 	m_RTool.setBaseName(name());
     m_RTool.setStampTime(true);
 
@@ -71,21 +60,17 @@ BGPSession::BGPSession(sc_module_name p_ModuleName, int p_PeeringInterface, BGPS
 
 
 
-    //Register keepaliveTimer method to the SystemC kernel
-    SC_THREAD(keepaliveTimer);
-    //    dont_initialize();
-    // sensitive << m_BGPKeepalive;
-
-    //Register sessionInvalidation method to the SystemC kernel
-    SC_THREAD(sessionInvalidation);
-    // dont_initialize();
-    // sensitive << m_BGPHoldDown;
+    //The timers are run by the timer service of the router
+    m_BGPKeepalive.client = m_BGPHoldDown.client = m_Retransmission.client = this;
+    m_BGPKeepalive.id = KEEPALIVE_TIMER;
+    m_BGPHoldDown.id = HOLDDOWN_TIMER;
+    m_Retransmission.id = RETRANSMISSION_TIMER;
 
-    //Register retransmissionTimer method to the SystemC kernel
-    SC_THREAD(retransmissionTimer);
-
-    SC_THREAD(fsmRoutine);
+    SC_METHOD(fsmRoutine);
+#ifndef _EVENT_DRIVEN
     sensitive << port_Clk;
+    dont_initialize();
+#endif
 
 }
 
@@ -96,18 +81,24 @@ BGPSession::~BGPSession()
 }
 
 
-void BGPSession::keepaliveTimer(void)
+void BGPSession::timerExpired(int p_Timer)
 {
-    while(true)
+    switch(p_Timer)
         {
-            wait(m_BGPKeepalive);
-
+        case KEEPALIVE_TIMER:
             setKeepaliveFlag(true);
-
-
+            break;
+        case HOLDDOWN_TIMER:
+            SC_REPORT_INFO(g_ReportID, m_RTool.newReportString("Hold-down timer expired. Session is invalid."));
+            setBGPCurrentState(IDLE);
+            break;
+        case RETRANSMISSION_TIMER:
+            setReSend(true);
+            break;
+        default:
+            break;
         }
-
-    
+    m_TimerExpired.notify(SC_ZERO_TIME);
 }
 
 void BGPSession::setKeepaliveFlag(bool p_Value)
@@ -124,324 +115,340 @@ bool BGPSession::isKeepaliveTime(void)
 
 void BGPSession::sendKeepalive(void)
 {
-	port_ToDataPlane->write(m_KeepaliveMsg);
-
-}
-
-void BGPSession::sessionInvalidation(void)
-{
-
-    while(true)
-        {
-            wait(m_BGPHoldDown);
-
-            SC_REPORT_INFO(g_ReportID, m_RTool.newReportString("Hold-down timer expired. Session is invalid."));
-            setBGPCurrentState(IDLE);
-
-        }
+	newOutput(KEEPALIVE);
+	output(port_ToDataPlane, m_BGPOut);
 
 }
 
-void BGPSession::retransmissionTimer(void)
+void BGPSession::fsmRoutine(void)
 {
-
-	while(true)
+#ifdef _EVENT_DRIVEN
+	//an event woke up the FSM, step at the next edge
+	if(m_FsmWait == WAIT_EVENTS)
 	{
-		wait(m_Retransmission);
-		setReSend(true);
+		m_FsmWait = WAIT_EDGE;
+		next_trigger(timeToNextEdge(CLOCK_PERIOD/2.0));
+		return;
 	}
-
+	//the first call only sets the trigger
+	if(m_FsmWait == WAIT_EDGE)
+		fsmStep();
+	waitForWork();
+#else
+	fsmStep();
+#endif
 }
 
-void BGPSession::fsmRoutine(void)
+void BGPSession::fsmStep(void)
 {
+	//the FSM is held until the earlier messages are written
+	if(!flushOutbox())
+		return;
 
-	while(true)
+	if(m_FsmInputBuffer.nb_read(m_BGPIn))
 	{
-
-		wait();
-		if(m_FsmInputBuffer.num_available() > 0)
+		if(!m_InputFilter.accept(m_BGPIn->m_Epoch, m_BGPIn->m_MsgId))
 		{
-			m_BGPInPrevious = m_BGPIn;
-			m_FsmInputBuffer.read(m_BGPIn);
-			if(m_BGPInPrevious == m_BGPIn)
-			{
-				cout << name() << ": Received a duplicated message" << endl;
-				m_NewFsmInput = false;
-			}
-			else
-			{
-				m_NewFsmInput = true;
-//				cout << name() << ": received from if: " << m_BGPIn.m_OutboundInterface << endl;
-			}
+			SC_REPORT_INFO(g_DebugBSID, m_RTool.newReportString("Received a duplicated message"));
+			m_NewFsmInput = false;
 		}
 		else
-			m_NewFsmInput = false;
+		{
+			m_NewFsmInput = true;
+//				cout << name() << ": received from if: " << m_BGPIn->m_OutboundInterface << endl;
+		}
+	}
+	else
+		m_NewFsmInput = false;
+
+	//BGP FSM starts
+	switch (m_BGPCurrentState)
+	{
+	case IDLE: //IDLE state
+		fsmReportRoutineBGP("BGP state: IDLE");
 
-		//BGP FSM starts
-		switch (m_BGPCurrentState)
+		//make sure that the session is stopped
+		sessionStop();
+		//if the session interface is up transition to the CONNECT state
+		if(port_InterfaceControl->isUp())
 		{
-		case IDLE: //IDLE state
-			fsmReportRoutineBGP("BGP state: IDLE");
+			m_RetransmissonCount = 0;
+			setBGPCurrentState(CONNECT);
+			m_ConnectionCurrentState = SYN;
+			m_BeeingHere = false;
+			setRetransmissionTimer(TCP_RT_DELAY);
 
-			//make sure that the session is stopped
-			sessionStop();
-			//if the session interface is up transition to the CONNECT state
-			if(port_InterfaceControl->isUp())
+		}
+		break;
+	case CONNECT:
+		fsmReportRoutineBGP("BGP state: CONNECT");
+		switch (m_ConnectionCurrentState)
+		{
+		case SYN:
+			if(m_Client) //client does
 			{
-				m_RetransmissonCount = 0;
-				setBGPCurrentState(CONNECT);
-				m_ConnectionCurrentState = SYN;
-				m_BeeingHere = false;
+
+				fsmReportRoutineConnection("Connection state: CLIENT SYN");
+				stopRetransmissionTimer();
+				//build the syn message
+				newOutput(TCP_SYN).m_AS = m_TCPId;
+				output(port_ToDataPlane, m_BGPOut);
 				setRetransmissionTimer(TCP_RT_DELAY);
+				m_ConnectionCurrentState = ACK;
+				m_BeeingHere = true;
 
 			}
-			break;
-		case CONNECT:
-			fsmReportRoutineBGP("BGP state: CONNECT");
-			switch (m_ConnectionCurrentState)
+			else
 			{
-			case SYN:
-				if(m_Client) //client does
-				{
+				fsmReportRoutineConnection("Connection state: SERVER SYN");
 
-					fsmReportRoutineConnection("Connection state: CLIENT SYN");
-					stopRetransmissionTimer();
-					//build the syn message
-					m_BGPOut.m_Type = TCP_SYN;
-					m_BGPOut.m_AS = m_TCPId;
-					port_ToDataPlane->write(m_BGPOut);
-					setRetransmissionTimer(TCP_RT_DELAY);
-					m_ConnectionCurrentState = ACK;
-					m_BeeingHere = true;
-
-				}
-				else
+				//handle only if the input is for this session
+				if(m_NewFsmInput && m_BGPIn->m_OutboundInterface == m_PeeringInterface)
 				{
-					fsmReportRoutineConnection("Connection state: SERVER SYN");
-
-					//handle only if the input is for this session
-					if(m_BGPIn.m_OutboundInterface == m_PeeringInterface && m_NewFsmInput)
+					if(m_BGPIn->m_Type == TCP_SYN)
 					{
-						if(m_BGPIn.m_Type == TCP_SYN)
-						{
-							stopRetransmissionTimer();
-							m_TCPId = m_BGPIn.m_AS;
-							m_BGPOut = m_BGPIn;
-							m_BGPOut.m_Type = TCP_SYNACK;
-							port_ToDataPlane->write(m_BGPOut);
-							setRetransmissionTimer(TCP_RT_DELAY);
-							m_ConnectionCurrentState = ACK;
-						}
+						stopRetransmissionTimer();
+						m_TCPId = m_BGPIn->m_AS;
+						newOutput(TCP_SYNACK).m_AS = m_TCPId;
+						output(port_ToDataPlane, m_BGPOut);
+						setRetransmissionTimer(TCP_RT_DELAY);
+						m_ConnectionCurrentState = ACK;
 					}
-					else if(m_ReSend)
-						setBGPCurrentState(ACTIVE);
 				}
-				break;
-			case ACK:
-				if(m_Client)
+				else if(m_ReSend)
+					setBGPCurrentState(ACTIVE);
+			}
+			break;
+		case ACK:
+			if(m_Client)
+			{
+				fsmReportRoutineConnection("Connection state: CLIENT ACK");
+				//handle only if the input is for this session
+				if(m_NewFsmInput && m_BGPIn->m_OutboundInterface == m_PeeringInterface)
 				{
-					fsmReportRoutineConnection("Connection state: CLIENT ACK");
-					//handle only if the input is for this session
-					if(m_BGPIn.m_OutboundInterface == m_PeeringInterface && m_NewFsmInput)
+					if(m_BGPIn->m_Type == TCP_SYNACK)
 					{
-						if(m_BGPIn.m_Type == TCP_SYNACK)
+						if (m_BGPIn->m_AS == m_TCPId)
 						{
-							if (m_BGPIn.m_AS == m_TCPId)
-							{
-								stopRetransmissionTimer();
-								m_BGPOut = m_BGPIn;
-								m_BGPOut.m_Type = TCP_ACK;
-								port_ToDataPlane->write(m_BGPOut);
-								m_ConnectionCurrentState = OPEN_SEND;
-							}
-
+							stopRetransmissionTimer();
+							newOutput(TCP_ACK).m_AS = m_TCPId;
+							output(port_ToDataPlane, m_BGPOut);
+							m_ConnectionCurrentState = OPEN_SEND;
 						}
-					}
-					else if(m_ReSend)
-						setBGPCurrentState(ACTIVE);
 
+					}
 				}
-				else
-				{
-					fsmReportRoutineConnection("Connection state: SERVER ACK");
+				else if(m_ReSend)
+					setBGPCurrentState(ACTIVE);
+
+			}
+			else
+			{
+				fsmReportRoutineConnection("Connection state: SERVER ACK");
 
-					if(m_BGPIn.m_OutboundInterface == m_PeeringInterface && m_NewFsmInput)
+				if(m_NewFsmInput && m_BGPIn->m_OutboundInterface == m_PeeringInterface)
+				{
+					if(m_BGPIn->m_Type == TCP_ACK)
 					{
-						if(m_BGPIn.m_Type == TCP_ACK)
+						if (m_BGPIn->m_AS == m_TCPId)
 						{
-							if (m_BGPIn.m_AS == m_TCPId)
-							{
-								stopRetransmissionTimer();
-								m_ConnectionCurrentState = OPEN_SEND;
-							}
-
+							stopRetransmissionTimer();
+							m_ConnectionCurrentState = OPEN_SEND;
 						}
-					}
-					else if(m_ReSend)
-						setBGPCurrentState(ACTIVE);
 
+					}
 				}
-				break;
-			case OPEN_SEND:
-				if(m_Client)
-					fsmReportRoutineConnection("Connection state: CLIENT OPEN_SEND");
-				else
-					fsmReportRoutineConnection("Connection state: SERVER OPEN_SEND");
-
-				//build the open message
-				m_BGPOut.m_Type = OPEN;
-				m_BGPOut.m_BGPIdentifier = m_Config->getBGPIdentifier();
-				m_BGPOut.m_HoldDownTime = m_Config->getHoldDownTime();
-				m_BGPOut.m_AS = m_Config->getASNumber();
-				m_BGPOut.m_OutboundInterface = m_PeeringInterface;
-				//cout << name() << " peering interface is " << m_BGPOut.m_OutboundInterface << endl;
-				port_ToDataPlane->write(m_BGPOut);
-				setRetransmissionTimer(OPENSEND_RT_DELAY);
-				setBGPCurrentState(OPEN_SENT);
-
-				break;
-			default:
-
-				break;
+				else if(m_ReSend)
+					setBGPCurrentState(ACTIVE);
+
 			}
 			break;
-			case ACTIVE:
-				if( m_RetransmissonCount == 0)
+		case OPEN_SEND:
+			if(m_Client)
+				fsmReportRoutineConnection("Connection state: CLIENT OPEN_SEND");
+			else
+				fsmReportRoutineConnection("Connection state: SERVER OPEN_SEND");
+
+			//build the open message
+			newOutput(OPEN);
+			m_BGPOut->m_BGPIdentifier = m_Config->getBGPIdentifier();
+			m_BGPOut->m_HoldDownTime = m_Config->getHoldDownTime();
+			m_BGPOut->m_AS = m_Config->getASNumber();
+			//cout << name() << " peering interface is " << m_BGPOut->m_OutboundInterface << endl;
+			output(port_ToDataPlane, m_BGPOut);
+			setRetransmissionTimer(OPENSEND_RT_DELAY);
+			setBGPCurrentState(OPEN_SENT);
+
+			break;
+		default:
+
+			break;
+		}
+		break;
+		case ACTIVE:
+			if( m_RetransmissonCount == 0)
+			{
+				m_RetransmissonCount++;
+				m_ConnectionCurrentState = SYN;
+				setBGPCurrentState(CONNECT);
+				setReSend(false);
+				if(m_BGPPreviousState == CONNECT)
 				{
-					m_RetransmissonCount++;
-					m_ConnectionCurrentState = SYN;
-					setBGPCurrentState(CONNECT);
-					setReSend(false);
-					if(m_BGPPreviousState == CONNECT)
-					{
-						fsmReportRoutineBGP("BGP state: ACTIVE after CONNECT");
-					}
-					else if(m_BGPPreviousState == OPEN_SENT)
-					{
-						fsmReportRoutineBGP("BGP state: ACTIVE after OPEN_SENT");
+					fsmReportRoutineBGP("BGP state: ACTIVE after CONNECT");
+				}
+				else if(m_BGPPreviousState == OPEN_SENT)
+				{
+					fsmReportRoutineBGP("BGP state: ACTIVE after OPEN_SENT");
 
-					}
-					else
-					{
-						fsmReportRoutineBGP("BGP state: ACTIVE after UNKNOWN");
-						setBGPCurrentState(IDLE);
-					}
 				}
 				else
 				{
+					fsmReportRoutineBGP("BGP state: ACTIVE after UNKNOWN");
 					setBGPCurrentState(IDLE);
 				}
+			}
+			else
+			{
+				setBGPCurrentState(IDLE);
+			}
 
-				break;
-			case OPEN_SENT:
-				fsmReportRoutineBGP("BGP state: OPEN_SENT");
+			break;
+		case OPEN_SENT:
+			fsmReportRoutineBGP("BGP state: OPEN_SENT");
 
-				if(m_BGPIn.m_OutboundInterface == m_PeeringInterface && m_NewFsmInput)
+			if(m_NewFsmInput && m_BGPIn->m_OutboundInterface == m_PeeringInterface)
+			{
+				//				cout << name() << ":: received an open message from bgp id:" << m_BGPIn->m_BGPIdentifier << ", type: " << m_BGPIn->m_Type << ":@ "<< sc_time_stamp() << endl;
+				if(m_BGPIn->m_Type == OPEN)
 				{
-					//				cout << name() << ":: received an open message from bgp id:" << m_BGPIn.m_BGPIdentifier << ", type: " << m_BGPIn.m_Type << ":@ "<< sc_time_stamp() << endl;
-					if(m_BGPIn.m_Type == OPEN)
-					{
-						stopRetransmissionTimer();
-						//agree on HoldDown time
-						if(m_Config->getHoldDownTime() > m_BGPIn.m_HoldDownTime)
-							m_Config->setHoldDownTime(m_BGPIn.m_HoldDownTime);
-						m_Config->setASNumber(m_BGPIn.m_AS);
-						setPeerIdentifier(m_BGPIn.m_BGPIdentifier);
-						sendKeepalive();
-						setRetransmissionTimer(m_Config->getHoldDownTime());
-						setBGPCurrentState(OPEN_CONFIRM);
-					}
+					stopRetransmissionTimer();
+					//agree on HoldDown time
+					if(m_Config->getHoldDownTime() > m_BGPIn->m_HoldDownTime)
+						m_Config->setHoldDownTime(m_BGPIn->m_HoldDownTime);
+					m_Config->setASNumber(m_BGPIn->m_AS);
+					setPeerIdentifier(m_BGPIn->m_BGPIdentifier);
+					sendKeepalive();
+					setRetransmissionTimer(m_Config->getHoldDownTime());
+					setBGPCurrentState(OPEN_CONFIRM);
 				}
-				else if(m_ReSend)
-					setBGPCurrentState(ACTIVE);
+			}
+			else if(m_ReSend)
+				setBGPCurrentState(ACTIVE);
 
-				break;
-			case OPEN_CONFIRM:
-				fsmReportRoutineBGP("BGP state: OPEN_CONFIRM");
+			break;
+		case OPEN_CONFIRM:
+			fsmReportRoutineBGP("BGP state: OPEN_CONFIRM");
 
-				if(m_BGPIn.m_OutboundInterface == m_PeeringInterface && m_NewFsmInput)
+			if(m_NewFsmInput && m_BGPIn->m_OutboundInterface == m_PeeringInterface)
+			{
+				if(m_BGPIn->m_Type == KEEPALIVE)
 				{
-					if(m_BGPIn.m_Type == KEEPALIVE)
-					{
-						stopRetransmissionTimer();
-						//cout << name() << " STARTING SESSION" << endl;
-						sessionStart();
-						setBGPCurrentState(ESTABLISHED);
-					}
+					stopRetransmissionTimer();
+					//cout << name() << " STARTING SESSION" << endl;
+					sessionStart();
+					setBGPCurrentState(ESTABLISHED);
 				}
-				else if(m_ReSend)
-					setBGPCurrentState(IDLE);
+			}
+			else if(m_ReSend)
+				setBGPCurrentState(IDLE);
 
-				break;
-			case ESTABLISHED:
-				fsmReportRoutineBGP("BGP state: ESTABLISHED");
+			break;
+		case ESTABLISHED:
+			fsmReportRoutineBGP("BGP state: ESTABLISHED");
 
-				//verify that the peering interface is up
-				if(port_InterfaceControl->isUp())
-				{
+			//verify that the peering interface is up
+			if(port_InterfaceControl->isUp())
+			{
 
-					//verify that the message is for this session and that it is not a duplicate
-					if(m_BGPIn.m_OutboundInterface == m_PeeringInterface && m_NewFsmInput)
+				//verify that the message is for this session and that it is not a duplicate
+				if(m_NewFsmInput && m_BGPIn->m_OutboundInterface == m_PeeringInterface)
+				{
+					//send updates to RT
+					if(m_BGPIn->m_Type == UPDATE)
 					{
-						//send updates to RT
-						if(m_BGPIn.m_Type == UPDATE)
-						{
-//							cout<< endl << name() << " @ " << sc_time_stamp() << m_BGPIn << endl;
-							//reset hold-down timer
-							resetHoldDown();
-							port_ToRoutingTable->write(m_BGPIn);
+//							cout<< endl << name() << " @ " << sc_time_stamp() << *m_BGPIn << endl;
+						//reset hold-down timer
+						resetHoldDown();
+						output(port_ToRoutingTable, m_BGPIn);
 
-						}
-						//transition to IDLE state in case of notification
-						else if(m_BGPIn.m_Type == NOTIFICATION)
-						{
-							setBGPCurrentState(IDLE);
-						}
-						else if(m_BGPIn.m_Type == KEEPALIVE)
-						{
-							//reset hold-down timer
-							resetHoldDown();
-						}
-						//in any other case send a notificaton to the peer and transition to the IDLE state
-						else
-						{
-							m_BGPOut.m_Type = NOTIFICATION;
-							m_BGPOut.m_BGPIdentifier = m_Config->getBGPIdentifier();
-							m_BGPOut.m_AS = m_Config->getASNumber();
-							m_BGPOut.m_OutboundInterface = m_PeeringInterface;
-							port_ToDataPlane->write(m_BGPOut);
-							setBGPCurrentState(IDLE);
-						}
 					}
-
-					if(isKeepaliveTime())
+					//transition to IDLE state in case of notification
+					else if(m_BGPIn->m_Type == NOTIFICATION)
 					{
-						sendKeepalive();
-						resetKeepalive();
+						setBGPCurrentState(IDLE);
 					}
+					else if(m_BGPIn->m_Type == KEEPALIVE)
+					{
+						//reset hold-down timer
+						resetHoldDown();
+					}
+					//in any other case send a notificaton to the peer and transition to the IDLE state
+					else
+					{
+						newOutput(NOTIFICATION);
+						m_BGPOut->m_BGPIdentifier = m_Config->getBGPIdentifier();
+						m_BGPOut->m_AS = m_Config->getASNumber();
+						output(port_ToDataPlane, m_BGPOut);
+						setBGPCurrentState(IDLE);
+					}
+				}
 
-
+				if(isKeepaliveTime())
+				{
+					sendKeepalive();
+					resetKeepalive();
 				}
-				else
-					setBGPCurrentState(IDLE);
 
-				break;
-			default:
-				break;
-		}
+
+			}
+			else
+				setBGPCurrentState(IDLE);
+
+			break;
+		default:
+			break;
 	}
+}
+
+BGPMessage& BGPSession::newOutput(int p_Type)
+{
+	m_BGPOut.reset(new BGPMessage);
+	m_BGPOut->m_Type = p_Type;
+	m_BGPOut->m_OutboundInterface = m_PeeringInterface;
+	return *m_BGPOut;
+}
+
+void BGPSession::output(sc_port<Output_If<BGPMessageHandle> >& p_Port, BGPMessageHandle& p_BGPMsg)
+{
+	if(m_Outbox.empty() && p_Port->nb_write(p_BGPMsg))
+		return;
+	m_Outbox.emplace_back();
+	m_Outbox.back().port = p_Port[0];
+	m_Outbox.back().message = move(p_BGPMsg);
+}
 
+bool BGPSession::flushOutbox(void)
+{
+	while(!m_Outbox.empty())
+	{
+		struct_PendingOutput& l_Output = m_Outbox.front();
+		if(!l_Output.port->nb_write(l_Output.message))
+			return false;
+		m_Outbox.pop_front();
+	}
+	return true;
 }
 
 
 void BGPSession::sessionStop(void)
 {
-    m_BGPHoldDown.cancel();
-    m_BGPKeepalive.cancel();
-    while(m_FsmInputBuffer.num_available() > 0)
-    	m_FsmInputBuffer.read(m_BGPIn);
-    m_BGPIn.clearMessage();
+    port_Timers->stopTimer(m_BGPHoldDown);
+    port_Timers->stopTimer(m_BGPKeepalive);
+    m_FsmInputBuffer.clear();
+    m_BGPIn.reset();
+    m_InputFilter.reset();
+    if(m_SessionValidity)
+        m_ValidityChanged.notify(SC_ZERO_TIME);
     m_SessionValidity = false;
 }
 
@@ -449,7 +456,10 @@ void BGPSession::sessionStart(void)
 {
     resetHoldDown();
     resetKeepalive();
+    m_UpdateSent = false;
     SC_REPORT_INFO(g_ReportID, m_RTool.newReportString("Session started."));
+    if(!m_SessionValidity)
+        m_ValidityChanged.notify(SC_ZERO_TIME);
     m_SessionValidity = true;
 }
 
@@ -458,17 +468,14 @@ void BGPSession::resetKeepalive(void)
 {
     m_KeepaliveMutex.lock();
     SC_REPORT_INFO(g_DebugBSID, m_RTool.newReportString("resetting keepalive timer"));
-    m_BGPKeepalive.cancel();
     setKeepaliveFlag(false);
-    m_BGPKeepalive.notify(m_Config->getKeepaliveTime(), SC_SEC);
+    port_Timers->startTimer(m_BGPKeepalive, m_Config->getKeepaliveTime());
     m_KeepaliveMutex.unlock();
 }
 
 void BGPSession::resetHoldDown(void)
 {
-    m_BGPHoldDown.cancel();
-
-	m_BGPHoldDown.notify(m_Config->getHoldDownTime(), SC_SEC);
+    port_Timers->startTimer(m_BGPHoldDown, m_Config->getHoldDownTime());
     SC_REPORT_INFO(g_DebugBSID, m_RTool.newReportString("resetting hold-down timer"));
 }
 
@@ -494,6 +501,7 @@ void BGPSession::setBGPCurrentState(BGP_States p_State)
 	m_BGPCurrentStateMutex.lock();
 	m_BGPCurrentState = p_State;
 	m_BGPCurrentStateMutex.unlock();
+	m_StateChanged.notify(SC_ZERO_TIME);
 }
 
 void BGPSession::setConnectionCurrentState(TCP_States p_State)
@@ -553,11 +561,64 @@ string BGPSession::getPeerIdentifier(void)
     return m_BGPIdentifierPeer;
 }
 
+bool BGPSession::isMRAIExpired(void)
+{
+    return sc_time_stamp() >= getMRAIExpiry();
+}
+
+sc_time BGPSession::getMRAIExpiry(void)
+{
+    if(!m_UpdateSent)
+        return SC_ZERO_TIME;
+    return m_LastUpdateTime + sc_time(m_Config->getMRAITime(), SC_SEC);
+}
+
+void BGPSession::resetMRAI(void)
+{
+    m_LastUpdateTime = sc_time_stamp();
+    m_UpdateSent = true;
+}
+
+const sc_event& BGPSession::validityChangedEvent(void)
+{
+    return m_ValidityChanged;
+}
+
+void BGPSession::end_of_elaboration()
+{
+    m_WorkEvents |= m_FsmInputBuffer.data_written_event();
+    m_WorkEvents |= m_StateChanged;
+    m_WorkEvents |= m_TimerExpired;
+    m_WorkEvents |= port_InterfaceControl->stateChangedEvent();
+}
+
+void BGPSession::waitForWork(void)
+{
+#ifdef _EVENT_DRIVEN
+    //the FSM runs on both edges of the clock
+    if(m_Outbox.empty() && m_FsmInputBuffer.num_available() == 0 && !(m_BGPCurrentState == CONNECT && m_ConnectionCurrentState == OPEN_SEND))
+    {
+        m_FsmWait = WAIT_EVENTS;
+        next_trigger(m_WorkEvents);
+    }
+    else
+    {
+        m_FsmWait = WAIT_EDGE;
+        next_trigger(timeToNextEdge(CLOCK_PERIOD/2.0));
+    }
+#endif
+}
+
 BGP_States BGPSession::getBGPCurrentState()
 {
 	return m_BGPCurrentState;
 }
 
+DuplicateFilter& BGPSession::getInputFilter(void)
+{
+	return m_InputFilter;
+}
+
 TCP_States BGPSession::getConnectionCurrentState()
 {
 	return m_ConnectionCurrentState;
@@ -570,14 +631,14 @@ int BGPSession::getTCPId()
 
 void BGPSession::setRetransmissionTimer(int p_Delay)
 {
-	m_Retransmission.notify(p_Delay, SC_SEC);
+	port_Timers->startTimer(m_Retransmission, p_Delay);
 	setReSend(false);
 }
 
 void BGPSession::stopRetransmissionTimer(void)
 {
 	m_RetransmissonCount = 0;
-	m_Retransmission.cancel();
+	port_Timers->stopTimer(m_Retransmission);
 }
 void BGPSession::setReSend(bool p_Value)
 {
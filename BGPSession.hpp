@@ -38,8 +38,12 @@
 #include "BGPMessage.hpp"
 #include "Configuration.hpp"
 #include "Output_If.hpp"
+#include "SPSCChannel.hpp"
 #include "StringTools.hpp"
 #include "Interface_If.hpp"
+#include "TimerService_If.hpp"
+#include "DuplicateFilter.hpp"
+#include <deque>
 
 using namespace std;
 using namespace sc_core;
@@ -61,41 +65,62 @@ enum BGP_States{IDLE, CONNECT, ACTIVE, OPEN_SENT, OPEN_CONFIRM, ESTABLISHED};
  */
 enum TCP_States{SYN, ACK, OPEN_SEND};
 
+/*!\enum enum Session_Timers{KEEPALIVE_TIMER, HOLDDOWN_TIMER, RETRANSMISSION_TIMER};
+ * \brief Defines the ids of the session timers
+ */
+enum Session_Timers{KEEPALIVE_TIMER, HOLDDOWN_TIMER, RETRANSMISSION_TIMER};
+
 
 
 
-class BGPSession: public sc_module, public BGPSession_If
+class BGPSession: public sc_module, public BGPSession_If, public TimerClient_If
 {
 
 public:
 
+#ifndef _EVENT_DRIVEN
     /*! \brief System clock signal
      * \details The router's internal clock
      * \public
      */
     sc_in_clk port_Clk;
+#endif
 
     /*! \brief Output port to Data Plane module
      * \details The BGP session writes all the BGP messages to be send
      * to its neighbors into
      * this port. The port shall be bind to the Data Plane's.
-     * receiving FIFO
+     * receiving FIFO. The messages are moved to the port.
      * \public
      */
-    sc_port<Output_If<BGPMessage> > port_ToDataPlane;
+    sc_port<Output_If<BGPMessageHandle> > port_ToDataPlane;
 
     /*! \property sc_port<Output_If> port_ToRoutingTable
      * \brief Output port to Routing Table module
+     * \details The received updates are moved to the routing table
      * \public
      */
-    sc_port<Output_If<BGPMessage> > port_ToRoutingTable;
+    sc_port<Output_If<BGPMessageHandle> > port_ToRoutingTable;
 
     /*! \brief Control port to the session NIC
      * \public
      */
     sc_port<Interface_If> port_InterfaceControl;
 
-    sc_fifo<BGPMessage> m_FsmInputBuffer;
+    /*! \brief Port to the timer service of the router
+     * \details Runs the keepalive, hold-down and retransmission
+     * timers of the session
+     * \public
+     */
+    sc_port<TimerService_If> port_Timers;
+
+    /*! \property SPSCChannel<BGPMessageHandle> m_FsmInputBuffer
+     * \brief The messages of the peer
+     * \details The Control Plane moves the received messages into
+     * this buffer
+     * \public
+     */
+    SPSCChannel<BGPMessageHandle> m_FsmInputBuffer;
 
 
     void before_end_of_elaboration()
@@ -133,30 +158,21 @@ public:
      */
     ~BGPSession();
 
-    /*! \fn void keepaliveTimer(void)
-     *  \brief Send a keepalive message to the peer
-     * \details A SystemC method, which is sensitive to m_BGPKeepalive event
-     * \public
-     */
-    void keepaliveTimer(void);
-
-    /*! \fn void sessionInvalidation(void)
-     *  \brief Invalidates this session
-     * \details A SystemC method, which is sensitive to m_BGPHoldDown event
+    /*! \fn void timerExpired(int p_Timer)
+     *  \brief Handles the expiration of a session timer
+     * \details The keepalive timer marks that a keepalive message is
+     * to be sent, the hold-down timer invalidates the session and the
+     * retransmission timer defines the retransmission period
+     * \sa TimerClient_If
      * \public
      */
-    void sessionInvalidation(void);
-
-    /*! \fn void retransmissionTimer(void)
-     *  \brief Defines the retransmission period
-     * \details The period length is set with m_Retransmission event
-     * \public
-     */
-    void retransmissionTimer(void);
+    virtual void timerExpired(int p_Timer);
 
     /*! \fn void fsmRoutine(void)
      *  \brief Updates the session state
-     * \details
+     * \details A SystemC method, which runs one step of the FSM on
+     * each edge of the clock. In the event-driven build it sets its
+     * own next trigger.
      * \public
      */
     void fsmRoutine(void);
@@ -274,12 +290,37 @@ public:
      * \sa BGPSession_If
      */
     virtual string getPeerIdentifier(void);
+
+    /*!
+     * \sa BGPSession_If
+     */
+    virtual bool isMRAIExpired(void);
+
+    /*!
+     * \sa BGPSession_If
+     */
+    virtual sc_time getMRAIExpiry(void);
+
+    /*!
+     * \sa BGPSession_If
+     */
+    virtual void resetMRAI(void);
+
+    /*!
+     * \sa BGPSession_If
+     */
+    virtual const sc_event& validityChangedEvent(void);
     
     /*! /fn BGP_States getBGPCurrentState(void)
      *  \brief Returns the current session state
      */
     BGP_States getBGPCurrentState(void);
 
+    /*! \fn DuplicateFilter& getInputFilter(void)
+     *  \brief Returns the duplicate filter of the received messages
+     */
+    DuplicateFilter& getInputFilter(void);
+
     /*! /fn TCP_States getConnectionCurrentState(void)
      *  \brief Returns the current connection state
      */
@@ -297,6 +338,11 @@ public:
      */
     SC_HAS_PROCESS(BGPSession);
 
+    /*! \brief Collects the events that wake up the event-driven FSM
+     * \public
+     */
+    void end_of_elaboration();
+
 private:
 
     /*! \property int m_PeerAS 
@@ -314,30 +360,36 @@ private:
      */
     sc_mutex m_KeepaliveMutex;
 
-    /*! \property sc_event m_Retransmission
-     *  \brief Retransmission event
+    /*! \property struct_Timer m_Retransmission
+     *  \brief Retransmission timer
      * \details Used in CONNECT and OPEN_SENT states as a retransmission timer
      * \private
      */
-    sc_event m_Retransmission;
+    struct_Timer m_Retransmission;
 
-    /*! \property sc_event m_BGPKeepalive
+    /*! \property struct_Timer m_BGPKeepalive
      *  \brief BGP session keepalive timer
      * \details There is one instance for each session. The keepalive
      * timer defines when the next keepalice message is to be sent to
      * the corresponding session.
      * \private
      */
-    sc_event m_BGPKeepalive;
+    struct_Timer m_BGPKeepalive;
 
-    /*! \property sc_event m_BGPHoldDown
+    /*! \property struct_Timer m_BGPHoldDown
      *  \brief BGP session hold down timer
-     * \details There is one instance of sc_event for each session. If
+     * \details There is one instance for each session. If
      * hold down timer expires the link of the corresponding session
      * shall be concidered to be down and the required action need to be taken.
      * \private
      */
-    sc_event m_BGPHoldDown;
+    struct_Timer m_BGPHoldDown;
+
+    /*! \property sc_event m_TimerExpired
+     *  \brief Notified when a timer of the session expires
+     * \private
+     */
+    sc_event m_TimerExpired;
 
     /*! \property int m_PeeringInterface
      *  \brief Interface of the Session Peer
@@ -356,33 +408,41 @@ private:
      */
     bool m_SessionValidity;
 
-    /*! \property BGPMessage m_KeepaliveMsg
-     *  \brief BGP message object
-     * \details This holds the keepalive messages
+    /*! \property sc_event m_ValidityChanged
+     *  \brief Notified when m_SessionValidity changes
      * \private
      */
-    BGPMessage m_KeepaliveMsg;
+    sc_event m_ValidityChanged;
 
-    /*! \property BGPMessage m_BGPIn
-     *  \brief BGP message object
-     * \details The input for fsmRoutine
+    /*! \property sc_event m_StateChanged
+     *  \brief Notified when the BGP state changes
+     * \private
+     */
+    sc_event m_StateChanged;
+
+    /*! \property sc_event_or_list m_WorkEvents
+     *  \brief Any of these wakes up the FSM in the event-driven build
+     * \details The input buffer, the timers, the state changes and the
+     * peering interface
      * \private
      */
-    BGPMessage m_BGPIn;
+    sc_event_or_list m_WorkEvents;
 
-    /*! \property BGPMessage m_BGPInPrevious
+    /*! \property BGPMessageHandle m_BGPIn
      *  \brief BGP message object
-     * \details The input for fsmRoutine
+     * \details The input for fsmRoutine. Empty after an update has
+     * been moved to the routing table.
      * \private
      */
-    BGPMessage m_BGPInPrevious;
+    BGPMessageHandle m_BGPIn;
 
-    /*! \property BGPMessage m_BGPOut
+    /*! \property BGPMessageHandle m_BGPOut
      *  \brief BGP message object
-     * \details The output of fsmRoutine
+     * \details The output of fsmRoutine. Built by newOutput and empty
+     * after it has been moved to the port.
      * \private
      */
-    BGPMessage m_BGPOut;
+    BGPMessageHandle m_BGPOut;
 
     /*! \property string m_BGPIdentifierPeer
      *  \brief The BGP identifier of the session peer
@@ -398,6 +458,21 @@ private:
      */
     BGPSessionParameters *m_Config;
 
+    /*! \property sc_time m_LastUpdateTime
+     *  \brief The time of the previous UPDATE message sent to the peer
+     * \details The MinRouteAdvertisementInterval is counted from this
+     * \private
+     */
+    sc_time m_LastUpdateTime;
+
+    /*! \property bool m_UpdateSent
+     *  \brief Indicates whether an UPDATE message has been sent in this session
+     * \details Is set to False when the session starts, so that the
+     * initial routing table is not delayed
+     * \private
+     */
+    bool m_UpdateSent;
+
     /*! \property StringTools m_RTool
      *  \brief Used in reporting debug messages
      * \details 
@@ -422,6 +497,37 @@ private:
 
    bool m_NewFsmInput;
 
+    /*! \property DuplicateFilter m_InputFilter
+     *  \brief Detects the duplicates among the inputs by their
+     *  message ids
+     * \private
+     */
+    DuplicateFilter m_InputFilter;
+
+    /*!\enum enum FSM_Wait{WAIT_START, WAIT_EVENTS, WAIT_EDGE};
+     * \brief What the event-driven FSM is waiting for
+     */
+    enum FSM_Wait{WAIT_START, WAIT_EVENTS, WAIT_EDGE};
+
+    FSM_Wait m_FsmWait;
+
+    /*!
+     * \brief A message waiting to be written to a port
+     */
+    struct struct_PendingOutput
+    {
+        Output_If<BGPMessageHandle> *port;
+        BGPMessageHandle message;
+    };
+
+    /*! \property deque<struct_PendingOutput> m_Outbox
+     *  \brief The messages that could not be written without waiting
+     * \details The FSM does not step until they are written, as a
+     * thread blocked in the write would not
+     * \private
+     */
+    deque<struct_PendingOutput> m_Outbox;
+
 
 
     /***************************Private functions*****************/
@@ -434,6 +540,43 @@ private:
     void setKeepaliveFlag(bool p_Value);
     bool isKeepaliveTime(void);
     void sendKeepalive(void);
+
+    /*! \fn void fsmStep(void)
+     *  \brief Reads the next input and runs the FSM once
+     * \private
+     */
+    void fsmStep(void);
+
+    /*! \fn BGPMessage& newOutput(int p_Type)
+     *  \brief Builds a new message of p_Type to the peer in m_BGPOut
+     * \return BGPMessage&: the message, whose other fields are set by
+     * the caller
+     * \private
+     */
+    BGPMessage& newOutput(int p_Type);
+
+    /*! \fn void output(sc_port<Output_If<BGPMessageHandle> >& p_Port, BGPMessageHandle& p_BGPMsg)
+     *  \brief Moves the message to the port or, if it cannot be
+     *  written now, to m_Outbox
+     * \private
+     */
+    void output(sc_port<Output_If<BGPMessageHandle> >& p_Port, BGPMessageHandle& p_BGPMsg);
+
+    /*! \fn bool flushOutbox(void)
+     *  \brief Writes the messages of m_Outbox in their order
+     * \return bool: true if m_Outbox was emptied
+     * \private
+     */
+    bool flushOutbox(void);
+
+    /*! \fn void waitForWork(void)
+     *  \brief Sets the next trigger of the event-driven FSM
+     * \details The FSM sleeps until it has an input, a timer expires
+     * or a state changes, and then steps at the next clock edge.
+     * OPEN_SEND is the only state that moves on without any of them.
+     * \private
+     */
+    void waitForWork(void);
 };
 
 
@@ -72,6 +72,41 @@ public:
      * \public
      */
     virtual string getPeerIdentifier(void) = 0;
+
+    /*! \fn virtual bool isMRAIExpired(void) = 0
+     * \brief Checks whether an UPDATE message may be sent to the peer
+     * \details True if the MinRouteAdvertisementInterval has passed
+     * since the previous UPDATE message or if none has been sent in
+     * this session
+     * \return bool:
+     * \public
+     */
+    virtual bool isMRAIExpired(void) = 0;
+
+    /*! \fn virtual sc_time getMRAIExpiry(void) = 0
+     * \brief Returns the time when the MinRouteAdvertisementInterval
+     * expires
+     * \details SC_ZERO_TIME if no UPDATE message has been sent in this
+     * session
+     * \return sc_time:
+     * \public
+     */
+    virtual sc_time getMRAIExpiry(void) = 0;
+
+    /*! \fn virtual void resetMRAI(void) = 0
+     * \brief Restarts the MinRouteAdvertisementInterval
+     * \details Shall be called whenever an UPDATE message is sent to
+     * the peer
+     * \public
+     */
+    virtual void resetMRAI(void) = 0;
+
+    /*! \fn virtual const sc_event& validityChangedEvent(void) = 0
+     * \brief Returns the event notified when the session becomes valid
+     * or invalid
+     * \public
+     */
+    virtual const sc_event& validityChangedEvent(void) = 0;
     
 
 };
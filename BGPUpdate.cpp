@@ -0,0 +1,349 @@
+/*! \file BGPUpdate.cpp
+ *  \brief     Implementation of BGPUpdate class.
+ *  \details
+ */
+
+
+#include "BGPUpdate.hpp"
+#include "BGPMessage.hpp"
+#include <cstring>
+#include <sstream>
+
+
+BGPUpdate::BGPUpdate(void):m_Origin(ORIGIN_IGP), m_NextHop(0)
+{
+}
+
+/*! \sa BGPUpdate
+ */
+void BGPUpdate::clear(void)
+{
+    m_WithdrawnRoutes.clear();
+    m_Origin = ORIGIN_IGP;
+    m_ASPath.clear();
+    m_NextHop = 0;
+    m_NLRI.clear();
+}
+
+/*! \sa BGPUpdate
+ */
+bool BGPUpdate::isEmpty(void) const
+{
+    return m_WithdrawnRoutes.empty() && m_NLRI.empty();
+}
+
+/*! \sa BGPUpdate
+ */
+void BGPUpdate::addWithdrawnRoute(unsigned p_Prefix, int p_Length)
+{
+    struct_Prefix l_Prefix = {p_Prefix, p_Length};
+    m_WithdrawnRoutes.push_back(l_Prefix);
+}
+
+/*! \sa BGPUpdate
+ */
+void BGPUpdate::addNLRI(unsigned p_Prefix, int p_Length)
+{
+    struct_Prefix l_Prefix = {p_Prefix, p_Length};
+    m_NLRI.push_back(l_Prefix);
+}
+
+/*! \sa BGPUpdate
+ */
+int BGPUpdate::getEncodedLength(void) const
+{
+    //header, withdrawn routes length, total path attribute length
+    return BGP_HEADER_LENGTH + 2 + getPrefixesLength(m_WithdrawnRoutes) + 2 + getPathAttributesLength() + getPrefixesLength(m_NLRI);
+}
+
+/*! \sa BGPUpdate
+ */
+int BGPUpdate::encode(unsigned char *p_Buffer, int p_Size) const
+{
+    int l_Length = getEncodedLength();
+    if(l_Length > p_Size || l_Length > BGP_MAX_MESSAGE_LENGTH)
+        return 0;
+
+    unsigned char *ptr_Buffer = p_Buffer;
+
+    //message header
+    memset(ptr_Buffer, 0xFF, BGP_MARKER_LENGTH);
+    ptr_Buffer += BGP_MARKER_LENGTH;
+    ptr_Buffer = writeShort(ptr_Buffer, l_Length);
+    *ptr_Buffer++ = UPDATE;
+
+    //withdrawn routes
+    ptr_Buffer = writeShort(ptr_Buffer, getPrefixesLength(m_WithdrawnRoutes));
+    ptr_Buffer = writePrefixes(ptr_Buffer, m_WithdrawnRoutes);
+
+    //path attributes are present only if there is NLRI
+    ptr_Buffer = writeShort(ptr_Buffer, getPathAttributesLength());
+    if(!m_NLRI.empty())
+    {
+        ptr_Buffer = writeAttributeHeader(ptr_Buffer, ATTR_ORIGIN, 1);
+        *ptr_Buffer++ = m_Origin;
+
+        ptr_Buffer = writeAttributeHeader(ptr_Buffer, ATTR_AS_PATH, getASPathLength());
+        for (unsigned i = 0; i < m_ASPath.size(); i += AS_SEGMENT_MAX)
+        {
+            unsigned l_Count = m_ASPath.size() - i < AS_SEGMENT_MAX ? m_ASPath.size() - i : AS_SEGMENT_MAX;
+            *ptr_Buffer++ = AS_SEQUENCE;
+            *ptr_Buffer++ = (unsigned char)l_Count;
+            for (unsigned j = i; j < i + l_Count; j++)
+                ptr_Buffer = writeLong(ptr_Buffer, m_ASPath[j]);
+        }
+
+        ptr_Buffer = writeAttributeHeader(ptr_Buffer, ATTR_NEXT_HOP, 4);
+        ptr_Buffer = writeLong(ptr_Buffer, m_NextHop);
+    }
+
+    //NLRI
+    ptr_Buffer = writePrefixes(ptr_Buffer, m_NLRI);
+
+    return l_Length;
+}
+
+/*! \sa BGPUpdate
+ */
+bool BGPUpdate::decode(const unsigned char *p_Buffer, int p_Size)
+{
+    clear();
+
+    if(p_Size < BGP_HEADER_LENGTH + 4)
+        return false;
+
+    //message header
+    for (int i = 0; i < BGP_MARKER_LENGTH; i++)
+    {
+        if(p_Buffer[i] != 0xFF)
+            return false;
+    }
+    int l_Length = readShort(p_Buffer + BGP_MARKER_LENGTH);
+    if(l_Length < BGP_HEADER_LENGTH + 4 || l_Length > p_Size || p_Buffer[BGP_MARKER_LENGTH + 2] != UPDATE)
+        return false;
+
+    const unsigned char *ptr_Buffer = p_Buffer + BGP_HEADER_LENGTH;
+    const unsigned char *ptr_End = p_Buffer + l_Length;
+
+    //withdrawn routes
+    int l_WithdrawnLength = readShort(ptr_Buffer);
+    ptr_Buffer += 2;
+    if(ptr_Buffer + l_WithdrawnLength + 2 > ptr_End || !readPrefixes(ptr_Buffer, l_WithdrawnLength, m_WithdrawnRoutes))
+        return false;
+    ptr_Buffer += l_WithdrawnLength;
+
+    //path attributes
+    int l_AttributesLength = readShort(ptr_Buffer);
+    ptr_Buffer += 2;
+    if(ptr_Buffer + l_AttributesLength > ptr_End || !readPathAttributes(ptr_Buffer, l_AttributesLength))
+        return false;
+    ptr_Buffer += l_AttributesLength;
+
+    //NLRI takes the rest of the message
+    return readPrefixes(ptr_Buffer, ptr_End - ptr_Buffer, m_NLRI);
+}
+
+/*! \sa BGPUpdate
+ */
+bool BGPUpdate::operator == (const BGPUpdate& p_Update) const
+{
+    if(m_WithdrawnRoutes.size() != p_Update.m_WithdrawnRoutes.size() || m_NLRI.size() != p_Update.m_NLRI.size())
+        return false;
+
+    for (unsigned i = 0; i < m_WithdrawnRoutes.size(); i++)
+    {
+        if(m_WithdrawnRoutes[i].prefix != p_Update.m_WithdrawnRoutes[i].prefix || m_WithdrawnRoutes[i].length != p_Update.m_WithdrawnRoutes[i].length)
+            return false;
+    }
+    for (unsigned i = 0; i < m_NLRI.size(); i++)
+    {
+        if(m_NLRI[i].prefix != p_Update.m_NLRI[i].prefix || m_NLRI[i].length != p_Update.m_NLRI[i].length)
+            return false;
+    }
+    return m_Origin == p_Update.m_Origin && m_ASPath == p_Update.m_ASPath && m_NextHop == p_Update.m_NextHop;
+}
+
+/*! \sa BGPUpdate
+ */
+string BGPUpdate::toString(void) const
+{
+    ostringstream l_Out;
+    l_Out << "W:";
+    for (unsigned i = 0; i < m_WithdrawnRoutes.size(); i++)
+        l_Out << (i ? "," : "") << (m_WithdrawnRoutes[i].prefix >> 24) << "." << ((m_WithdrawnRoutes[i].prefix >> 16) & 0xFF) << "." << ((m_WithdrawnRoutes[i].prefix >> 8) & 0xFF) << "." << (m_WithdrawnRoutes[i].prefix & 0xFF) << "/" << m_WithdrawnRoutes[i].length;
+    l_Out << ";P:";
+    for (unsigned i = 0; i < m_ASPath.size(); i++)
+        l_Out << (i ? "-" : "") << m_ASPath[i];
+    l_Out << ";N:";
+    for (unsigned i = 0; i < m_NLRI.size(); i++)
+        l_Out << (i ? "," : "") << (m_NLRI[i].prefix >> 24) << "." << ((m_NLRI[i].prefix >> 16) & 0xFF) << "." << ((m_NLRI[i].prefix >> 8) & 0xFF) << "." << (m_NLRI[i].prefix & 0xFF) << "/" << m_NLRI[i].length;
+    return l_Out.str();
+}
+
+/*! \sa BGPUpdate
+ */
+int BGPUpdate::getPathAttributesLength(void) const
+{
+    if(m_NLRI.empty())
+        return 0;
+
+    int l_ASPathLength = getASPathLength();
+    //ORIGIN, AS_PATH with an extended length if needed, NEXT_HOP
+    return (3 + 1) + (l_ASPathLength > 255 ? 4 : 3) + l_ASPathLength + (3 + 4);
+}
+
+/*! \sa BGPUpdate
+ */
+int BGPUpdate::getASPathLength(void) const
+{
+    int l_Segments = (m_ASPath.size() + AS_SEGMENT_MAX - 1) / AS_SEGMENT_MAX;
+    return l_Segments * 2 + m_ASPath.size() * 4;
+}
+
+/*! \sa BGPUpdate
+ */
+int BGPUpdate::getPrefixesLength(const vector<struct_Prefix>& p_Prefixes)
+{
+    int l_Length = 0;
+    for (unsigned i = 0; i < p_Prefixes.size(); i++)
+        l_Length += 1 + (p_Prefixes[i].length + 7) / 8;
+    return l_Length;
+}
+
+unsigned char *BGPUpdate::writeShort(unsigned char *ptr_Buffer, unsigned short p_Value)
+{
+    *ptr_Buffer++ = p_Value >> 8;
+    *ptr_Buffer++ = p_Value & 0xFF;
+    return ptr_Buffer;
+}
+
+unsigned char *BGPUpdate::writeLong(unsigned char *ptr_Buffer, unsigned p_Value)
+{
+    *ptr_Buffer++ = p_Value >> 24;
+    *ptr_Buffer++ = (p_Value >> 16) & 0xFF;
+    *ptr_Buffer++ = (p_Value >> 8) & 0xFF;
+    *ptr_Buffer++ = p_Value & 0xFF;
+    return ptr_Buffer;
+}
+
+unsigned char *BGPUpdate::writePrefixes(unsigned char *ptr_Buffer, const vector<struct_Prefix>& p_Prefixes)
+{
+    for (unsigned i = 0; i < p_Prefixes.size(); i++)
+    {
+        *ptr_Buffer++ = (unsigned char)p_Prefixes[i].length;
+        //only the significant octets of the prefix are written
+        for (int j = 0; j < (p_Prefixes[i].length + 7) / 8; j++)
+            *ptr_Buffer++ = (p_Prefixes[i].prefix >> (24 - 8*j)) & 0xFF;
+    }
+    return ptr_Buffer;
+}
+
+unsigned char *BGPUpdate::writeAttributeHeader(unsigned char *ptr_Buffer, unsigned char p_Type, int p_Length)
+{
+    if(p_Length > 255)
+    {
+        *ptr_Buffer++ = ATTR_FLAG_TRANSITIVE | ATTR_FLAG_EXTENDED_LENGTH;
+        *ptr_Buffer++ = p_Type;
+        return writeShort(ptr_Buffer, p_Length);
+    }
+    *ptr_Buffer++ = ATTR_FLAG_TRANSITIVE;
+    *ptr_Buffer++ = p_Type;
+    *ptr_Buffer++ = (unsigned char)p_Length;
+    return ptr_Buffer;
+}
+
+unsigned short BGPUpdate::readShort(const unsigned char *ptr_Buffer)
+{
+    return (ptr_Buffer[0] << 8) | ptr_Buffer[1];
+}
+
+unsigned BGPUpdate::readLong(const unsigned char *ptr_Buffer)
+{
+    return ((unsigned)ptr_Buffer[0] << 24) | (ptr_Buffer[1] << 16) | (ptr_Buffer[2] << 8) | ptr_Buffer[3];
+}
+
+/*! \sa BGPUpdate
+ */
+bool BGPUpdate::readPrefixes(const unsigned char *ptr_Buffer, int p_Length, vector<struct_Prefix>& p_Prefixes)
+{
+    const unsigned char *ptr_End = ptr_Buffer + p_Length;
+    while(ptr_Buffer < ptr_End)
+    {
+        struct_Prefix l_Prefix;
+        l_Prefix.length = *ptr_Buffer++;
+        int l_Octets = (l_Prefix.length + 7) / 8;
+        if(l_Prefix.length > 32 || ptr_Buffer + l_Octets > ptr_End)
+            return false;
+
+        l_Prefix.prefix = 0;
+        for (int j = 0; j < l_Octets; j++)
+            l_Prefix.prefix |= (unsigned)*ptr_Buffer++ << (24 - 8*j);
+        p_Prefixes.push_back(l_Prefix);
+    }
+    return true;
+}
+
+/*! \sa BGPUpdate
+ */
+bool BGPUpdate::readPathAttributes(const unsigned char *ptr_Buffer, int p_Length)
+{
+    const unsigned char *ptr_End = ptr_Buffer + p_Length;
+    while(ptr_Buffer < ptr_End)
+    {
+        if(ptr_Buffer + 3 > ptr_End)
+            return false;
+
+        unsigned char l_Flags = *ptr_Buffer++;
+        unsigned char l_Type = *ptr_Buffer++;
+        int l_Length;
+        if(l_Flags & ATTR_FLAG_EXTENDED_LENGTH)
+        {
+            if(ptr_Buffer + 2 > ptr_End)
+                return false;
+            l_Length = readShort(ptr_Buffer);
+            ptr_Buffer += 2;
+        }
+        else
+            l_Length = *ptr_Buffer++;
+
+        if(ptr_Buffer + l_Length > ptr_End)
+            return false;
+
+        const unsigned char *ptr_Value = ptr_Buffer;
+        ptr_Buffer += l_Length;
+
+        switch(l_Type)
+        {
+        case ATTR_ORIGIN:
+            if(l_Length != 1)
+                return false;
+            m_Origin = *ptr_Value;
+            break;
+
+        case ATTR_AS_PATH:
+            while(ptr_Value < ptr_Buffer)
+            {
+                if(ptr_Value + 2 > ptr_Buffer)
+                    return false;
+                int l_Count = ptr_Value[1];
+                ptr_Value += 2;
+                if(ptr_Value + l_Count*4 > ptr_Buffer)
+                    return false;
+                for (int j = 0; j < l_Count; j++, ptr_Value += 4)
+                    m_ASPath.push_back(readLong(ptr_Value));
+            }
+            break;
+
+        case ATTR_NEXT_HOP:
+            if(l_Length != 4)
+                return false;
+            m_NextHop = readLong(ptr_Value);
+            break;
+
+        default:
+            //unknown attributes are skipped
+            break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,233 @@
+/*! \file  BGPUpdate.hpp
+ *  \brief     Header file of BGPUpdate class
+ *  \details   Defines the binary representation of the BGP UPDATE
+ *  message.
+ */
+
+/*!
+ * \class BGPUpdate
+ * \brief BGP UPDATE message
+ *  \details Holds the withdrawn routes, the path attributes and the
+ *  NLRI of an UPDATE message. encode and decode convert the message
+ *  to and from the RFC 4271 wire format: the 19 byte message header,
+ *  the withdrawn routes, the path attributes and the NLRI. Prefixes
+ *  are packed into a length octet followed by the significant octets
+ *  of the prefix. AS numbers are encoded as four octets (RFC 6793).
+ */
+
+
+#include <vector>
+#include <string>
+
+using namespace std;
+
+
+#ifndef _BGPUPDATE_H_
+#define _BGPUPDATE_H_
+
+/*!
+ *The length of the marker field of the message header
+ */
+#define BGP_MARKER_LENGTH 16
+
+/*!
+ *The length of the message header
+ */
+#define BGP_HEADER_LENGTH 19
+
+/*!
+ *The maximum length of a BGP message
+ */
+#define BGP_MAX_MESSAGE_LENGTH 4096
+
+/*!
+ *Path attribute flags
+ */
+#define ATTR_FLAG_TRANSITIVE 0x40
+#define ATTR_FLAG_EXTENDED_LENGTH 0x10
+
+/*!
+ *Path attribute type codes
+ */
+#define ATTR_ORIGIN 1
+#define ATTR_AS_PATH 2
+#define ATTR_NEXT_HOP 3
+
+/*!
+ *AS_PATH segment types
+ */
+#define AS_SET 1
+#define AS_SEQUENCE 2
+
+/*!
+ *ORIGIN values
+ */
+#define ORIGIN_IGP 0
+#define ORIGIN_EGP 1
+#define ORIGIN_INCOMPLETE 2
+
+/*!
+ *The maximum number of AS numbers in one AS_PATH segment
+ */
+#define AS_SEGMENT_MAX 255
+
+
+/*! \brief A prefix in the withdrawn routes or in the NLRI
+ * \details The prefix is in host byte order
+ */
+struct struct_Prefix
+{
+    unsigned prefix;
+    int length;
+};
+
+
+class BGPUpdate
+{
+
+public:
+
+    /*! \property vector<struct_Prefix> m_WithdrawnRoutes
+     * \brief The prefixes withdrawn by this message
+     * \public
+     */
+    vector<struct_Prefix> m_WithdrawnRoutes;
+
+    /*! \property unsigned char m_Origin
+     * \brief The ORIGIN path attribute
+     * \public
+     */
+    unsigned char m_Origin;
+
+    /*! \property vector<unsigned> m_ASPath
+     * \brief The AS_PATH path attribute as an AS_SEQUENCE
+     * \details The first AS is the one closest to the receiver
+     * \public
+     */
+    vector<unsigned> m_ASPath;
+
+    /*! \property unsigned m_NextHop
+     * \brief The NEXT_HOP path attribute in host byte order
+     * \public
+     */
+    unsigned m_NextHop;
+
+    /*! \property vector<struct_Prefix> m_NLRI
+     * \brief The prefixes advertised with the path attributes
+     * \public
+     */
+    vector<struct_Prefix> m_NLRI;
+
+    BGPUpdate(void);
+
+    /*! \fn void clear(void)
+     * \brief Removes all the prefixes and resets the path attributes
+     * \public
+     */
+    void clear(void);
+
+    /*! \fn bool isEmpty(void) const
+     * \brief Returns true if the message withdraws and advertises nothing
+     * \public
+     */
+    bool isEmpty(void) const;
+
+    /*! \fn void addWithdrawnRoute(unsigned p_Prefix, int p_Length)
+     * \brief Appends a prefix to the withdrawn routes
+     * \public
+     */
+    void addWithdrawnRoute(unsigned p_Prefix, int p_Length);
+
+    /*! \fn void addNLRI(unsigned p_Prefix, int p_Length)
+     * \brief Appends a prefix to the NLRI
+     * \public
+     */
+    void addNLRI(unsigned p_Prefix, int p_Length);
+
+    /*! \fn int getEncodedLength(void) const
+     * \brief Returns the length of the encoded message in octets
+     * \details The message header is included
+     * \public
+     */
+    int getEncodedLength(void) const;
+
+    /*! \fn int encode(unsigned char *p_Buffer, int p_Size) const
+     * \brief Writes the message in the wire format into p_Buffer
+     * @param [out] unsigned char *p_Buffer The target buffer
+     * @param [in] int p_Size The size of the target buffer
+     * \return int: the number of octets written or 0 if the message
+     * does not fit into the buffer
+     * \public
+     */
+    int encode(unsigned char *p_Buffer, int p_Size) const;
+
+    /*! \fn bool decode(const unsigned char *p_Buffer, int p_Size)
+     * \brief Reads the message from the wire format
+     * \details Unknown path attributes are skipped. AS_SET segments are
+     * appended to m_ASPath.
+     * @param [in] const unsigned char *p_Buffer The encoded message
+     * @param [in] int p_Size The number of octets available in p_Buffer
+     * \return bool true: message was decoded - false: message is malformed
+     * \public
+     */
+    bool decode(const unsigned char *p_Buffer, int p_Size);
+
+    /*!
+     * \brief Overload of compare operator
+     * \details Compares the prefixes and the path attributes
+     * \public
+     */
+    bool operator == (const BGPUpdate& p_Update) const;
+
+    /*! \fn string toString(void) const
+     * \brief Returns the message in a readable form
+     * \details Syntax: W:prefix/len,...;P:AS-AS-...;N:prefix/len,...
+     * \public
+     */
+    string toString(void) const;
+
+private:
+
+    /*! \fn int getPathAttributesLength(void) const
+     * \brief Returns the length of the encoded path attributes
+     * \private
+     */
+    int getPathAttributesLength(void) const;
+
+    /*! \fn int getASPathLength(void) const
+     * \brief Returns the length of the encoded AS_PATH value
+     * \private
+     */
+    int getASPathLength(void) const;
+
+    static int getPrefixesLength(const vector<struct_Prefix>& p_Prefixes);
+
+    static unsigned char *writeShort(unsigned char *ptr_Buffer, unsigned short p_Value);
+
+    static unsigned char *writeLong(unsigned char *ptr_Buffer, unsigned p_Value);
+
+    static unsigned char *writePrefixes(unsigned char *ptr_Buffer, const vector<struct_Prefix>& p_Prefixes);
+
+    static unsigned char *writeAttributeHeader(unsigned char *ptr_Buffer, unsigned char p_Type, int p_Length);
+
+    static unsigned short readShort(const unsigned char *ptr_Buffer);
+
+    static unsigned readLong(const unsigned char *ptr_Buffer);
+
+    /*! \fn static bool readPrefixes(const unsigned char *ptr_Buffer, int p_Length, vector<struct_Prefix>& p_Prefixes)
+     * \brief Unpacks p_Length octets of prefixes into p_Prefixes
+     * \return bool true: prefixes were read - false: the field is malformed
+     * \private
+     */
+    static bool readPrefixes(const unsigned char *ptr_Buffer, int p_Length, vector<struct_Prefix>& p_Prefixes);
+
+    /*! \fn bool readPathAttributes(const unsigned char *ptr_Buffer, int p_Length)
+     * \brief Reads p_Length octets of path attributes
+     * \return bool true: attributes were read - false: the field is malformed
+     * \private
+     */
+    bool readPathAttributes(const unsigned char *ptr_Buffer, int p_Length);
+};
+
+
+#endif /* _BGPUPDATE_H_ */
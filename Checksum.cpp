@@ -0,0 +1,347 @@
+/*! \file Checksum.cpp
+ *  \brief     Implementation of Checksum class.
+ *  \details
+ */
+
+
+#include "Checksum.hpp"
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CHECKSUM_X86
+#include <immintrin.h>
+#endif
+
+
+/*!
+ * \brief Folds the carries of the sum back into 16 bits
+ */
+static unsigned short fold(uint64_t p_Sum)
+{
+    p_Sum = (p_Sum & 0xFFFFFFFF) + (p_Sum >> 32);
+    p_Sum = (p_Sum & 0xFFFF) + (p_Sum >> 16);
+    p_Sum = (p_Sum & 0xFFFF) + (p_Sum >> 16);
+    p_Sum = (p_Sum & 0xFFFF) + (p_Sum >> 16);
+    return (unsigned short)p_Sum;
+}
+
+/*!
+ * \brief Sums the 16 bit words of the data in the host byte order
+ * \details An odd last octet is padded with zero as RFC 1071 defines
+ */
+static uint64_t sumScalar(const unsigned char *p_Data, unsigned p_Length)
+{
+    uint64_t l_Sum = 0;
+    uint16_t l_Word;
+    unsigned i = 0;
+
+    for (; i + 1 < p_Length; i += 2)
+        {
+            memcpy(&l_Word, &p_Data[i], sizeof(l_Word));
+            l_Sum += l_Word;
+        }
+
+    if(i < p_Length)
+        {
+            unsigned char l_Last[2] = {p_Data[i], 0};
+            memcpy(&l_Word, l_Last, sizeof(l_Word));
+            l_Sum += l_Word;
+        }
+    return l_Sum;
+}
+
+#ifdef CHECKSUM_X86
+
+/*!
+ * \brief Sums 16 octets at a time
+ * \details The words are widened into four 32 bit lanes. A lane gains
+ * at most 2*0xFFFF per round, so it cannot overflow within 64 KiB.
+ */
+__attribute__((target("sse2")))
+static uint64_t sumSSE2(const unsigned char *p_Data, unsigned p_Length)
+{
+    __m128i l_Zero = _mm_setzero_si128();
+    __m128i l_Lanes = l_Zero;
+    unsigned i = 0;
+
+    for (; i + 16 <= p_Length; i += 16)
+        {
+            __m128i l_Words = _mm_loadu_si128((const __m128i *)&p_Data[i]);
+            l_Lanes = _mm_add_epi32(l_Lanes, _mm_unpacklo_epi16(l_Words, l_Zero));
+            l_Lanes = _mm_add_epi32(l_Lanes, _mm_unpackhi_epi16(l_Words, l_Zero));
+        }
+
+    uint32_t l_Sums[4];
+    _mm_storeu_si128((__m128i *)l_Sums, l_Lanes);
+    return (uint64_t)l_Sums[0] + l_Sums[1] + l_Sums[2] + l_Sums[3] + sumScalar(&p_Data[i], p_Length - i);
+}
+
+/*!
+ * \brief Sums 32 octets at a time
+ * \details The remainder is summed by the SSE2 kernel
+ */
+__attribute__((target("avx2")))
+static uint64_t sumAVX2(const unsigned char *p_Data, unsigned p_Length)
+{
+    __m256i l_Zero = _mm256_setzero_si256();
+    __m256i l_Lanes = l_Zero;
+    unsigned i = 0;
+
+    for (; i + 32 <= p_Length; i += 32)
+        {
+            __m256i l_Words = _mm256_loadu_si256((const __m256i *)&p_Data[i]);
+            l_Lanes = _mm256_add_epi32(l_Lanes, _mm256_unpacklo_epi16(l_Words, l_Zero));
+            l_Lanes = _mm256_add_epi32(l_Lanes, _mm256_unpackhi_epi16(l_Words, l_Zero));
+        }
+
+    uint32_t l_Sums[8];
+    _mm256_storeu_si256((__m256i *)l_Sums, l_Lanes);
+    uint64_t l_Sum = 0;
+    for (int j = 0; j < 8; j++)
+        l_Sum += l_Sums[j];
+    //the SSE2 kernel is not VEX encoded, so the upper halves of the
+    //registers are cleared to avoid the transition penalty
+    _mm256_zeroupper();
+    return l_Sum + sumSSE2(&p_Data[i], p_Length - i);
+}
+
+/*!
+ * \brief Returns the 16 bit words of a 20 octet header widened to 32 bits
+ * \details The first 16 octets give eight words, which are added
+ * pairwise into four lanes. The last four octets give two words.
+ */
+__attribute__((target("sse2")))
+static inline __m128i widenHeaderSSE2(const unsigned char *p_Header)
+{
+    __m128i l_Zero = _mm_setzero_si128();
+    __m128i l_Words = _mm_loadu_si128((const __m128i *)p_Header);
+    int32_t l_TailOctets;
+    memcpy(&l_TailOctets, &p_Header[16], sizeof(l_TailOctets));
+    __m128i l_Tail = _mm_cvtsi32_si128(l_TailOctets);
+
+    __m128i l_Lanes = _mm_add_epi32(_mm_unpacklo_epi16(l_Words, l_Zero), _mm_unpackhi_epi16(l_Words, l_Zero));
+    return _mm_add_epi32(l_Lanes, _mm_unpacklo_epi16(l_Tail, l_Zero));
+}
+
+/*!
+ * \brief Folds the 32 bit lane sums into 16 bits and compares them to
+ * all ones
+ * \details A lane holds the sum of at most ten words, which is below
+ * 2^20, so two folds are enough
+ */
+__attribute__((target("sse2")))
+static inline __m128i foldAndCompareSSE2(__m128i p_Sums)
+{
+    __m128i l_Mask = _mm_set1_epi32(0xFFFF);
+    p_Sums = _mm_add_epi32(_mm_and_si128(p_Sums, l_Mask), _mm_srli_epi32(p_Sums, 16));
+    p_Sums = _mm_add_epi32(_mm_and_si128(p_Sums, l_Mask), _mm_srli_epi32(p_Sums, 16));
+    return _mm_cmpeq_epi32(p_Sums, l_Mask);
+}
+
+/*!
+ * \brief Verifies four 20 octet headers at a time
+ * \details The four lanes of the four headers are transposed so that
+ * lane i of the sum holds header i, and the four sums are folded and
+ * compared at once. Headers of other lengths are verified one at a
+ * time.
+ */
+__attribute__((target("sse2")))
+static int verifyBatchSSE2(const unsigned char * const *p_Headers, const unsigned *p_Lengths, int p_Count, bool *p_Valid)
+{
+    int l_ValidCount = 0;
+    int i = 0;
+
+    for (; i + 4 <= p_Count; i += 4)
+        {
+            if(p_Lengths[i] != 20 || p_Lengths[i+1] != 20 || p_Lengths[i+2] != 20 || p_Lengths[i+3] != 20)
+                {
+                    for (int j = i; j < i + 4; j++)
+                        {
+                            p_Valid[j] = fold(sumSSE2(p_Headers[j], p_Lengths[j])) == 0xFFFF;
+                            l_ValidCount += p_Valid[j];
+                        }
+                    continue;
+                }
+
+            __m128i l_A = widenHeaderSSE2(p_Headers[i]);
+            __m128i l_B = widenHeaderSSE2(p_Headers[i+1]);
+            __m128i l_C = widenHeaderSSE2(p_Headers[i+2]);
+            __m128i l_D = widenHeaderSSE2(p_Headers[i+3]);
+
+            //[a0+a2 b0+b2 a1+a3 b1+b3] and [c0+c2 d0+d2 c1+c3 d1+d3]
+            __m128i l_AB = _mm_add_epi32(_mm_unpacklo_epi32(l_A, l_B), _mm_unpackhi_epi32(l_A, l_B));
+            __m128i l_CD = _mm_add_epi32(_mm_unpacklo_epi32(l_C, l_D), _mm_unpackhi_epi32(l_C, l_D));
+            __m128i l_Sums = _mm_add_epi32(_mm_unpacklo_epi64(l_AB, l_CD), _mm_unpackhi_epi64(l_AB, l_CD));
+
+            int l_Bits = _mm_movemask_ps(_mm_castsi128_ps(foldAndCompareSSE2(l_Sums)));
+            for (int j = 0; j < 4; j++)
+                {
+                    p_Valid[i+j] = (l_Bits >> j) & 1;
+                    l_ValidCount += p_Valid[i+j];
+                }
+        }
+
+    for (; i < p_Count; i++)
+        {
+            p_Valid[i] = fold(sumSSE2(p_Headers[i], p_Lengths[i])) == 0xFFFF;
+            l_ValidCount += p_Valid[i];
+        }
+    return l_ValidCount;
+}
+
+/*!
+ * \brief Verifies eight 20 octet headers at a time
+ * \details Two headers share a register, one in each 128 bit half.
+ * Two rounds of horizontal adds leave headers 0, 2, 4, 6 in the low
+ * half and headers 1, 3, 5, 7 in the high half. The rest of the batch
+ * is verified by the SSE2 kernel.
+ */
+__attribute__((target("avx2")))
+static int verifyBatchAVX2(const unsigned char * const *p_Headers, const unsigned *p_Lengths, int p_Count, bool *p_Valid)
+{
+    int l_ValidCount = 0;
+    int i = 0;
+
+    for (; i + 8 <= p_Count; i += 8)
+        {
+            bool l_Fixed = true;
+            for (int j = i; j < i + 8; j++)
+                l_Fixed = l_Fixed && p_Lengths[j] == 20;
+            if(!l_Fixed)
+                {
+                    _mm256_zeroupper();
+                    l_ValidCount += verifyBatchSSE2(&p_Headers[i], &p_Lengths[i], 8, &p_Valid[i]);
+                    continue;
+                }
+
+            __m256i l_Pairs[4];
+            for (int k = 0; k < 4; k++)
+                l_Pairs[k] = _mm256_set_m128i(widenHeaderSSE2(p_Headers[i+2*k+1]), widenHeaderSSE2(p_Headers[i+2*k]));
+
+            __m256i l_Sums = _mm256_hadd_epi32(_mm256_hadd_epi32(l_Pairs[0], l_Pairs[1]), _mm256_hadd_epi32(l_Pairs[2], l_Pairs[3]));
+            __m256i l_Mask = _mm256_set1_epi32(0xFFFF);
+            l_Sums = _mm256_add_epi32(_mm256_and_si256(l_Sums, l_Mask), _mm256_srli_epi32(l_Sums, 16));
+            l_Sums = _mm256_add_epi32(_mm256_and_si256(l_Sums, l_Mask), _mm256_srli_epi32(l_Sums, 16));
+
+            int l_Bits = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(l_Sums, l_Mask)));
+            for (int k = 0; k < 4; k++)
+                {
+                    p_Valid[i+2*k] = (l_Bits >> k) & 1;
+                    p_Valid[i+2*k+1] = (l_Bits >> (k + 4)) & 1;
+                }
+            for (int j = i; j < i + 8; j++)
+                l_ValidCount += p_Valid[j];
+        }
+
+    _mm256_zeroupper();
+    return l_ValidCount + verifyBatchSSE2(&p_Headers[i], &p_Lengths[i], p_Count - i, &p_Valid[i]);
+}
+
+#endif
+
+/*!
+ * \brief Verifies the headers one at a time
+ */
+static int verifyBatchScalar(const unsigned char * const *p_Headers, const unsigned *p_Lengths, int p_Count, bool *p_Valid)
+{
+    int l_ValidCount = 0;
+
+    for (int i = 0; i < p_Count; i++)
+        {
+            p_Valid[i] = fold(sumScalar(p_Headers[i], p_Lengths[i])) == 0xFFFF;
+            if(p_Valid[i])
+                l_ValidCount++;
+        }
+    return l_ValidCount;
+}
+
+typedef uint64_t (*SumKernel)(const unsigned char *, unsigned);
+
+typedef int (*BatchKernel)(const unsigned char * const *, const unsigned *, int, bool *);
+
+/*!
+ * \brief The kernel and its name selected for this processor
+ */
+struct KernelSelection
+{
+    SumKernel kernel;
+    BatchKernel batch;
+    const char *name;
+
+    KernelSelection(void):kernel(sumScalar), batch(verifyBatchScalar), name("scalar")
+    {
+#ifdef CHECKSUM_X86
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2"))
+            {
+                kernel = sumAVX2;
+                batch = verifyBatchAVX2;
+                name = "avx2";
+            }
+        else if(__builtin_cpu_supports("sse2"))
+            {
+                kernel = sumSSE2;
+                batch = verifyBatchSSE2;
+                name = "sse2";
+            }
+#endif
+    }
+};
+
+static const KernelSelection s_Selection;
+
+
+/*! \sa Checksum
+ */
+unsigned short Checksum::sum(const unsigned char *p_Data, unsigned p_Length)
+{
+    return fold(s_Selection.kernel(p_Data, p_Length));
+}
+
+/*! \sa Checksum
+ */
+unsigned short Checksum::referenceSum(const unsigned char *p_Data, unsigned p_Length)
+{
+    return fold(sumScalar(p_Data, p_Length));
+}
+
+/*! \sa Checksum
+ */
+bool Checksum::verify(const unsigned char *p_Header, unsigned p_Length)
+{
+    return sum(p_Header, p_Length) == 0xFFFF;
+}
+
+/*! \sa Checksum
+ */
+int Checksum::verifyBatch(const unsigned char * const *p_Headers, const unsigned *p_Lengths, int p_Count, bool *p_Valid)
+{
+    return s_Selection.batch(p_Headers, p_Lengths, p_Count, p_Valid);
+}
+
+/*! \sa Checksum
+ */
+void Checksum::fill(unsigned char *p_Header, unsigned p_Length, unsigned p_Offset)
+{
+    //the field is excluded from the sum
+    memset(&p_Header[p_Offset], 0, 2);
+    uint16_t l_Checksum = ~sum(p_Header, p_Length);
+    memcpy(&p_Header[p_Offset], &l_Checksum, sizeof(l_Checksum));
+}
+
+/*! \sa Checksum
+ */
+unsigned short Checksum::update(unsigned short p_Checksum, unsigned short p_Old, unsigned short p_New)
+{
+    uint64_t l_Sum = (unsigned short)~p_Checksum;
+    l_Sum += (unsigned short)~p_Old;
+    l_Sum += p_New;
+    return (unsigned short)~fold(l_Sum);
+}
+
+/*! \sa Checksum
+ */
+const char *Checksum::getKernel(void)
+{
+    return s_Selection.name;
+}
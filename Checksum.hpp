@@ -0,0 +1,99 @@
+/*! \file  Checksum.hpp
+ *  \brief     Header file of Checksum class
+ *  \details   Defines the Internet checksum of RFC 1071
+ */
+
+/*!
+ * \class Checksum
+ * \brief The Internet checksum
+ *  \details The one's complement sum of RFC 1071 does not depend on the
+ *  byte order, so the data is summed in the host byte order and the
+ *  checksum is stored into the header as it is. The sum is computed
+ *  with the widest kernel that the processor supports: AVX2, SSE2 or
+ *  the scalar reference. The kernel is selected once when the
+ *  simulator is loaded.
+ */
+
+
+#include <stdint.h>
+
+using namespace std;
+
+
+#ifndef _CHECKSUM_H_
+#define _CHECKSUM_H_
+
+
+class Checksum
+{
+
+public:
+
+    /*! \fn static unsigned short sum(const unsigned char *p_Data, unsigned p_Length)
+     * \brief Returns the folded one's complement sum of the data
+     * \details The 16 bit words are summed in the host byte order
+     * @param [in] const unsigned char *p_Data The data to be summed
+     * @param [in] unsigned p_Length The number of octets, at most 64 KiB
+     * \return unsigned short: the sum in the host byte order
+     * \public
+     */
+    static unsigned short sum(const unsigned char *p_Data, unsigned p_Length);
+
+    /*! \fn static unsigned short referenceSum(const unsigned char *p_Data, unsigned p_Length)
+     * \brief Returns the sum computed by the scalar reference kernel
+     * \public
+     */
+    static unsigned short referenceSum(const unsigned char *p_Data, unsigned p_Length);
+
+    /*! \fn static bool verify(const unsigned char *p_Header, unsigned p_Length)
+     * \brief Returns true if the checksum of the header is valid
+     * \details A valid header including its checksum sums to all ones
+     * \public
+     */
+    static bool verify(const unsigned char *p_Header, unsigned p_Length);
+
+    /*! \fn static int verifyBatch(const unsigned char * const *p_Headers, const unsigned *p_Lengths, int p_Count, bool *p_Valid)
+     * \brief Verifies the checksums of p_Count headers
+     * \details The vector kernels verify the 20 octet headers without
+     * options four (SSE2) or eight (AVX2) at a time, with one header
+     * per lane. The other headers are verified one at a time.
+     * @param [in] const unsigned char * const *p_Headers The headers
+     * @param [in] const unsigned *p_Lengths The lengths of the headers
+     * @param [in] int p_Count The number of headers
+     * @param [out] bool *p_Valid The result of each header
+     * \return int: the number of valid headers
+     * \public
+     */
+    static int verifyBatch(const unsigned char * const *p_Headers, const unsigned *p_Lengths, int p_Count, bool *p_Valid);
+
+    /*! \fn static void fill(unsigned char *p_Header, unsigned p_Length, unsigned p_Offset)
+     * \brief Calculates the checksum of the header and stores it
+     * @param [in,out] unsigned char *p_Header The header
+     * @param [in] unsigned p_Length The length of the header
+     * @param [in] unsigned p_Offset The offset of the checksum field
+     * \public
+     */
+    static void fill(unsigned char *p_Header, unsigned p_Length, unsigned p_Offset);
+
+    /*! \fn static unsigned short update(unsigned short p_Checksum, unsigned short p_Old, unsigned short p_New)
+     * \brief Updates a checksum after one 16 bit word has changed
+     * \details Eqn. 3 of RFC 1624: HC' = ~(~HC + ~m + m'). All the
+     * values shall be in the same byte order.
+     * @param [in] unsigned short p_Checksum The checksum HC
+     * @param [in] unsigned short p_Old The old value m of the word
+     * @param [in] unsigned short p_New The new value m' of the word
+     * \return unsigned short: the new checksum HC'
+     * \public
+     */
+    static unsigned short update(unsigned short p_Checksum, unsigned short p_Old, unsigned short p_New);
+
+    /*! \fn static const char *getKernel(void)
+     * \brief Returns the name of the selected kernel
+     * \details "avx2", "sse2" or "scalar"
+     * \public
+     */
+    static const char *getKernel(void);
+};
+
+
+#endif /* _CHECKSUM_H_ */
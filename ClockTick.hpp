@@ -0,0 +1,62 @@
+/*! \file  ClockTick.hpp
+ *  \brief     Header file of the clock helpers
+ *  \details   Defines the clock period and the edge alignment of the
+ *  event-driven processes
+ */
+
+/*!
+ * \details By default every router and host has a clock of its own and
+ * the threads of its modules wake up on every edge to poll their
+ * buffers. When the simulator is built with _EVENT_DRIVEN the threads
+ * sleep on the data_written events of their buffers, on their timers
+ * and on the state changes they depend on, and the modules have no
+ * clocks at all. A woken thread still waits for the next clock edge
+ * before it does its work, so a message spends as many clock periods
+ * on each hop as in the clocked build while the idle time of the
+ * network costs nothing.
+ */
+
+
+#include "systemc"
+
+using namespace sc_core;
+
+
+#ifndef _CLOCKTICK_H_
+#define _CLOCKTICK_H_
+
+/*!
+ * The period of the router and the host clocks in seconds
+ */
+#define CLOCK_PERIOD 1
+
+
+/*! \fn inline sc_time timeToNextEdge(double p_Period)
+ * \brief Returns the time from now to the next edge of a clock
+ * \details The edges of the clock are at the multiples of p_Period. At
+ * an edge the next one is a full period away, as it is for a thread
+ * that waits for the clock.
+ * @param [in] double p_Period The time between the edges in seconds
+ */
+inline sc_time timeToNextEdge(double p_Period)
+{
+    const sc_time l_Period(p_Period, SC_SEC);
+    return l_Period - sc_time_stamp() % l_Period;
+}
+
+/*! \fn inline sc_time firstEdgeFrom(const sc_time& p_Time, double p_Period)
+ * \brief Returns the first edge of a clock at or after the given time
+ * \details The edge at which a clocked thread would first see that the
+ * time has come
+ * @param [in] const sc_time& p_Time The time
+ * @param [in] double p_Period The time between the edges in seconds
+ */
+inline sc_time firstEdgeFrom(const sc_time& p_Time, double p_Period)
+{
+    const sc_time l_Period(p_Period, SC_SEC);
+    const sc_time l_Offset = p_Time % l_Period;
+    return l_Offset == SC_ZERO_TIME ? p_Time : p_Time + l_Period - l_Offset;
+}
+
+
+#endif /* _CLOCKTICK_H_ */
@@ -2,12 +2,12 @@
 
 
 /************* Implementation of BGPSessionParameters *****************/
-BGPSessionParameters::BGPSessionParameters():m_KeepaliveTime(60), m_HoldDownTimeFactor(3)
+BGPSessionParameters::BGPSessionParameters():m_KeepaliveTime(60), m_HoldDownTimeFactor(3), m_MRAITime(30)
 {
     setHoldDownTime();
 }
 
-BGPSessionParameters::BGPSessionParameters(int p_KeepaliveTime, int p_HoldDownTimeFactor):m_KeepaliveTime(p_KeepaliveTime), m_HoldDownTimeFactor(p_HoldDownTimeFactor)
+BGPSessionParameters::BGPSessionParameters(int p_KeepaliveTime, int p_HoldDownTimeFactor):m_KeepaliveTime(p_KeepaliveTime), m_HoldDownTimeFactor(p_HoldDownTimeFactor), m_MRAITime(30)
 {
     setHoldDownTime();
 }
@@ -31,23 +31,34 @@ void BGPSessionParameters::setHoldDownTimeFactor(int p_HoldDownTimeFactor)
 	mtx_HoldDownFactor.unlock();
 }
 
+void BGPSessionParameters::setMRAITime(int p_MRAITime)
+{
+	mtx_MRAI.lock();
+    m_MRAITime = p_MRAITime;
+	mtx_MRAI.unlock();
+}
+
 int BGPSessionParameters::getKeepaliveTime(void){return m_KeepaliveTime;}
 
 int BGPSessionParameters::getHoldDownTime(void){return m_HoldDownTime;}
 
 int BGPSessionParameters::getHolDownTimeFactor(void){return m_HoldDownTimeFactor;}
 
+int BGPSessionParameters::getMRAITime(void){return m_MRAITime;}
+
 
 BGPSessionParameters& BGPSessionParameters::operator = (const BGPSessionParameters& p_Original) {
     m_KeepaliveTime = p_Original.m_KeepaliveTime;
     m_HoldDownTimeFactor = p_Original.m_HoldDownTimeFactor;
     m_Prefix = p_Original.m_Prefix;
     m_PrefixMask = p_Original.m_PrefixMask;
+    m_OriginatedPrefixes = p_Original.m_OriginatedPrefixes;
     m_ASNumber = p_Original.m_ASNumber;
     m_MED = p_Original.m_MED;
     m_LocalPref = p_Original.m_LocalPref;
     m_KeepaliveTime = p_Original.m_KeepaliveTime;
     m_HoldDownTimeFactor = p_Original.m_HoldDownTimeFactor;
+    m_MRAITime = p_Original.m_MRAITime;
     return *this;
 }
 
@@ -127,6 +138,16 @@ sc_uint<32> BGPSessionParameters::getPrefix(void){return m_Prefix;}
 
 sc_uint<32> BGPSessionParameters::getPrefixMask(void){return m_PrefixMask;}
 
+void BGPSessionParameters::addOriginatedPrefix(unsigned p_Prefix, int p_Length)
+{
+    struct_Prefix l_Prefix;
+    l_Prefix.prefix = p_Prefix;
+    l_Prefix.length = p_Length;
+    m_OriginatedPrefixes.push_back(l_Prefix);
+}
+
+const vector<struct_Prefix>& BGPSessionParameters::getOriginatedPrefixes(void){return m_OriginatedPrefixes;}
+
 int BGPSessionParameters::getASNumber(void){return m_ASNumber;}
 
 string BGPSessionParameters::getASNumberAsString(void){ return m_IPConverter.iToS(m_ASNumber);}
@@ -145,12 +166,33 @@ void ControlPlaneConfig::setNumberOfInterfaces(int p_NumberOfInterfaces)
 {
     m_NumberOfInterfaces = p_NumberOfInterfaces;
 }
+
+void ControlPlaneConfig::setPacketPoolSize(int p_PacketPoolSize)
+{
+    m_PacketPoolSize = p_PacketPoolSize;
+}
+
+void ControlPlaneConfig::setBurstSize(int p_BurstSize)
+{
+    m_BurstSize = p_BurstSize;
+}
 ///Getters
 int ControlPlaneConfig::getNumberOfInterfaces(void){return m_NumberOfInterfaces;}
 
+int ControlPlaneConfig::getPacketPoolSize(void)
+{
+    if(m_PacketPoolSize > 0)
+        return m_PacketPoolSize;
+    return m_NumberOfInterfaces * PACKET_POOL_BUFFERS_PER_INTERFACE;
+}
+
+int ControlPlaneConfig::getBurstSize(void){return m_BurstSize;}
+
 
 ControlPlaneConfig& ControlPlaneConfig::operator = (const ControlPlaneConfig& p_Original) {
     m_NumberOfInterfaces = p_Original.m_NumberOfInterfaces;
+    m_PacketPoolSize = p_Original.m_PacketPoolSize;
+    m_BurstSize = p_Original.m_BurstSize;
     return *this;
 }
 
@@ -241,11 +283,15 @@ RouterConfig& RouterConfig::operator = (const RouterConfig& p_Original) {
     m_NumberOfInterfaces = p_Original.m_NumberOfInterfaces;
     m_Prefix = p_Original.m_Prefix;
     m_PrefixMask = p_Original.m_PrefixMask;
+    m_OriginatedPrefixes = p_Original.m_OriginatedPrefixes;
     m_ASNumber = p_Original.m_ASNumber;
     m_MED = p_Original.m_MED;
     m_LocalPref = p_Original.m_LocalPref;
     m_KeepaliveTime = p_Original.m_KeepaliveTime;
     m_HoldDownTimeFactor = p_Original.m_HoldDownTimeFactor;
+    m_MRAITime = p_Original.m_MRAITime;
+    m_PacketPoolSize = p_Original.m_PacketPoolSize;
+    m_BurstSize = p_Original.m_BurstSize;
     m_NeighborConnections = new Connection*[p_Original.m_NumberOfInterfaces];
     for (int i = 0; i < p_Original.m_NumberOfInterfaces; ++i)
         {
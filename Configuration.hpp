@@ -12,10 +12,23 @@
 
 #include "systemc"
 #include "StringTools.hpp"
+#include "BGPUpdate.hpp"
+#include <vector>
 
 #define CLIENT 1
 #define SERVER 0
 
+/*!
+ * The default number of packet buffers in the pool of a router per
+ * interface, and the size of the pool of a host
+ */
+#define PACKET_POOL_BUFFERS_PER_INTERFACE 64
+
+/*!
+ * The default number of packets that an interface handles per clock
+ */
+#define BURST_DEFAULT_SIZE 1
+
 using namespace sc_dt;
 using namespace std;
 using namespace sc_core;
@@ -32,8 +45,8 @@ public:
     
     /*!
       \Brief Default constructor of BGPSessionParameters-class
-      \details Sets the keepalive time to 60 and the holddown time
-      factor to 3
+      \details Sets the keepalive time to 60, the holddown time
+      factor to 3 and the MinRouteAdvertisementInterval to 30
       * \public
       */  
     BGPSessionParameters();
@@ -72,6 +85,14 @@ public:
      */
     void setHoldDownTimeFactor(int p_HoldDownTimeFactor);    
 
+    /*! \fn void setMRAITime(int p_MRAITime);
+     *  \brief Sets the MinRouteAdvertisementInterval
+     *  @param[in] int p_MRAITime The minimum time in seconds between
+     two UPDATE messages sent to the same peer
+     * \public
+     */
+    void setMRAITime(int p_MRAITime);
+
     /*! \fn void setNICMode(int p_Interface, int p_Mode)
      *  \brief Sets the interface mode used in TCP session establishment
      *  @param[in] int p_Interface The interface id
@@ -103,6 +124,13 @@ public:
      */
     int getHolDownTimeFactor(void);
 
+    /*! \fn int getMRAITime(void);
+     *  \brief Returns the MinRouteAdvertisementInterval
+     *  \return integer value
+     * \public
+     */
+    int getMRAITime(void);
+
     /*! \fn bool isClient(int p_Interface)
      *  \brief Checks whether the given interface is in the client mode
      *  @param[in] int p_Interface The interface id
@@ -132,6 +160,15 @@ public:
      */
     void setPrefixMask(sc_uint<32> p_PrefixMask);
 
+    /*! \fn void addOriginatedPrefix(unsigned p_Prefix, int p_Length)
+     *  \brief Adds a prefix that the AS originates in addition to the
+     *  prefix of the AS
+     *  @param[in] unsigned p_Prefix The prefix in host byte order
+     *  @param[in] int p_Length The prefix length
+     * \public
+     */
+    void addOriginatedPrefix(unsigned p_Prefix, int p_Length);
+
     /*! \fn void setPrefixMask(sc_uint<32> p_PrefixMask);
      *  \brief Sets the AS Identifier to which this router connects
      *  @param[in] int p_ASNumber The AS identifier of the local AS 
@@ -191,6 +228,12 @@ public:
      */
     sc_uint<32> getPrefixMask(void);
 
+    /*! \fn const vector<struct_Prefix>& getOriginatedPrefixes(void)
+     *  \brief Returns the prefixes added by addOriginatedPrefix
+     * \public
+     */
+    const vector<struct_Prefix>& getOriginatedPrefixes(void);
+
     /*! \fn int getASNumber(void);
      *  \brief Returns the AS number
      *  \return integer value
@@ -248,6 +291,13 @@ protected:
      */
     int m_HoldDownTimeFactor;
 
+    /*! \brief MinRouteAdvertisementInterval of this session
+     * \details The changes to be advertised to the session peer are
+     * collected for this long before the next UPDATE message is sent
+     * \protected
+     */
+    int m_MRAITime;
+
     /*! \property int *m_NICMode
      * \brief holds the network interface mode information
      */
@@ -265,6 +315,12 @@ protected:
      */
     sc_uint<32> m_PrefixMask;
 
+    /*! \brief The additional prefixes originated by the AS
+     * \details
+     * \protected
+     */
+    vector<struct_Prefix> m_OriginatedPrefixes;
+
     /*! \brief The AS number of this router
      * \details
      * \protected
@@ -313,6 +369,13 @@ private:
      */
 	sc_mutex mtx_HoldDownFactor;
 
+    /*! \property sc_mutex mtx_MRAI
+	 * \brief Arbitrates the setting of MinRouteAdvertisementInterval
+     * \details
+     * \private
+     */
+	sc_mutex mtx_MRAI;
+
 
     /*! \property StringTools m_IPConverter
      *  \brief BGP Local Preference variable
@@ -333,7 +396,7 @@ class ControlPlaneConfig: public BGPSessionParameters
 
 public:
 
-    inline ControlPlaneConfig(){};
+    inline ControlPlaneConfig():m_NumberOfInterfaces(0), m_PacketPoolSize(0), m_BurstSize(BURST_DEFAULT_SIZE){};
     inline virtual ~ControlPlaneConfig(){};
 
     /*! \fn void setNumberOfInterfaces(int p_NumberOfInterfaces);
@@ -350,6 +413,37 @@ public:
      */
     int getNumberOfInterfaces(void);
 
+    /*! \fn void setPacketPoolSize(int p_PacketPoolSize);
+     *  \brief Sets the number of packet buffers in the pool of the router
+     *  @param[in] int p_PacketPoolSize The buffer count
+     * \public
+     */
+    void setPacketPoolSize(int p_PacketPoolSize);
+
+    /*! \fn int getPacketPoolSize(void);
+     *  \brief Returns the number of packet buffers in the pool
+     *  \details Unless set, the size is
+     *  PACKET_POOL_BUFFERS_PER_INTERFACE per interface
+     *  \return integer value
+     * \public
+     */
+    int getPacketPoolSize(void);
+
+    /*! \fn void setBurstSize(int p_BurstSize);
+     *  \brief Sets the number of packets that the router handles per
+     *  interface per clock
+     *  @param[in] int p_BurstSize The burst size
+     * \public
+     */
+    void setBurstSize(int p_BurstSize);
+
+    /*! \fn int getBurstSize(void);
+     *  \brief Returns the burst size
+     *  \return integer value
+     * \public
+     */
+    int getBurstSize(void);
+
     /*! \fn ControlPlaneConfig& operator = (const ControlPlaneConfig& p_Original);
      *  \brief clones the passed ControlplaneConfig object to this object
      *  \return reference ControlPlaneConfig& 
@@ -366,6 +460,20 @@ protected:
      */
     int m_NumberOfInterfaces;
 
+    /*! \property int m_PacketPoolSize
+     * \brief Number of packet buffers in the pool of the data plane
+     * \details 0 if the size is derived from the number of interfaces
+     * \protected
+     */
+    int m_PacketPoolSize;
+
+    /*! \property int m_BurstSize
+     * \brief Number of packets handled per interface per clock
+     * \details
+     * \protected
+     */
+    int m_BurstSize;
+
 
 
 };
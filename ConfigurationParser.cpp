@@ -0,0 +1,332 @@
+/*! \file ConfigurationParser.cpp
+ *  \brief     Implementation of ConfigurationParser class.
+ *  \details
+ */
+
+
+#include "ConfigurationParser.hpp"
+#include "ReportGlobals.hpp"
+#include "StringTools.hpp"
+#include "TopologyGenerator.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+/*!
+ * \brief Orders the scheduled commands by their execution times
+ */
+static bool earlierCommand(const struct_ScheduledCommand& p_First, const struct_ScheduledCommand& p_Second)
+{
+    return p_First.time < p_Second.time;
+}
+
+
+ConfigurationParser::ConfigurationParser(void):m_Duration(SIMULATION_DURATION)
+{
+}
+
+/*! \sa ConfigurationParser
+ */
+bool ConfigurationParser::parseConfiguration(const string& p_Word, SimulationConfig& p_Config)
+{
+    ///find the tags
+    if(p_Word.compare(0, START_TAG_LENGTH, START_TAG) != 0)
+        return false;
+    string::size_type l_End = p_Word.find(END_TAG, START_TAG_LENGTH);
+    if(l_End == string::npos)
+        return false;
+
+    ///split the router fields
+    vector<string> l_Routers = split(p_Word.substr(START_TAG_LENGTH, l_End - START_TAG_LENGTH), ROUTER_SEPARATOR);
+
+    //a separator after the last router is allowed
+    if(l_Routers.size() > 1 && trim(l_Routers.back()).empty())
+        l_Routers.pop_back();
+
+    StringTools l_Report("Parser");
+    l_Report.newReportString("Count: ");
+    SC_REPORT_INFO(g_DebugID, l_Report.appendReportString((int)l_Routers.size()));
+
+    ///set the number of routers
+    p_Config.init(l_Routers.size());
+
+    ///parse the fields of all the routers
+    for(unsigned l_Idx = 0; l_Idx < l_Routers.size(); l_Idx++)
+        {
+            p_Config.addRouterConfig(l_Idx, IF_COUNT);
+            if(!parseRouter(l_Routers[l_Idx], p_Config.getRouterConfigurationPtr(l_Idx)))
+                {
+                    l_Report.newReportString("Malformed router field #");
+                    SC_REPORT_WARNING(g_ErrorID, l_Report.appendReportString((int)l_Idx));
+                    return false;
+                }
+        }
+    return true;
+}
+
+/*! \sa ConfigurationParser
+ */
+bool ConfigurationParser::readBatchFile(const char *p_FileName, SimulationConfig& p_Config)
+{
+    ifstream l_File(p_FileName);
+    if(!l_File)
+        return false;
+
+    string l_Line, l_Word;
+    bool l_Configured = false, l_InConfig = false;
+    //the sizes are set once the routers have been configured
+    vector<pair<string, string> > l_Sizes;
+
+    m_Commands.clear();
+
+    while(getline(l_File, l_Line))
+        {
+            l_Line = trim(l_Line);
+            if(l_Line.empty() || l_Line.compare(0, 1, "#") == 0)
+                continue;
+
+            ///collect the configuration string until its end tag
+            if(l_InConfig || l_Line.compare(0, START_TAG_LENGTH, START_TAG) == 0)
+                {
+                    l_InConfig = true;
+                    l_Word += l_Line;
+                    if(l_Word.find(END_TAG) == string::npos)
+                        continue;
+                    if(!parseConfiguration(l_Word, p_Config))
+                        return false;
+                    l_InConfig = false;
+                    l_Configured = true;
+                    continue;
+                }
+
+            string::size_type l_Pos = l_Line.find(FIELD_SEPARATOR);
+            string l_Tag = l_Line.substr(0, l_Pos);
+            string l_Fields = l_Pos == string::npos ? "" : l_Line.substr(l_Pos + 1);
+
+            if(l_Tag.compare(DURATION_TAG) == 0)
+                {
+                    if(!(istringstream(l_Fields) >> m_Duration) || m_Duration <= 0)
+                        return false;
+                }
+            else if(l_Tag.compare(TOPOLOGY_TAG) == 0)
+                {
+                    if(l_Configured || !generateTopology(l_Fields, p_Config))
+                        return false;
+                    l_Configured = true;
+                }
+            else if(l_Tag.compare(AT_TAG) == 0)
+                {
+                    struct_ScheduledCommand l_Command;
+                    l_Pos = l_Fields.find(FIELD_SEPARATOR);
+                    if(l_Pos == string::npos || !(istringstream(l_Fields.substr(0, l_Pos)) >> l_Command.time))
+                        return false;
+                    l_Command.command = l_Fields.substr(l_Pos + 1);
+                    m_Commands.push_back(l_Command);
+                }
+            else if(l_Tag.compare(BURST_TAG) == 0 || l_Tag.compare(PACKET_POOL_TAG) == 0)
+                l_Sizes.push_back(make_pair(l_Tag, l_Fields));
+            else
+                {
+                    SC_REPORT_WARNING(g_ErrorID, (string("Unknown batch file line: ") + l_Line).c_str());
+                    return false;
+                }
+        }
+
+    //the commands of the same time keep the order of the file
+    stable_sort(m_Commands.begin(), m_Commands.end(), earlierCommand);
+
+    if(!l_Configured || l_InConfig)
+        return false;
+
+    for(unsigned i = 0; i < l_Sizes.size(); i++)
+        if(!setDataPlaneSize(l_Sizes[i].first, l_Sizes[i].second, p_Config))
+            {
+                SC_REPORT_WARNING(g_ErrorID, (l_Sizes[i].first + string(" line is malformed")).c_str());
+                return false;
+            }
+    return true;
+}
+
+/*! \sa ConfigurationParser
+ */
+bool ConfigurationParser::setDataPlaneSize(const string& p_Tag, const string& p_Fields, SimulationConfig& p_Config)
+{
+    vector<string> l_Fields = split(p_Fields, FIELD_SEPARATOR);
+    if(l_Fields.size() > 2)
+        return false;
+
+    int l_Size;
+    if(!(istringstream(l_Fields[0]) >> l_Size) || l_Size <= 0)
+        return false;
+
+    ///no router id sets all the routers
+    int l_First = 0, l_Last = p_Config.getNumberOfRouters() - 1;
+    if(l_Fields.size() == 2)
+        {
+            if(!(istringstream(l_Fields[1]) >> l_First) || l_First < 0 || l_First > l_Last)
+                return false;
+            l_Last = l_First;
+        }
+
+    for(int i = l_First; i <= l_Last; i++)
+        {
+            RouterConfig *l_Router = p_Config.getRouterConfigurationPtr(i);
+            if(p_Tag.compare(BURST_TAG) == 0)
+                l_Router->setBurstSize(l_Size);
+            else
+                l_Router->setPacketPoolSize(l_Size);
+        }
+    return true;
+}
+
+/*! \sa ConfigurationParser
+ */
+double ConfigurationParser::getDuration(void)
+{
+    return m_Duration;
+}
+
+/*! \sa ConfigurationParser
+ */
+const vector<struct_ScheduledCommand>& ConfigurationParser::getCommands(void)
+{
+    return m_Commands;
+}
+
+/*! \sa ConfigurationParser
+ */
+int ConfigurationParser::getCommandRouter(const string& p_Command, int p_NumberOfRouters)
+{
+    vector<string> l_Fields = split(p_Command, ",");
+    unsigned l_Field = l_Fields[0].compare(SEND_PACKET) == 0 ? 2 : 1;
+    if(l_Fields.size() <= l_Field || trim(l_Fields[l_Field]).empty())
+        return -1;
+
+    int l_Router = atoi(l_Fields[l_Field].c_str());
+    return l_Router >= 0 && l_Router < p_NumberOfRouters ? l_Router : -1;
+}
+
+/*! \sa ConfigurationParser
+ */
+bool ConfigurationParser::parseRouter(const string& p_Field, RouterConfig *p_Router)
+{
+    vector<string> l_Fields = split(p_Field, FIELD_SEPARATOR);
+
+    ///set the state to AS_ID
+    fieldStates l_State = S_AS_ID;
+
+    for(unsigned i = 0; i < l_Fields.size(); i++)
+        {
+            string field = trim(l_Fields[i]);
+            int l_IntField = 0;
+
+            ///store the field
+            switch (l_State)
+                {
+                case S_AS_ID:
+                    istringstream(field) >> l_IntField;
+                    p_Router->setASNumber(l_IntField);
+                    l_State = S_PREFIX;
+                    break;
+                case S_PREFIX:
+                    p_Router->setPrefix(field);
+                    l_State = S_MED;
+                    break;
+                case S_MED:
+                    istringstream(field) >> l_IntField;
+                    p_Router->setMED(l_IntField);
+                    l_State = S_LOCAL_PREF;
+                    break;
+                case S_LOCAL_PREF:
+                    istringstream(field) >> l_IntField;
+                    p_Router->setLocalPref(l_IntField);
+                    l_State = S_KEEPALIVE;
+                    break;
+                case S_KEEPALIVE:
+                    istringstream(field) >> l_IntField;
+                    p_Router->setKeepaliveTime(l_IntField);
+                    l_State = S_HOLDDOWNMUL;
+                    break;
+                case S_HOLDDOWNMUL:
+                    istringstream(field) >> l_IntField;
+                    p_Router->setHoldDownTimeFactor(l_IntField);
+                    l_State = S_PORT_ID;
+                    break;
+                case S_PORT_ID:
+                    {
+                        //each connecion field: local port id, client
+                        //port id, client id
+                        vector<string> l_SubFields = split(field, CONNECTION_SEPARATOR);
+                        int tempFields[3];
+                        if(l_SubFields.size() != 3)
+                            return false;
+                        for(int j = 0; j < 3; j++)
+                            istringstream(l_SubFields[j]) >> tempFields[j];
+
+                        ///Store the connection parameters to the
+                        ///connection config object
+                        p_Router->addConnectionConfig(tempFields[0], tempFields[1], tempFields[2]);
+                    }
+                    break;
+                default:
+                    return false;
+                }
+        }
+
+    //all the router parameters are mandatory
+    return l_State == S_PORT_ID;
+}
+
+/*! \sa ConfigurationParser
+ */
+bool ConfigurationParser::generateTopology(const string& p_Fields, SimulationConfig& p_Config)
+{
+    vector<string> l_Fields = split(p_Fields, FIELD_SEPARATOR);
+    TopologyGenerator::Topology l_Topology;
+    int l_Routers = 0, l_Parameter = 0, l_Prefixes = 0;
+    unsigned long l_Seed = 1;
+
+    if(l_Fields.size() < 2 || !TopologyGenerator::parseTopology(trim(l_Fields[0]), l_Topology))
+        return false;
+
+    ///the parameter, the seed and the prefixes are optional
+    istringstream(l_Fields[1]) >> l_Routers;
+    if(l_Fields.size() > 2)
+        istringstream(l_Fields[2]) >> l_Parameter;
+    if(l_Fields.size() > 3)
+        istringstream(l_Fields[3]) >> l_Seed;
+    if(l_Fields.size() > 4)
+        istringstream(l_Fields[4]) >> l_Prefixes;
+
+    TopologyGenerator l_Generator(l_Seed);
+    l_Generator.setPrefixesPerAS(l_Prefixes);
+    return l_Generator.generate(p_Config, l_Topology, l_Routers, l_Parameter);
+}
+
+/*! \sa ConfigurationParser
+ */
+vector<string> ConfigurationParser::split(const string& p_String, const char *p_Separator)
+{
+    vector<string> l_Parts;
+    string::size_type l_Start = 0, l_End;
+
+    while((l_End = p_String.find(p_Separator, l_Start)) != string::npos)
+        {
+            l_Parts.push_back(p_String.substr(l_Start, l_End - l_Start));
+            l_Start = l_End + 1;
+        }
+    l_Parts.push_back(p_String.substr(l_Start));
+    return l_Parts;
+}
+
+/*! \sa ConfigurationParser
+ */
+string ConfigurationParser::trim(const string& p_String)
+{
+    const char *l_Space = " \t\r\n";
+    string::size_type l_First = p_String.find_first_not_of(l_Space);
+    if(l_First == string::npos)
+        return "";
+    return p_String.substr(l_First, p_String.find_last_not_of(l_Space) - l_First + 1);
+}
@@ -0,0 +1,157 @@
+/*! \file  ConfigurationParser.hpp
+ *  \brief     Header file of ConfigurationParser class
+ *  \details   Parses the simulation configuration from the GUI or
+ *  from a batch file
+ */
+
+/*!
+ * \class ConfigurationParser
+ * \brief Builds a SimulationConfig from the configuration string
+ *  \details The configuration string is the one sent by the GUI:
+ *  <SIM_CONFIG>router;router;...</SIM_CONFIG>, where each router field
+ *  is AS,prefix,MED,local pref,keepalive,hold down multiplier followed
+ *  by any number of local port_neighbor port_neighbor id connections.
+ *
+ *  A batch file holds the same configuration string, which may be
+ *  split on several lines, and the lines
+ *  \li DURATION,[SECONDS] the length of the simulation
+ *  \li AT,[SECONDS],[COMMAND] a simulation command of the GUI protocol
+ *  to be executed at the given time, for example
+ *  AT,30,SEND_PACKET,12.0.0.1,0,payload
+ *  \li TOPOLOGY,[TYPE],[ROUTERS],[PARAMETER],[SEED],[PREFIXES_PER_AS]
+ *  a generated topology in place of the configuration string
+ *  \li BURST,[PACKETS],[ROUTER_ID] the packets handled per interface
+ *  per clock
+ *  \li PACKET_POOL,[BUFFERS],[ROUTER_ID] the size of the packet pool
+ *
+ *  The BURST and PACKET_POOL lines apply to all the routers when the
+ *  router is left out, and to the routers of the configuration
+ *  wherever they are in the file.
+ *  \sa TopologyGenerator
+ *
+ *  Empty lines and lines starting with # are skipped.
+ */
+
+
+#include "systemc"
+#include "Configuration.hpp"
+#include "GUIProtocolTags.hpp"
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace sc_core;
+
+
+#ifndef _CONFIGURATIONPARSER_H_
+#define _CONFIGURATIONPARSER_H_
+
+
+/*!
+ * \brief A simulation command scheduled by a batch file
+ */
+struct struct_ScheduledCommand
+{
+    double time;
+    string command;
+};
+
+
+class ConfigurationParser
+{
+
+public:
+
+    ConfigurationParser(void);
+
+    /*! \fn bool parseConfiguration(const string& p_Word, SimulationConfig& p_Config)
+     * \brief Parses the configuration string into p_Config
+     * @param [in] const string& p_Word The configuration string
+     * including the start and the end tags
+     * @param [out] SimulationConfig& p_Config The configuration
+     * \return bool: false if the string is malformed
+     * \public
+     */
+    bool parseConfiguration(const string& p_Word, SimulationConfig& p_Config);
+
+    /*! \fn bool readBatchFile(const char *p_FileName, SimulationConfig& p_Config)
+     * \brief Reads the configuration, the duration and the commands
+     * from a batch file
+     * \return bool: false if the file cannot be read or is malformed
+     * \public
+     */
+    bool readBatchFile(const char *p_FileName, SimulationConfig& p_Config);
+
+    /*! \fn double getDuration(void)
+     * \brief Returns the duration of the simulation in seconds
+     * \details SIMULATION_DURATION if the batch file did not set it
+     * \public
+     */
+    double getDuration(void);
+
+    /*! \fn const vector<struct_ScheduledCommand>& getCommands(void)
+     * \brief Returns the commands of the batch file in the order of
+     * their execution times
+     * \public
+     */
+    const vector<struct_ScheduledCommand>& getCommands(void);
+
+    /*! \fn static int getCommandRouter(const string& p_Command, int p_NumberOfRouters)
+     * \brief Returns the router that a command is executed on
+     * \details The router is the first field of the command, or the
+     * second one of SEND_PACKET
+     * @param [in] const string& p_Command The command and its fields
+     * @param [in] int p_NumberOfRouters The number of routers
+     * \return int: -1 if the command has no valid router field, as STOP
+     * \public
+     */
+    static int getCommandRouter(const string& p_Command, int p_NumberOfRouters);
+
+    /*! \fn static vector<string> split(const string& p_String, const char *p_Separator)
+     * \brief Splits the string at each separator
+     * \details Keeps the empty fields
+     * \public
+     */
+    static vector<string> split(const string& p_String, const char *p_Separator);
+
+private:
+
+    /*!
+     * \brief The fields of a router in the configuration string
+     */
+    enum fieldStates{S_AS_ID, S_PREFIX, S_MED, S_LOCAL_PREF, S_KEEPALIVE, S_HOLDDOWNMUL, S_PORT_ID};
+
+    double m_Duration;
+
+    vector<struct_ScheduledCommand> m_Commands;
+
+    /*! \fn bool parseRouter(const string& p_Field, RouterConfig *p_Router)
+     * \brief Parses the field of one router
+     * \private
+     */
+    bool parseRouter(const string& p_Field, RouterConfig *p_Router);
+
+    /*! \fn bool generateTopology(const string& p_Fields, SimulationConfig& p_Config)
+     * \brief Generates the configuration given by the fields of a
+     * TOPOLOGY line
+     * \private
+     */
+    bool generateTopology(const string& p_Fields, SimulationConfig& p_Config);
+
+    /*! \fn bool setDataPlaneSize(const string& p_Tag, const string& p_Fields, SimulationConfig& p_Config)
+     * \brief Sets the burst size or the packet pool size given by the
+     * fields of a BURST or a PACKET_POOL line
+     * \return bool: false if the fields are malformed
+     * \private
+     */
+    bool setDataPlaneSize(const string& p_Tag, const string& p_Fields, SimulationConfig& p_Config);
+
+    /*! \fn static string trim(const string& p_String)
+     * \brief Removes the leading and trailing white space
+     * \private
+     */
+    static string trim(const string& p_String);
+};
+
+
+#endif /* _CONFIGURATIONPARSER_H_ */
@@ -9,9 +9,11 @@
 
 #include "ControlPlane.hpp"
 #include "ReportGlobals.hpp"
+#include "ClockTick.hpp"
+#include <sstream>
 
 
-ControlPlane::ControlPlane(sc_module_name p_ModName, ControlPlaneConfig * const p_BGPConfig):sc_module(p_ModName),m_BGPConfig(p_BGPConfig), m_Name("BGP_Session"), m_MsgId(0)
+ControlPlane::ControlPlane(sc_module_name p_ModName, ControlPlaneConfig * const p_BGPConfig):sc_module(p_ModName), m_Timers("Timers"), m_BGPConfig(p_BGPConfig), m_Name("BGP_Session"), m_MsgId(0), m_Epoch(0)
 {
 
 	//make the inner bindings
@@ -26,7 +28,7 @@ ControlPlane::ControlPlane(sc_module_name p_ModName, ControlPlaneConfig * const
 	//allocate reference array for receiving exports
 	export_Session = new sc_export<BGPSession_If>*[m_BGPConfig->getNumberOfInterfaces()-1];
 	export_InterfaceControl = new sc_export<Interface_If>*[m_BGPConfig->getNumberOfInterfaces()-1];
-	export_RoutingTable = new sc_export<Output_If>*[m_BGPConfig->getNumberOfInterfaces()-1];
+	export_RoutingTable = new sc_export<Output_If<BGPMessageHandle> >*[m_BGPConfig->getNumberOfInterfaces()-1];
 
 	//inititate the sessions
 	for (int i = 0; i < m_BGPConfig->getNumberOfInterfaces()-1; i++)
@@ -37,14 +39,22 @@ ControlPlane::ControlPlane(sc_module_name p_ModName, ControlPlaneConfig * const
 		//Export the session interface for RT
 		export_Session[i] = new sc_export<BGPSession_If>;
 		export_Session[i]->bind(*m_BGPSessions[i]);
+#ifndef _EVENT_DRIVEN
 		m_BGPSessions[i]->port_Clk(port_Clk);
+#endif
+		m_BGPSessions[i]->port_Timers(m_Timers);
 		export_InterfaceControl[i] = new sc_export<Interface_If>;
-		export_RoutingTable[i] = new sc_export<Output_If>;
+		export_RoutingTable[i] = new sc_export<Output_If<BGPMessageHandle> >;
 
 	}
+	m_Counters.opens = m_Counters.updates = m_Counters.notifications = m_Counters.keepalives = 0;
+	m_Counters.withdrawnRoutes = 0;
+
 	setUp(true);
 	SC_THREAD(controlPlaneMain);
+#ifndef _EVENT_DRIVEN
 	sensitive << port_Clk.pos();
+#endif
 }
 
 ControlPlane::~ControlPlane()
@@ -65,18 +75,19 @@ void ControlPlane::controlPlaneMain(void)
 	//The main thread of the control plane starts
 	while(true)
 	{
-		wait();
+		waitForWork();
 		if(!isRunning())
 			continue;
 		//read input message from the buffer if available
-		if(m_ReceivingBuffer.num_available() > 0)
+		if(m_ReceivingBuffer.nb_read(m_BGPMsgIn))
 		{
-			m_ReceivingBuffer.read(m_BGPMsgIn);
 
-//			cout << name() << ": Session: " << m_BGPMsgIn.m_OutboundInterface << " MSG_TYPE: " << m_BGPMsgIn.m_Type << " @ " << sc_time_stamp() << endl;
-			//write only if the session is not in IDLE
-			if(m_BGPSessions[m_BGPMsgIn.m_OutboundInterface]->getBGPCurrentState() != IDLE)
-				m_BGPSessions[m_BGPMsgIn.m_OutboundInterface]->m_FsmInputBuffer.write(m_BGPMsgIn);
+//			cout << name() << ": Session: " << m_BGPMsgIn->m_OutboundInterface << " MSG_TYPE: " << m_BGPMsgIn->m_Type << " @ " << sc_time_stamp() << endl;
+			//move the message to the session if it is not in IDLE,
+			//otherwise it is dropped
+			if(m_BGPSessions[m_BGPMsgIn->m_OutboundInterface]->getBGPCurrentState() != IDLE)
+				m_BGPSessions[m_BGPMsgIn->m_OutboundInterface]->m_FsmInputBuffer.write(m_BGPMsgIn);
+			m_BGPMsgIn.reset();
 
 		}
 	}
@@ -87,11 +98,12 @@ void ControlPlane::controlPlaneMain(void)
 void ControlPlane::killControlPlane()
 {
 	setUp(false);
-	while(m_ReceivingBuffer.num_available() > 0)
-		m_ReceivingBuffer.read(m_BGPMsgIn);
+	m_ReceivingBuffer.clear();
 
+	//the peers tell the messages of the next incarnation by the epoch
 	m_MsgId = 0;
-	m_BGPMsgIn.clearMessage();
+	m_Epoch++;
+	m_BGPMsgIn.reset();
 
 }
 
@@ -118,18 +130,96 @@ bool ControlPlane::isRunning(void)
 }
 
 
-bool ControlPlane::write(BGPMessage& p_BGPMsg)
+void ControlPlane::waitForWork(void)
+{
+#ifdef _EVENT_DRIVEN
+	if(m_ReceivingBuffer.num_available() == 0)
+		wait(m_ReceivingBuffer.data_written_event());
+	wait(timeToNextEdge(CLOCK_PERIOD));
+#else
+	wait();
+#endif
+}
+
+const struct_MessageCounters& ControlPlane::getMessageCounters(void)
+{
+	return m_Counters;
+}
+
+string ControlPlane::getDuplicateStatistics(void)
+{
+	unsigned long l_Accepted = 0, l_Duplicates = 0, l_Restarts = 0;
+	for (int i = 0; i < m_BGPConfig->getNumberOfInterfaces()-1; i++)
+	{
+		DuplicateFilter& l_Filter = m_BGPSessions[i]->getInputFilter();
+		l_Accepted += l_Filter.getAccepted();
+		l_Duplicates += l_Filter.getDuplicates();
+		l_Restarts += l_Filter.getRestarts();
+	}
+	ostringstream l_Stats;
+	l_Stats << l_Accepted << "," << l_Duplicates << "," << l_Restarts;
+	return l_Stats.str();
+}
+
+
+bool ControlPlane::write(BGPMessageHandle& p_BGPMsg)
 {
 
 	//enter to the critical region
 	mutex_Write.lock();
-	p_BGPMsg.m_MsgId = ++m_MsgId;
+	p_BGPMsg->m_MsgId = ++m_MsgId;
+	p_BGPMsg->m_Epoch = m_Epoch;
+	//count the message
+	countMessage(*p_BGPMsg);
 	//reset the corresponding keepalive timer
-	m_BGPSessions[p_BGPMsg.m_OutboundInterface]->resetKeepalive();
-	//write message to the DataPlane
+	m_BGPSessions[p_BGPMsg->m_OutboundInterface]->resetKeepalive();
+	//the message is moved to the DataPlane
 	port_ToDataPlane->write(p_BGPMsg);
 	//exit from the critical region
 	mutex_Write.unlock();
 	return true;
 
 }
+
+bool ControlPlane::nb_write(BGPMessageHandle& p_BGPMsg)
+{
+	if(mutex_Write.trylock() != 0)
+		return false;
+	p_BGPMsg->m_MsgId = m_MsgId + 1;
+	p_BGPMsg->m_Epoch = m_Epoch;
+	//the DataPlane reads the message only after this process has
+	//yielded, so it is still counted through the pointer
+	BGPMessage *l_BGPMsg = p_BGPMsg.get();
+	bool l_Written = port_ToDataPlane->nb_write(p_BGPMsg);
+	if(l_Written)
+	{
+		m_MsgId++;
+		countMessage(*l_BGPMsg);
+		m_BGPSessions[l_BGPMsg->m_OutboundInterface]->resetKeepalive();
+	}
+	mutex_Write.unlock();
+	return l_Written;
+}
+
+void ControlPlane::countMessage(const BGPMessage& p_BGPMsg)
+{
+	switch(p_BGPMsg.m_Type)
+	{
+	case OPEN:
+		m_Counters.opens++;
+		break;
+	case UPDATE:
+		m_Counters.updates++;
+		m_Counters.withdrawnRoutes += p_BGPMsg.m_Update.m_WithdrawnRoutes.size();
+		m_Counters.lastUpdate = sc_time_stamp();
+		break;
+	case NOTIFICATION:
+		m_Counters.notifications++;
+		break;
+	case KEEPALIVE:
+		m_Counters.keepalives++;
+		break;
+	default:
+		break;
+	}
+}
@@ -21,7 +21,9 @@
 #include "RoutingTable_If.hpp"
 #include "StringTools.hpp"
 #include "Output_If.hpp"
+#include "SPSCChannel.hpp"
 #include "Interface_If.hpp"
+#include "TimerService.hpp"
 
 using namespace std;
 using namespace sc_core;
@@ -32,26 +34,41 @@ using namespace sc_dt;
 #ifndef CONTROLPLANE_H
 #define CONTROLPLANE_H
 
+/*!
+ * \brief Counters of the BGP messages sent by a router
+ */
+struct struct_MessageCounters
+{
+    unsigned long opens;
+    unsigned long updates;
+    unsigned long notifications;
+    unsigned long keepalives;
+    unsigned long withdrawnRoutes; // prefixes withdrawn by the UPDATEs
+    sc_time lastUpdate;            // time of the latest UPDATE
+};
 
 
 
-class ControlPlane: public sc_module, public Output_If<BGPMessage>
+
+class ControlPlane: public sc_module, public Output_If<BGPMessageHandle>
 {
 
 public:
 
     
+#ifndef _EVENT_DRIVEN
     /*! \brief System clock signal
      * \details The router's internal clock
      * \public
      */
     sc_in_clk port_Clk;
+#endif
 
     /*! \brief Forwarding port
      * \details Used to write BGP messages to the data plane
      * \public
      */
-    sc_port<Output_If<BGPMessage> ,0, SC_ZERO_OR_MORE_BOUND> port_ToDataPlane;
+    sc_port<Output_If<BGPMessageHandle> ,0, SC_ZERO_OR_MORE_BOUND> port_ToDataPlane;
 
     /*! \brief NIC control port
      * \details
@@ -63,16 +80,16 @@ public:
      * \details exports the output_if of routing table for BGPSession
      * \public
      */
-    sc_export<Output_If<BGPMessage> > **export_RoutingTable;
+    sc_export<Output_If<BGPMessageHandle> > **export_RoutingTable;
    
 
    
     /*! \brief Input interface
      * \details Allows data plane to write received BGP messages into
-     *  m_ReceivingBuffer-fifo
+     *  m_ReceivingBuffer
      * \public
      */
-    sc_export<sc_fifo_out_if<BGPMessage> > export_ToControlPlane;
+    sc_export<Output_If<BGPMessageHandle> > export_ToControlPlane;
 
     sc_export<BGPSession_If> **export_Session;
    
@@ -81,7 +98,7 @@ public:
      * \details 
      * \public
      */
-    sc_export<Output_If<BGPMessage> > export_ToDataPlane;
+    sc_export<Output_If<BGPMessageHandle> > export_ToDataPlane;
 
     void before_end_of_elaboration()
     {
@@ -123,9 +140,15 @@ public:
     void controlPlaneMain(void);
 
     /*! \sa Output_If
+     * \details The message is moved to the data plane
      * \public
      */
-    virtual bool write(BGPMessage& p_BGPMsg);
+    virtual bool write(BGPMessageHandle& p_BGPMsg);
+
+    /*! \sa Output_If
+     * \public
+     */
+    virtual bool nb_write(BGPMessageHandle& p_BGPMsg);
 
     void killControlPlane(void);
 
@@ -135,6 +158,20 @@ public:
 
     bool isRunning(void);
 
+    /*! \brief Returns the counters of the messages sent to the peers
+     * \details The counters are kept over kills and revivals
+     * \public
+     */
+    const struct_MessageCounters& getMessageCounters(void);
+
+    /*! \brief Returns the duplicate statistics of the sessions
+     * \details Syntax: accepted,duplicates,restarts summed over the
+     * sessions
+     * \sa DuplicateFilter::getStatistics
+     * \public
+     */
+    string getDuplicateStatistics(void);
+
     /*! \brief Indicate the systemC producer that this module has a process.
      * \sa http://www.iro.umontreal.ca/~lablasso/docs/SystemC2.0.1/html/classproducer.html
      * \public
@@ -149,16 +186,18 @@ private:
 
     /*! \property sc_mutex mutex_Write 
      * \brief Handles the arbitration inside the write method
+     * \details Makes the sessions and the routing table a single
+     * producer of the forwarding buffer of the data plane
      * \private
      */
     sc_mutex mutex_Write;
 
     /*! \brief Receiving buffer
      * \details Data plain writes all the received BGP messages into
-     * this fifo
+     * this buffer
      * \private
      */
-    sc_fifo<BGPMessage> m_ReceivingBuffer;
+    SPSCChannel<BGPMessageHandle> m_ReceivingBuffer;
 
     // /*! \brief Number of BGP sessions
     //  * \details This defines how many BGP sessions there are in this router
@@ -171,12 +210,18 @@ private:
      * \private
      */
     BGPSession **m_BGPSessions;
+
+    /*! \brief The timer service of the sessions
+     * \details Runs the timers of all the sessions of the router
+     * \private
+     */
+    TimerService m_Timers;
     
     /*! \brief BGP input message
      * \details 
      * \private
      */
-    BGPMessage m_BGPMsgIn;
+    BGPMessageHandle m_BGPMsgIn;
 
 
     /*! \property ControlPlaneConfig *m_BGPConfig
@@ -196,10 +241,34 @@ private:
 
     unsigned long m_MsgId;
 
+    /*! \property unsigned long m_Epoch
+     * \brief The number of times the control plane has been killed
+     * \details Stamped on the messages with their ids
+     * \private
+     */
+    unsigned long m_Epoch;
+
+    /*! \property struct_MessageCounters m_Counters
+     * \brief Counters of the sent messages
+     * \private
+     */
+    struct_MessageCounters m_Counters;
+
     bool m_Up;
 
     sc_mutex m_UpMutex;
 
+    /*! \brief Waits for the next clock edge
+     * \details In the event-driven build the thread sleeps until a
+     * message is received
+     * \private
+     */
+    void waitForWork(void);
+
+    /*! \brief Counts a message written to the data plane
+     * \private
+     */
+    void countMessage(const BGPMessage& p_BGPMsg);
 
 };
 
@@ -9,20 +9,32 @@
 
 #include "DataPlane.hpp"
 #include "ReportGlobals.hpp"
+#include "ClockTick.hpp"
 
 
 
-DataPlane::DataPlane(sc_module_name p_ModuleName, ControlPlaneConfig * const p_Config):sc_module(p_ModuleName), m_Config(p_Config), m_Forwarder("-Forwarder"), m_OutputPort(-1)
+DataPlane::DataPlane(sc_module_name p_ModuleName, ControlPlaneConfig * const p_Config):sc_module(p_ModuleName), m_PacketPool(p_Config->getPacketPoolSize()), m_Config(p_Config), m_Forwarder("-Forwarder"), m_OutputPort(-1), m_FirstInterface(0)
 {
 	setUp(true);
+	m_Packet.setPacketPool(&m_PacketPool);
+	m_Forwarder.setPacketPool(&m_PacketPool);
 	m_Rpt.setBaseName(name());
 	m_InterfaceCount = m_Config->getNumberOfInterfaces();
+
+	//a burst holds up to m_BurstSize packets of each interface
+	m_BurstSize = m_Config->getBurstSize() > 0 ? m_Config->getBurstSize() : 1;
+	m_Burst.resize(m_BurstSize*m_InterfaceCount);
+	m_BurstInterface.resize(m_BurstSize*m_InterfaceCount);
+	m_BurstReady = new bool[m_BurstSize*m_InterfaceCount];
 	SC_THREAD(main);
+#ifndef _EVENT_DRIVEN
 	sensitive << port_Clk.pos();
+#endif
 }
 
 DataPlane::~DataPlane()
 {
+	delete[] m_BurstReady;
 
 }
 
@@ -38,79 +50,131 @@ void DataPlane::main(void)
 
 	while(true)
 	{
-		wait();
+		waitForWork();
 
 		if(!isRunning())
 			continue;
-		//check all the interfaces
-		for (int i = 0; i < m_InterfaceCount; i++)
-		{
 
-			if(port_FromInterface[i]->num_available() > 0)
-			{
+		//drain a burst from the interfaces
+		int l_Count = readBurst();
+		//the cached routes of an older generation are not used
+		unsigned long l_Generation = port_ToRoutingTable->getGeneration();
 
-				port_FromInterface[i]->read(m_Packet);
+		//validate the IP packets of the burst and update their TTLs
+		if(l_Count > 0)
+			m_Forwarder.forwardBurst(&m_Burst[0], l_Count, m_BurstReady);
 
-				if(m_Packet.getProtocolType() == TYPE_IP)
+		for (int k = 0; k < l_Count; k++)
+		{
+			if(m_Burst[k].getProtocolType() == TYPE_IP)
+			{
+				//forward only the valid packets whose TTL was not 0
+				if(m_BurstReady[k])
 				{
-
-
-					//Check that the packet is valid
-					if(m_Forwarder.processFrame(m_Packet))
+					//resolve route through the cache
+					unsigned l_Destination = m_Forwarder.getDestinationAddress(m_Burst[k]);
+					if(!m_RouteCache.lookup(l_Destination, l_Generation, m_OutputPort))
 					{
-						//update the TTL field and re-calculate the checksum
-						if(m_Forwarder.forward(&m_Packet))//forward only if TTL was not 0
-						{
-
-							//resolve route
-							m_OutputPort = port_ToRoutingTable->resolveRoute(m_Forwarder.getDestination());
-
-							//check that the route is found
-							if(m_OutputPort >= 0)
-
-								port_ToInterface[m_OutputPort]->write(m_Packet);
-						}
+						m_OutputPort = port_ToRoutingTable->resolveRoute(l_Destination);
+						m_RouteCache.insert(l_Destination, l_Generation, m_OutputPort);
 					}
 
-				}
-				else if (m_Packet.getProtocolType() == TYPE_BGP)
-				{
-					m_BGPMsg = m_Packet.getBGPPayload();
-					m_BGPMsg.m_OutboundInterface = i;
-
-					//cout << name() << ": received BGP message: Type " << m_BGPMsg.m_Type << " Interface " << m_BGPMsg.m_OutboundInterface << " @" << sc_time_stamp() << endl;
-					port_ToControlPlane->write(m_BGPMsg);
+					//check that the route is found
+					if(m_OutputPort >= 0)
+						port_ToInterface[m_OutputPort]->write(m_Burst[k]);
 				}
 			}
+			else if (m_Burst[k].getProtocolType() == TYPE_BGP)
+			{
+				//the packet is cleared below, so its message is moved
+				m_BGPMsg.reset(new BGPMessage(std::move(m_Burst[k].getBGPPayload())));
+				m_BGPMsg->m_OutboundInterface = m_BurstInterface[k];
 
+				port_ToControlPlane->write(m_BGPMsg);
+			}
+			//release the buffer of the packet
+			m_Burst[k].clearPacket();
+		}
 
-			if (m_BGPForwardingBuffer.num_available() > 0)
+		//send as many BGP messages as the interfaces can receive
+		for (int k = 0; k < m_BurstSize*m_InterfaceCount && m_BGPForwardingBuffer.nb_read(m_BGPMsg); k++)
+		{
+			int l_Interface = m_BGPMsg->m_OutboundInterface;
+			//the message is dropped if the packet pool is exhausted
+			if(m_Packet.setBGPPayload(std::move(*m_BGPMsg)))
 			{
-
-				//cout << name() << ":: num_available in session buffer: " << m_BGPForwardingBuffer.num_available() << endl;
-				// SC_REPORT_INFO(g_ReportID, m_Rpt.newReportString("Sending BGP message"));
-				m_BGPForwardingBuffer.read(m_BGPMsg);
-				//cout << name() << "    sending BGP message: AS " << m_BGPMsg.m_AS << " Interface " << m_BGPMsg.m_OutboundInterface << endl;
-				m_Packet.setBGPPayload(m_BGPMsg);
 				m_Packet.setProtocolType(TYPE_BGP);
-				port_ToInterface[m_BGPMsg.m_OutboundInterface]->write(m_Packet);
+				port_ToInterface[l_Interface]->write(m_Packet);
 			}
 		}
-		//Example how to resolve a route
-		//port_ToRoutingTable->resolveRoute(1);
+	}
+}
+
+int DataPlane::readBurst(void)
+{
+	int l_Count = 0;
 
+	//take one packet from each interface per round so that a busy
+	//interface cannot starve the others
+	for (int l_Round = 0; l_Round < m_BurstSize; l_Round++)
+	{
+		bool l_Read = false;
+		for (int i = 0; i < m_InterfaceCount; i++)
+		{
+			//the interface served first rotates between the clocks
+			int l_Interface = (m_FirstInterface + i) % m_InterfaceCount;
+			if(port_FromInterface[l_Interface]->nb_read(m_Burst[l_Count]))
+			{
+				m_BurstInterface[l_Count++] = l_Interface;
+				l_Read = true;
+			}
+		}
+		if(!l_Read)
+			break;
 	}
+
+	if(m_InterfaceCount > 0)
+		m_FirstInterface = (m_FirstInterface + 1) % m_InterfaceCount;
+	return l_Count;
+}
+
+void DataPlane::end_of_elaboration()
+{
+	for (int i = 0; i < m_InterfaceCount; i++)
+		m_WorkEvents |= port_FromInterface[i]->data_written_event();
+	m_WorkEvents |= m_BGPForwardingBuffer.data_written_event();
+}
+
+bool DataPlane::hasWork(void)
+{
+	if(m_BGPForwardingBuffer.num_available() > 0)
+		return true;
+	for (int i = 0; i < m_InterfaceCount; i++)
+		if(port_FromInterface[i]->num_available() > 0)
+			return true;
+	return false;
+}
+
+void DataPlane::waitForWork(void)
+{
+#ifdef _EVENT_DRIVEN
+	if(!hasWork())
+		wait(m_WorkEvents);
+	wait(timeToNextEdge(CLOCK_PERIOD));
+#else
+	wait();
+#endif
 }
 
 void DataPlane::killDataPlane(void)
 {
 	setUp(false);
 	m_Packet.clearPacket();
+	for (unsigned k = 0; k < m_Burst.size(); k++)
+		m_Burst[k].clearPacket();
 	m_OutputPort = -1;
-	while(m_BGPForwardingBuffer.num_available() > 0)
-		m_BGPForwardingBuffer.read(m_BGPMsg);
-
-	m_BGPMsg.clearMessage();
+	m_BGPForwardingBuffer.clear();
+	m_BGPMsg.reset();
 
 
 }
@@ -121,6 +185,21 @@ void DataPlane::reviveDataPlane(void)
 	setUp(true);
 }
 
+string DataPlane::getRouteCacheStatistics(void)
+{
+	return m_RouteCache.getStatistics();
+}
+
+string DataPlane::getPacketPoolStatistics(void)
+{
+	return m_PacketPool.getStatistics();
+}
+
+unsigned long DataPlane::getPacketPoolMemory(void)
+{
+	return m_PacketPool.getMemoryUsage();
+}
+
 void DataPlane::setUp(bool p_Value)
 {
 	m_UpMutex.lock();
@@ -138,14 +217,16 @@ bool DataPlane::isRunning(void)
 
 }
 
-bool DataPlane::write(BGPMessage& p_BGPMsg)
+bool DataPlane::write(BGPMessageHandle& p_BGPMsg)
 {
-	//enter to the critical region
-	m_BGPForwardingBufferMutex.lock();
-	//write the message to the buffer
+	//move the message to the buffer, the Control Plane holds its
+	//write mutex
 	if(isRunning())
 		m_BGPForwardingBuffer.write(p_BGPMsg);
-	//exit from the critical region
-	m_BGPForwardingBufferMutex.unlock();
 	return true;
 }
+
+bool DataPlane::nb_write(BGPMessageHandle& p_BGPMsg)
+{
+	return !isRunning() || m_BGPForwardingBuffer.nb_write(p_BGPMsg);
+}
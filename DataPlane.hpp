@@ -19,10 +19,14 @@
 #include "Packet.hpp"
 #include "BGPMessage.hpp"
 #include "Output_If.hpp"
+#include "SPSCChannel.hpp"
+#include "Input_If.hpp"
 #include "RoutingTable_If.hpp"
 #include "Configuration.hpp"
 #include "StringTools.hpp"
 #include "PacketProcessor.hpp"
+#include "RouteCache.hpp"
+#include <vector>
 
 using namespace std;
 using namespace sc_core;
@@ -34,7 +38,7 @@ using namespace sc_dt;
 
 
 
-class DataPlane: public sc_module, public Output_If<BGPMessage>
+class DataPlane: public sc_module, public Output_If<BGPMessageHandle>
 {
 
 public:
@@ -51,16 +55,16 @@ public:
     /*! \brief Output port for BGP messages
      * \details Data Plane writes all the received BGP messages into
      * this port. The port shall be bind to the Control Plane's
-     * receiving FIFO
+     * receiving buffer
      * \public
      */
-    sc_port<sc_fifo_out_if<BGPMessage>,1, SC_ZERO_OR_MORE_BOUND> port_ToControlPlane;
+    sc_port<Output_If<BGPMessageHandle>,1, SC_ZERO_OR_MORE_BOUND> port_ToControlPlane;
 
     /*! \brief Neighbor writes to the receiving buffer
      * \details
      * \public
      */
-    sc_port<sc_fifo_in_if<Packet>,0, SC_ZERO_OR_MORE_BOUND> port_FromInterface;
+    sc_port<Input_If<Packet>,0, SC_ZERO_OR_MORE_BOUND> port_FromInterface;
 
     /*! \brief Forward to the neighbor
      * \details
@@ -68,11 +72,13 @@ public:
      */
     sc_port<Output_If<Packet>,0, SC_ZERO_OR_MORE_BOUND> port_ToInterface;
 
+#ifndef _EVENT_DRIVEN
     /*! \brief Clock signal
      * \details 
      * \public
      */
     sc_in_clk port_Clk;
+#endif
 
     /*!
      * \brief Constructor
@@ -86,8 +92,22 @@ public:
 
     void main(void);
 
+    /*! \fn int readBurst(void)
+     * \brief Reads up to m_BurstSize packets from each interface into
+     * m_Burst
+     * \details The interfaces are served in turns one packet at a time
+     * \return int: the number of packets read
+     * \public
+     */
+    int readBurst(void);
+
 
-    virtual bool write(BGPMessage& p_BGPMsg);
+    virtual bool write(BGPMessageHandle& p_BGPMsg);
+
+    /*! \sa Output_If
+     * \public
+     */
+    virtual bool nb_write(BGPMessageHandle& p_BGPMsg);
 
     void killDataPlane(void);
 
@@ -97,6 +117,26 @@ public:
 
     void reviveDataPlane(void);
 
+    /*! \fn string getPacketPoolStatistics(void)
+     * \brief Returns the statistics of the packet pool of the router
+     * \details Syntax: size,in_use,high_water_mark,drops,allocated
+     * \public
+     */
+    string getPacketPoolStatistics(void);
+
+    /*! \fn unsigned long getPacketPoolMemory(void)
+     * \brief Returns the bytes of the buffers allocated by the packet pool
+     * \public
+     */
+    unsigned long getPacketPoolMemory(void);
+
+    /*! \fn string getRouteCacheStatistics(void)
+     * \brief Returns the statistics of the route cache
+     * \details Syntax: size,hits,misses
+     * \public
+     */
+    string getRouteCacheStatistics(void);
+
 
     /*! \brief Indicate the systemC producer that this module has a process.
      * \sa http://www.iro.umontreal.ca/~lablasso/docs/SystemC2.0.1/html/classproducer.html
@@ -104,17 +144,36 @@ public:
      */
     SC_HAS_PROCESS(DataPlane);
 
-private:
+    /*! \brief Collects the events that wake up the event-driven thread
+     * \details The data_written events of the interfaces and of the
+     * BGP forwarding buffer
+     * \public
+     */
+    void end_of_elaboration();
 
-    sc_mutex m_BGPForwardingBufferMutex;
+private:
 
-    sc_fifo<BGPMessage> m_BGPForwardingBuffer;
+    /*! \property SPSCChannel<BGPMessageHandle> m_BGPForwardingBuffer
+     * \brief The messages to be sent
+     * \details The Control Plane is the only writer, it arbitrates
+     * between the sessions and the routing table
+     * \private
+     */
+    SPSCChannel<BGPMessageHandle> m_BGPForwardingBuffer;
 
     int m_InterfaceCount;
+
+    /*! \property PacketPool m_PacketPool
+     * \brief The buffers of the packets sent by this router
+     * \details Declared before the packets so that it is destroyed
+     * after them
+     * \private
+     */
+    PacketPool m_PacketPool;
   
     Packet m_Packet;
 
-    BGPMessage m_BGPMsg;
+    BGPMessageHandle m_BGPMsg;
 	
 	ControlPlaneConfig *m_Config;
 
@@ -122,11 +181,67 @@ private:
 
     PacketProcessor m_Forwarder;
 
+    /*! \property RouteCache m_RouteCache
+     * \brief Caches the output ports of the recent destinations
+     * \private
+     */
+    RouteCache m_RouteCache;
+
     bool m_Up;
 
     sc_mutex m_UpMutex;
 
     int m_OutputPort;
+
+    /*! \property int m_BurstSize
+     * \brief The maximum number of packets read per interface per clock
+     * \private
+     */
+    int m_BurstSize;
+
+    /*! \property vector<Packet> m_Burst
+     * \brief The packets read during the current clock
+     * \private
+     */
+    vector<Packet> m_Burst;
+
+    /*! \property vector<int> m_BurstInterface
+     * \brief The receiving interface of each packet in m_Burst
+     * \private
+     */
+    vector<int> m_BurstInterface;
+
+    /*! \property bool *m_BurstReady
+     * \brief Indicates the packets of m_Burst to be forwarded
+     * \private
+     */
+    bool *m_BurstReady;
+
+    /*! \property int m_FirstInterface
+     * \brief The interface served first during the next clock
+     * \private
+     */
+    int m_FirstInterface;
+
+    /*! \property sc_event_or_list m_WorkEvents
+     * \brief Any of these wakes up the thread in the event-driven build
+     * \private
+     */
+    sc_event_or_list m_WorkEvents;
+
+    /*! \fn bool hasWork(void)
+     * \brief Checks if a packet or a BGP message is waiting
+     * \private
+     */
+    bool hasWork(void);
+
+    /*! \fn void waitForWork(void)
+     * \brief Waits for the next clock edge
+     * \details In the event-driven build the thread sleeps until there
+     * is something to forward
+     * \private
+     */
+    void waitForWork(void);
 };
 
 
@@ -0,0 +1,96 @@
+/*! \file DuplicateFilter.cpp
+ *  \brief     Implementation of DuplicateFilter class.
+ *  \details
+ */
+
+
+#include "DuplicateFilter.hpp"
+#include <sstream>
+
+
+DuplicateFilter::DuplicateFilter(void):m_Epoch(0), m_Highest(0), m_Window(0), m_Accepted(0), m_Duplicates(0), m_Restarts(0)
+{
+}
+
+/*! \sa DuplicateFilter
+ */
+bool DuplicateFilter::accept(unsigned long p_Epoch, unsigned long p_MsgId)
+{
+    ///a message sent before the peer was last revived
+    if(p_Epoch < m_Epoch)
+        {
+            m_Duplicates++;
+            return false;
+        }
+
+    ///the peer has been revived and numbers its messages from 1 again
+    if(p_Epoch > m_Epoch)
+        {
+            m_Restarts++;
+            m_Epoch = p_Epoch;
+            m_Window = 1;
+            m_Highest = p_MsgId;
+            m_Accepted++;
+            return true;
+        }
+
+    ///a newer id slides the window
+    if(p_MsgId > m_Highest)
+        {
+            unsigned long l_Shift = p_MsgId - m_Highest;
+            m_Window = l_Shift < DUPLICATE_WINDOW ? (m_Window << l_Shift) | 1 : 1;
+            m_Highest = p_MsgId;
+            m_Accepted++;
+            return true;
+        }
+
+    ///an id older than the window is a late copy, and an id inside it
+    ///is a duplicate if its bit is set
+    unsigned long l_Age = m_Highest - p_MsgId;
+    if(l_Age >= DUPLICATE_WINDOW || (m_Window & ((uint64_t)1 << l_Age)))
+        {
+            m_Duplicates++;
+            return false;
+        }
+    m_Window |= (uint64_t)1 << l_Age;
+    m_Accepted++;
+    return true;
+}
+
+/*! \sa DuplicateFilter
+ */
+void DuplicateFilter::reset(void)
+{
+    m_Highest = 0;
+    m_Window = 0;
+}
+
+/*! \sa DuplicateFilter
+ */
+unsigned long DuplicateFilter::getAccepted(void)
+{
+    return m_Accepted;
+}
+
+/*! \sa DuplicateFilter
+ */
+unsigned long DuplicateFilter::getDuplicates(void)
+{
+    return m_Duplicates;
+}
+
+/*! \sa DuplicateFilter
+ */
+unsigned long DuplicateFilter::getRestarts(void)
+{
+    return m_Restarts;
+}
+
+/*! \sa DuplicateFilter
+ */
+string DuplicateFilter::getStatistics(void)
+{
+    ostringstream l_Stats;
+    l_Stats << m_Accepted << "," << m_Duplicates << "," << m_Restarts;
+    return l_Stats.str();
+}
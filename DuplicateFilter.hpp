@@ -0,0 +1,108 @@
+/*! \file  DuplicateFilter.hpp
+ *  \brief     Header file of DuplicateFilter class
+ *  \details   Defines the duplicate detection of the received BGP
+ *  messages
+ */
+
+/*!
+ * \class DuplicateFilter
+ * \brief Sliding window of the message ids received from a peer
+ *  \details The control plane of the peer numbers its messages in
+ *  increasing order within an epoch, and starts a new epoch with the
+ *  ids from 1 each time it is revived. The filter keeps the epoch and
+ *  the highest id accepted and a bitmap of the DUPLICATE_WINDOW ids
+ *  below it, so a message is checked with a shift and a mask whatever
+ *  its content. A newer epoch restarts the window. A message of an
+ *  older epoch, or older than the window, is a late copy and is
+ *  rejected as a duplicate.
+ */
+
+
+#include <stdint.h>
+#include <string>
+
+using namespace std;
+
+
+#ifndef _DUPLICATEFILTER_H_
+#define _DUPLICATEFILTER_H_
+
+/*!
+ * The number of ids in the window, the bits of the bitmap
+ */
+#define DUPLICATE_WINDOW 64
+
+
+class DuplicateFilter
+{
+
+public:
+
+    DuplicateFilter(void);
+
+    /*! \fn bool accept(unsigned long p_Epoch, unsigned long p_MsgId)
+     * \brief Checks the id of a received message and records it
+     * @param [in] unsigned long p_Epoch The epoch of the sender
+     * @param [in] unsigned long p_MsgId The id of the message
+     * \return bool: false if the message is a duplicate
+     * \public
+     */
+    bool accept(unsigned long p_Epoch, unsigned long p_MsgId);
+
+    /*! \fn void reset(void)
+     * \brief Forgets the received ids
+     * \details Called when the session goes down. The epoch and the
+     * statistics are kept, so only the copies of the messages of older
+     * epochs are still rejected. Any id of the current epoch is
+     * accepted again, including a late copy of a message accepted
+     * before the reset.
+     * \public
+     */
+    void reset(void);
+
+    unsigned long getAccepted(void);
+
+    unsigned long getDuplicates(void);
+
+    unsigned long getRestarts(void);
+
+    /*! \fn string getStatistics(void)
+     * \brief Returns the statistics of the filter
+     * \details Syntax: accepted,duplicates,restarts
+     * \public
+     */
+    string getStatistics(void);
+
+private:
+
+    /*! \property unsigned long m_Epoch
+     * \brief The newest epoch of the peer seen
+     * \private
+     */
+    unsigned long m_Epoch;
+
+    /*! \property unsigned long m_Highest
+     * \brief The highest id accepted, 0 if none
+     * \private
+     */
+    unsigned long m_Highest;
+
+    /*! \property uint64_t m_Window
+     * \brief Bit n is set if the id m_Highest - n has been accepted
+     * \private
+     */
+    uint64_t m_Window;
+
+    unsigned long m_Accepted;
+
+    unsigned long m_Duplicates;
+
+    /*! \property unsigned long m_Restarts
+     * \brief The number of new epochs of the peer seen
+     * \private
+     */
+    unsigned long m_Restarts;
+};
+
+
+#endif /* _DUPLICATEFILTER_H_ */
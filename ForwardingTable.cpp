@@ -0,0 +1,306 @@
+/*! \file ForwardingTable.cpp
+ *  \brief     Implementation of ForwardingTable class.
+ *  \details
+ */
+
+
+#include "ForwardingTable.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+
+
+ForwardingTable::ForwardingTable(void):m_Tbl24(NULL), m_LookupCount(0), m_RebuildTime(0)
+{
+}
+
+ForwardingTable::~ForwardingTable(void)
+{
+    free(m_Tbl24);
+}
+
+/*! \sa ForwardingTable
+ */
+void ForwardingTable::setRoute(unsigned p_Prefix, int p_Length, int p_OutputPort)
+{
+    clock_t l_Start = clock();
+    unsigned l_Prefix = LPMTrie<int>::maskPrefix(p_Prefix, p_Length);
+
+    bool l_New = m_Routes.find(l_Prefix, p_Length) == NULL;
+    m_Routes.insert(l_Prefix, p_Length, p_OutputPort);
+
+    //the route is only stored until the first lookup compiles the table
+    if(m_Tbl24 != NULL)
+    {
+        if(l_New)
+            compileRoute(l_Prefix, p_Length);
+        else
+            recompute(l_Prefix, p_Length);
+    }
+    m_RebuildTime += (double)(clock() - l_Start)/CLOCKS_PER_SEC;
+}
+
+/*! \sa ForwardingTable
+ */
+void ForwardingTable::removeRoute(unsigned p_Prefix, int p_Length)
+{
+    clock_t l_Start = clock();
+    unsigned l_Prefix = LPMTrie<int>::maskPrefix(p_Prefix, p_Length);
+
+    if(!m_Routes.remove(l_Prefix, p_Length) || m_Tbl24 == NULL)
+        return;
+
+    recompute(l_Prefix, p_Length);
+
+    //release the group if this was its last long prefix
+    if(p_Length > FIB_TBL24_BITS)
+    {
+        unsigned l_Index = l_Prefix >> (32 - FIB_TBL24_BITS);
+        if(m_Tbl24[l_Index] == FIB_TRIE_ENTRY)
+        {
+            if(--m_TrieBlocks[l_Index] == 0)
+            {
+                m_TrieBlocks.erase(l_Index);
+                m_Tbl24[l_Index] = resolveEntry(l_Index << (32 - FIB_TBL24_BITS));
+            }
+        }
+        else
+        {
+            int l_Group = m_Tbl24[l_Index] & ~FIB_GROUP_FLAG;
+            if(--m_GroupUsers[l_Group] == 0)
+                releaseGroup(l_Index);
+        }
+    }
+    m_RebuildTime += (double)(clock() - l_Start)/CLOCKS_PER_SEC;
+}
+
+/*! \sa ForwardingTable
+ */
+void ForwardingTable::clear(void)
+{
+    free(m_Tbl24);
+    m_Tbl24 = NULL;
+    m_Tbl8.clear();
+    m_GroupUsers.clear();
+    m_FreeGroups.clear();
+    m_TrieBlocks.clear();
+    m_Routes.clear();
+}
+
+/*! \sa ForwardingTable
+ */
+bool ForwardingTable::compile(void)
+{
+    if(m_Routes.size() == 0)
+        return false;
+
+    clock_t l_Start = clock();
+    m_Tbl24 = (unsigned short *)calloc(1 << FIB_TBL24_BITS, sizeof(unsigned short));
+
+    RouteCompiler l_Groups = {this, true};
+    m_Routes.visit(l_Groups);
+    RouteCompiler l_Entries = {this, false};
+    m_Routes.visit(l_Entries);
+    m_RebuildTime += (double)(clock() - l_Start)/CLOCKS_PER_SEC;
+    return true;
+}
+
+/*! \sa ForwardingTable
+ */
+void ForwardingTable::compileRoute(unsigned p_Prefix, int p_Length)
+{
+    //a prefix longer than the first level needs a group
+    if(p_Length > FIB_TBL24_BITS)
+        acquireGroup(p_Prefix);
+
+    recompute(p_Prefix, p_Length);
+}
+
+/*! \sa ForwardingTable
+ */
+void ForwardingTable::acquireGroup(unsigned p_Prefix)
+{
+    unsigned l_Index = p_Prefix >> (32 - FIB_TBL24_BITS);
+    if(m_Tbl24[l_Index] == FIB_TRIE_ENTRY)
+    {
+        m_TrieBlocks[l_Index]++;
+        return;
+    }
+
+    int l_Group;
+    if(m_Tbl24[l_Index] & FIB_GROUP_FLAG)
+        l_Group = m_Tbl24[l_Index] & ~FIB_GROUP_FLAG;
+    else
+        l_Group = allocateGroup(l_Index);
+
+    //no group was left for the block
+    if(l_Group < 0)
+        m_TrieBlocks[l_Index]++;
+    else
+        m_GroupUsers[l_Group]++;
+}
+
+/*! \sa ForwardingTable
+ */
+void ForwardingTable::recompute(unsigned p_Prefix, int p_Length)
+{
+    if(p_Length > FIB_TBL24_BITS)
+    {
+        //only a part of one group is covered
+        unsigned l_Index = p_Prefix >> (32 - FIB_TBL24_BITS);
+        if(m_Tbl24[l_Index] == FIB_TRIE_ENTRY)
+            return;
+        unsigned l_Base = (m_Tbl24[l_Index] & ~FIB_GROUP_FLAG) * FIB_TBL8_SIZE;
+        unsigned l_First = p_Prefix & (FIB_TBL8_SIZE-1);
+        unsigned l_Count = 1u << (32 - p_Length);
+
+        for (unsigned j = l_First; j < l_First + l_Count; j++)
+            m_Tbl8[l_Base + j] = resolveEntry((p_Prefix & ~(FIB_TBL8_SIZE-1)) | j);
+        return;
+    }
+
+    //a range of first level entries is covered
+    unsigned l_First = p_Prefix >> (32 - FIB_TBL24_BITS);
+    unsigned l_Count = 1u << (FIB_TBL24_BITS - p_Length);
+
+    for (unsigned i = l_First; i < l_First + l_Count; i++)
+    {
+        if(m_Tbl24[i] == FIB_TRIE_ENTRY)
+            continue;
+        if(m_Tbl24[i] & FIB_GROUP_FLAG)
+        {
+            //the group holds longer prefixes: resolve each of its entries
+            unsigned l_Base = (m_Tbl24[i] & ~FIB_GROUP_FLAG) * FIB_TBL8_SIZE;
+            for (unsigned j = 0; j < FIB_TBL8_SIZE; j++)
+                m_Tbl8[l_Base + j] = resolveEntry((i << (32 - FIB_TBL24_BITS)) | j);
+        }
+        else
+            m_Tbl24[i] = resolveEntry(i << (32 - FIB_TBL24_BITS));
+    }
+}
+
+/*! \sa ForwardingTable
+ */
+void ForwardingTable::fill(unsigned p_Prefix, int p_Length, int p_OutputPort)
+{
+    unsigned short l_Entry = p_OutputPort < 0 ? FIB_NO_ROUTE : (unsigned short)(p_OutputPort + 1);
+
+    if(p_Length > FIB_TBL24_BITS)
+    {
+        unsigned l_Index = p_Prefix >> (32 - FIB_TBL24_BITS);
+        if(m_Tbl24[l_Index] == FIB_TRIE_ENTRY)
+            return;
+        unsigned l_First = ((m_Tbl24[l_Index] & ~FIB_GROUP_FLAG) * FIB_TBL8_SIZE) + (p_Prefix & (FIB_TBL8_SIZE-1));
+        fill_n(m_Tbl8.begin() + l_First, 1u << (32 - p_Length), l_Entry);
+        return;
+    }
+
+    unsigned l_First = p_Prefix >> (32 - FIB_TBL24_BITS);
+    unsigned l_Count = 1u << (FIB_TBL24_BITS - p_Length);
+
+    for (unsigned i = l_First; i < l_First + l_Count; i++)
+    {
+        if(m_Tbl24[i] == FIB_TRIE_ENTRY)
+            continue;
+        if(m_Tbl24[i] & FIB_GROUP_FLAG)
+            fill_n(m_Tbl8.begin() + (m_Tbl24[i] & ~FIB_GROUP_FLAG) * FIB_TBL8_SIZE, FIB_TBL8_SIZE, l_Entry);
+        else
+            m_Tbl24[i] = l_Entry;
+    }
+}
+
+/*! \sa ForwardingTable
+ */
+int ForwardingTable::lookupTrie(unsigned p_Address)
+{
+    int l_Port;
+    if(!m_Routes.lookup(p_Address, l_Port) || l_Port < 0)
+        return -1;
+    return l_Port;
+}
+
+/*! \sa ForwardingTable
+ */
+unsigned short ForwardingTable::resolveEntry(unsigned p_Address)
+{
+    int l_Port;
+    if(!m_Routes.lookup(p_Address, l_Port) || l_Port < 0)
+        return FIB_NO_ROUTE;
+    //store the port off by one so that zero means no route
+    return (unsigned short)(l_Port + 1);
+}
+
+/*! \sa ForwardingTable
+ */
+int ForwardingTable::allocateGroup(unsigned p_Index)
+{
+    int l_Group;
+    if(m_FreeGroups.empty())
+    {
+        //the index would not fit into the entry
+        if(m_GroupUsers.size() >= FIB_MAX_GROUPS)
+        {
+            m_Tbl24[p_Index] = FIB_TRIE_ENTRY;
+            return -1;
+        }
+        l_Group = m_GroupUsers.size();
+        m_GroupUsers.push_back(0);
+        m_Tbl8.resize(m_Tbl8.size() + FIB_TBL8_SIZE);
+    }
+    else
+    {
+        l_Group = m_FreeGroups.back();
+        m_FreeGroups.pop_back();
+        m_GroupUsers[l_Group] = 0;
+    }
+
+    //the whole /24 block had the same port so far
+    unsigned short l_Entry = m_Tbl24[p_Index];
+    for (unsigned j = 0; j < FIB_TBL8_SIZE; j++)
+        m_Tbl8[l_Group * FIB_TBL8_SIZE + j] = l_Entry;
+
+    m_Tbl24[p_Index] = FIB_GROUP_FLAG | l_Group;
+    return l_Group;
+}
+
+/*! \sa ForwardingTable
+ */
+void ForwardingTable::releaseGroup(unsigned p_Index)
+{
+    m_FreeGroups.push_back(m_Tbl24[p_Index] & ~FIB_GROUP_FLAG);
+    m_Tbl24[p_Index] = resolveEntry(p_Index << (32 - FIB_TBL24_BITS));
+}
+
+/*! \sa ForwardingTable
+ */
+unsigned long ForwardingTable::getMemoryUsage(void)
+{
+    unsigned long l_Bytes = m_Tbl8.capacity() * sizeof(unsigned short);
+    if(m_Tbl24 != NULL)
+        l_Bytes += (1ul << FIB_TBL24_BITS) * sizeof(unsigned short);
+    return l_Bytes;
+}
+
+/*! \sa ForwardingTable
+ */
+double ForwardingTable::getRebuildTime(void)
+{
+    return m_RebuildTime;
+}
+
+/*! \sa ForwardingTable
+ */
+unsigned long ForwardingTable::getLookupCount(void)
+{
+    return m_LookupCount;
+}
+
+/*! \sa ForwardingTable
+ */
+string ForwardingTable::getStatistics(void)
+{
+    ostringstream l_Stats;
+    l_Stats << m_Routes.size() << "," << (m_GroupUsers.size() - m_FreeGroups.size()) << "," << getMemoryUsage() << "," << m_RebuildTime << "," << m_LookupCount << "," << m_TrieBlocks.size();
+    return l_Stats.str();
+}
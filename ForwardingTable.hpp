@@ -0,0 +1,297 @@
+/*! \file  ForwardingTable.hpp
+ *  \brief     Header file of ForwardingTable class
+ *  \details   Defines the forwarding information base (FIB) of the
+ *  data plane
+ */
+
+/*!
+ * \class ForwardingTable
+ * \brief DIR-24-8 forwarding table
+ *  \details Maps destination addresses to output ports with at most
+ *  two memory accesses. The first level is indexed directly by the
+ *  24 high order bits of the address. An entry of the first level
+ *  holds either the output port or, if the /24 block contains longer
+ *  prefixes, the index of a 256 entry second level group indexed by
+ *  the low order octet.
+ *
+ *  The table is compiled from the best routes of the routing table.
+ *  Until the first lookup the routes are only stored, so a router
+ *  that forwards no data traffic has no table. The first lookup
+ *  compiles all the stored routes. After that setRoute and
+ *  removeRoute recompute only the entries covered by the changed
+ *  prefix. The first level is allocated with calloc, so the operating
+ *  system commits only the pages that routes actually touch.
+ *
+ *  The group index is packed into the 15 low bits of a first level
+ *  entry, so there are at most FIB_MAX_GROUPS groups. When they are
+ *  used up, a /24 block that needs a group is marked with
+ *  FIB_TRIE_ENTRY instead, and its addresses are looked up in the trie
+ *  of the routes.
+ */
+
+
+#include <map>
+#include <vector>
+#include <string>
+#include "LPMTrie.hpp"
+
+using namespace std;
+
+
+#ifndef _FORWARDINGTABLE_H_
+#define _FORWARDINGTABLE_H_
+
+/*!
+ *The number of address bits used to index the first level
+ */
+#define FIB_TBL24_BITS 24
+
+/*!
+ *The number of entries in a second level group
+ */
+#define FIB_TBL8_SIZE 256
+
+/*!
+ *Marks a first level entry that points to a second level group
+ */
+#define FIB_GROUP_FLAG 0x8000
+
+/*!
+ *The number of second level groups that the first level can address.
+ *The last group index is reserved for FIB_TRIE_ENTRY.
+ */
+#define FIB_MAX_GROUPS 0x7FFF
+
+/*!
+ *Marks a first level entry whose addresses are looked up in the trie
+ */
+#define FIB_TRIE_ENTRY 0xFFFF
+
+/*!
+ *Entry value of an address without route
+ */
+#define FIB_NO_ROUTE 0
+
+
+class ForwardingTable
+{
+
+public:
+
+    ForwardingTable(void);
+
+    ~ForwardingTable(void);
+
+    /*! \fn void setRoute(unsigned p_Prefix, int p_Length, int p_OutputPort)
+     * \brief Adds or replaces the best route of the given prefix
+     * \details Recomputes the entries covered by the prefix
+     * @param [in] unsigned p_Prefix The prefix in host byte order
+     * @param [in] int p_Length The prefix length 0-32
+     * @param [in] int p_OutputPort The output port of the route
+     * \public
+     */
+    void setRoute(unsigned p_Prefix, int p_Length, int p_OutputPort);
+
+    /*! \fn void removeRoute(unsigned p_Prefix, int p_Length)
+     * \brief Removes the route of the given prefix
+     * \details The covered entries fall back to the next less
+     * specific route
+     * @param [in] unsigned p_Prefix The prefix in host byte order
+     * @param [in] int p_Length The prefix length 0-32
+     * \public
+     */
+    void removeRoute(unsigned p_Prefix, int p_Length);
+
+    /*! \fn void clear(void)
+     * \brief Removes all the routes
+     * \public
+     */
+    void clear(void);
+
+    /*! \fn int lookup(unsigned p_Address)
+     * \brief Returns the output port for the destination address
+     * \details The first lookup compiles the table
+     * @param [in] unsigned p_Address The destination in host byte order
+     * \return int: the output port or -1 if there is no route
+     * \public
+     */
+    inline int lookup(unsigned p_Address)
+    {
+        m_LookupCount++;
+        if(m_Tbl24 == NULL && !compile())
+            return -1;
+
+        unsigned short l_Entry = m_Tbl24[p_Address >> (32 - FIB_TBL24_BITS)];
+        if(l_Entry & FIB_GROUP_FLAG)
+        {
+            if(l_Entry == FIB_TRIE_ENTRY)
+                return lookupTrie(p_Address);
+            l_Entry = m_Tbl8[((l_Entry & ~FIB_GROUP_FLAG) * FIB_TBL8_SIZE) + (p_Address & (FIB_TBL8_SIZE-1))];
+        }
+        return (int)l_Entry - 1;
+    };
+
+    /*! \fn unsigned long getMemoryUsage(void)
+     * \brief Returns the size of both table levels in bytes
+     * \details 0 until the table is compiled
+     * \public
+     */
+    unsigned long getMemoryUsage(void);
+
+    /*! \fn double getRebuildTime(void)
+     * \brief Returns the processor time spent in table updates in seconds
+     * \public
+     */
+    double getRebuildTime(void);
+
+    /*! \fn unsigned long getLookupCount(void)
+     * \brief Returns the number of lookups done since the table was created
+     * \public
+     */
+    unsigned long getLookupCount(void);
+
+    /*! \fn string getStatistics(void)
+     * \brief Returns the table statistics as a string
+     * \details Syntax: routes,groups,memory_bytes,rebuild_seconds,lookups,trie_blocks
+     * where trie_blocks is the number of /24 blocks looked up in the
+     * trie for the lack of groups
+     * \public
+     */
+    string getStatistics(void);
+
+private:
+
+    /*! \property unsigned short *m_Tbl24
+     * \brief First level table indexed by the 24 high order address bits
+     * \private
+     */
+    unsigned short *m_Tbl24;
+
+    /*! \property vector<unsigned short> m_Tbl8
+     * \brief Second level groups stored back to back
+     * \private
+     */
+    vector<unsigned short> m_Tbl8;
+
+    /*! \property vector<int> m_GroupUsers
+     * \brief Number of prefixes longer than 24 bits in each group
+     * \details A group is released when its count drops to zero
+     * \private
+     */
+    vector<int> m_GroupUsers;
+
+    /*! \property vector<int> m_FreeGroups
+     * \brief Indices of released groups
+     * \private
+     */
+    vector<int> m_FreeGroups;
+
+    /*! \property map<unsigned, int> m_TrieBlocks
+     * \brief Number of prefixes longer than 24 bits in each first level
+     * entry marked with FIB_TRIE_ENTRY
+     * \private
+     */
+    map<unsigned, int> m_TrieBlocks;
+
+    /*! \property LPMTrie<int> m_Routes
+     * \brief The compiled routes
+     * \details Used to resolve the covered entries when a route changes
+     * \private
+     */
+    LPMTrie<int> m_Routes;
+
+    unsigned long m_LookupCount;
+
+    double m_RebuildTime;
+
+    /*! \fn bool compile(void)
+     * \brief Allocates the first level and compiles the stored routes
+     * \return bool: false if there are no routes to compile
+     * \private
+     */
+    bool compile(void);
+
+    /*! \fn void compileRoute(unsigned p_Prefix, int p_Length)
+     * \brief Adds a new route to the compiled table
+     * \private
+     */
+    void compileRoute(unsigned p_Prefix, int p_Length);
+
+    /*! \fn void acquireGroup(unsigned p_Prefix)
+     * \brief Adds a prefix longer than the first level to the group
+     * of its first level entry
+     * \details The group is allocated if the entry has none
+     * \private
+     */
+    void acquireGroup(unsigned p_Prefix);
+
+    /*! \fn void fill(unsigned p_Prefix, int p_Length, int p_OutputPort)
+     * \brief Writes the port of a route into all the entries it covers
+     * \details Used when the routes are compiled from the shortest to
+     * the longest, so that the more specific ones overwrite it later
+     * \private
+     */
+    void fill(unsigned p_Prefix, int p_Length, int p_OutputPort);
+
+    /*! \brief Compiles the routes visited in m_Routes
+     * \details The first pass gives a group to every first level
+     * entry that holds longer prefixes. The second pass fills the
+     * entries of each route, and as the trie is visited in pre-order,
+     * every route is filled before the routes it covers.
+     * \private
+     */
+    struct RouteCompiler
+    {
+        ForwardingTable *table;
+        bool groups;
+
+        void operator()(unsigned p_Prefix, int p_Length, int p_OutputPort)
+        {
+            if(!groups)
+                table->fill(p_Prefix, p_Length, p_OutputPort);
+            else if(p_Length > FIB_TBL24_BITS)
+                table->acquireGroup(p_Prefix);
+        };
+    };
+
+    /*! \fn void recompute(unsigned p_Prefix, int p_Length)
+     * \brief Rewrites all the entries covered by the prefix
+     * \private
+     */
+    void recompute(unsigned p_Prefix, int p_Length);
+
+    /*! \fn int lookupTrie(unsigned p_Address)
+     * \brief Looks the address up in the trie of the routes
+     * \return int: the output port or -1 if there is no route
+     * \private
+     */
+    int lookupTrie(unsigned p_Address);
+
+    /*! \fn unsigned short resolveEntry(unsigned p_Address)
+     * \brief Returns the table entry value for the address
+     * \private
+     */
+    unsigned short resolveEntry(unsigned p_Address);
+
+    /*! \fn int allocateGroup(unsigned p_Index)
+     * \brief Moves the first level entry p_Index into a new group
+     * \details When all the groups are in use, the entry is marked
+     * with FIB_TRIE_ENTRY instead
+     * \return int: the group index or -1 if there was none left
+     * \private
+     */
+    int allocateGroup(unsigned p_Index);
+
+    /*! \fn void releaseGroup(unsigned p_Index)
+     * \brief Collapses the group of the first level entry p_Index
+     * \private
+     */
+    void releaseGroup(unsigned p_Index);
+
+    //the table owns its buffers
+    ForwardingTable(const ForwardingTable&);
+    ForwardingTable& operator = (const ForwardingTable&);
+};
+
+
+#endif /* _FORWARDINGTABLE_H_ */
@@ -9,9 +9,11 @@
 
 #include "Host.hpp"
 #include "ReportGlobals.hpp"
+#include "ClockTick.hpp"
 
-Host::Host(sc_module_name p_ModuleName, Connection *p_ConnectionConfig):sc_module(p_ModuleName), m_Encoder("Encoder"), m_Decoder("Decoder"), m_MsgBuffer(START)
+Host::Host(sc_module_name p_ModuleName, Connection *p_ConnectionConfig):sc_module(p_ModuleName), m_PacketPool(PACKET_POOL_BUFFERS_PER_INTERFACE), m_Encoder("Encoder"), m_Decoder("Decoder"), m_MsgBuffer(START)
 {
+	m_Encoder.setPacketPool(&m_PacketPool);
 	///StringTools instance for reporting
 	StringTools *l_Report = new StringTools(name());
 	l_Report->resetReportString();
@@ -21,11 +23,13 @@ Host::Host(sc_module_name p_ModuleName, Connection *p_ConnectionConfig):sc_modul
 	//DEBUGGING
 	SC_REPORT_INFO(g_DebugID, l_Report->newReportString("elaborates"));
 
+#ifndef _EVENT_DRIVEN
 	/// \li define clock period for Router
 	m_ClkPeriod = new const sc_time(1, SC_SEC);
 
 	/// \li Allocate clock for the Routers using the previously allocated period
 	m_ClkRouter = new sc_clock("CLK", *m_ClkPeriod);
+#endif
 
 
 	SC_REPORT_INFO(g_DebugID, l_Report->newReportString("Building the network interfaces"));
@@ -52,8 +56,10 @@ Host::Host(sc_module_name p_ModuleName, Connection *p_ConnectionConfig):sc_modul
 	export_ReceivingInterface[0] = new sc_export<Interface_If>;
 	export_ReceivingInterface[0]->bind(*m_NetworkInterface[0]);
 
+#ifndef _EVENT_DRIVEN
 	//bind the clock to the network interface
 	m_NetworkInterface[0]->port_Clk(*m_ClkRouter);
+#endif
 
 
 
@@ -61,7 +67,9 @@ Host::Host(sc_module_name p_ModuleName, Connection *p_ConnectionConfig):sc_modul
 	delete l_Report;
 
 	SC_THREAD(hostMain);
+#ifndef _EVENT_DRIVEN
 	sensitive << *m_ClkRouter;
+#endif
 
 }
 
@@ -77,14 +85,12 @@ void Host::hostMain()
 
 	while(true)
 	{
-		wait();
+		waitForWork();
 
 		//Read frame from the interface if available
-		if(m_NetworkInterface[0]->export_ToDataPlane->num_available() > 0)
+		if(m_NetworkInterface[0]->export_ToDataPlane->nb_read(m_Frame))
 		{
 
-			m_NetworkInterface[0]->export_ToDataPlane->read(m_Frame);
-
 			//Handle only frames that carry IP
 			if(m_Frame.getProtocolType() == TYPE_IP)
 			{
@@ -99,6 +105,18 @@ void Host::hostMain()
 
 }
 
+void Host::waitForWork(void)
+{
+#ifdef _EVENT_DRIVEN
+	//the host reads on both edges of its clock
+	if(m_NetworkInterface[0]->export_ToDataPlane->num_available() == 0)
+		wait(m_NetworkInterface[0]->export_ToDataPlane->data_written_event());
+	wait(timeToNextEdge(CLOCK_PERIOD/2.0));
+#else
+	wait();
+#endif
+}
+
 void Host::interfaceUp(void)
 {
 	m_NetworkInterface[0]->interfaceUp();
@@ -111,6 +129,9 @@ bool Host::sendMessage(string p_DestinationIP, string p_SourceIP, string p_Paylo
 //	cout << name() << " send a message:" << endl << "Destination: " << p_DestinationIP << endl << "Source: " << p_SourceIP << endl << "Payload: " << p_Payload << endl;
 	//build the IP packet
 	m_Frame = m_Encoder.buildIPPacket(p_DestinationIP, p_SourceIP, p_Payload);
+	//the packet pool is exhausted
+	if(!m_Frame.hasPDU())
+		return false;
 	//Set the protocol type to IP
 	m_Frame.setProtocolType(TYPE_IP);
 	//write the frame to the interface
@@ -140,6 +161,11 @@ void Host::clearMessageBuffer(void)
 	m_MsgBufferMutex.unlock();
 }
 
+unsigned long Host::getPacketPoolMemory(void)
+{
+	return m_PacketPool.getMemoryUsage();
+}
+
 void Host::appendMsgBuffer(string p_SubString)
 {
 	m_MsgBufferMutex.lock();
@@ -63,12 +63,19 @@ public:
      */
     virtual void clearMessageBuffer(void);
 
+    /*! \fn unsigned long getPacketPoolMemory(void)
+     * \brief Returns the bytes of the buffers allocated by the packet pool
+     * \public
+     */
+    unsigned long getPacketPoolMemory(void);
+
    SC_HAS_PROCESS(Host);
 
 private:
 
    sc_mutex m_MsgBufferMutex;
 
+#ifndef _EVENT_DRIVEN
     /*!
      * \property   const sc_time *clk_Periods
      * \brief
@@ -80,10 +87,11 @@ private:
     /*!
      * \property sc_clock *clk_Router
      * \brief Pointer to sc_clock
-     * \details
+     * \details The event-driven build has no clock
      * \private
      */
     sc_clock *m_ClkRouter;
+#endif
 
     /*!
      * \property Interface **m_NetworkInterface
@@ -101,6 +109,12 @@ private:
      */
     StringTools m_Name;
 
+    /*! \property PacketPool m_PacketPool
+     * \brief The buffers of the packets sent by this host
+     * \private
+     */
+    PacketPool m_PacketPool;
+
     Packet m_Frame;
 
     PacketProcessor m_Encoder;
@@ -109,6 +123,14 @@ private:
 
     void appendMsgBuffer(string p_SubString);
 
+    /*! \fn void waitForWork(void)
+     * \brief Waits for the next clock edge
+     * \details In the event-driven build the host sleeps until a frame
+     * arrives
+     * \private
+     */
+    void waitForWork(void);
+
 
 
 string m_MsgBuffer;
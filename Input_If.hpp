@@ -0,0 +1,54 @@
+/*! \file  Input_If.hpp
+ *  \brief     Header file of Input_If interface
+ *  \details   Defines the reading side of the channels inside a router
+ */
+
+/*!
+ * \class Input_If
+ * \brief Reading side of a channel that moves its items out
+ *  \details Unlike sc_fifo_in_if, which copies the item out and leaves
+ *  the slot holding its own copy, the item is moved out of the
+ *  channel. A packet read through this interface therefore does not
+ *  share its PDU with the channel.
+ */
+
+
+#include "systemc"
+
+using namespace std;
+using namespace sc_core;
+
+
+#ifndef _INPUT_IF_H_
+#define _INPUT_IF_H_
+
+
+template <class T>
+class Input_If: virtual public sc_interface
+{
+
+public:
+
+    /*! \fn virtual bool nb_read(T& p_Item) = 0
+     * \brief Moves the oldest readable item out of the channel
+     * @param[out] T& p_Item The item read
+     * \return bool: false if no item is readable
+     * \public
+     */
+    virtual bool nb_read(T& p_Item) = 0;
+
+    /*! \fn virtual int num_available(void) const = 0
+     * \brief Returns the number of readable items
+     * \public
+     */
+    virtual int num_available(void) const = 0;
+
+    /*! \fn virtual const sc_event& data_written_event(void) const = 0
+     * \brief Returns the event notified when items become readable
+     * \public
+     */
+    virtual const sc_event& data_written_event(void) const = 0;
+};
+
+
+#endif /* _INPUT_IF_H_ */
@@ -9,9 +9,11 @@
 
 #include "Interface.hpp"
 #include "ReportGlobals.hpp"
+#include "ClockTick.hpp"
+#include <sstream>
 
 
-Interface::Interface(sc_module_name p_ModName, Connection *p_IfConfig):sc_module(p_ModName), m_IfConfig(p_IfConfig)
+Interface::Interface(sc_module_name p_ModName, Connection *p_IfConfig):sc_module(p_ModName), m_IfConfig(p_IfConfig), m_BurstSize(BURST_DEFAULT_SIZE), m_ReceivedPackets(0), m_TransmittedPackets(0), m_DroppedPackets(0)
 {
   //make the inner bindings
     export_ToDataPlane(m_ReceivingBuffer);
@@ -19,7 +21,9 @@ Interface::Interface(sc_module_name p_ModName, Connection *p_IfConfig):sc_module
     m_Report.setBaseName(name());
 
     SC_THREAD(interfaceMain);
+#ifndef _EVENT_DRIVEN
     sensitive << port_Clk.pos();
+#endif
 }
 
 Interface::~Interface()
@@ -31,32 +35,42 @@ void Interface::interfaceMain(void)
 {
     SC_REPORT_INFO(g_ReportID, m_Report.newReportString("starting") );
 
+    Packet l_Frame;
     while(true)
     {
-        wait();
+        waitForWork();
 	
 	if(m_InterfaceState) //only if interface is up
-	  //Forward the next packet from the local forwarding queue
-	  port_Output->forward(m_ForwardingBuffer.read());
+	  {
+	    //Wait for the next packet in the local forwarding queue
+	    while(m_ForwardingBuffer.num_available() == 0)
+	      wait(m_ForwardingBuffer.data_written_event());
+	    //and forward it with the rest of the burst that is already queued
+	    for (int i = 0; i < m_BurstSize && m_ForwardingBuffer.nb_read(l_Frame); i++)
+	      {
+	        if(port_Output->forward(l_Frame))
+	          m_TransmittedPackets++;
+	        //a packet that the neighbor did not take is dropped
+	        l_Frame.clearPacket();
+	      }
+	  }
     }
 }
 
-bool Interface::forward(Packet p_Packet)
+bool Interface::forward(Packet& p_Packet)
 {
     //allow writing only if the interface is up
     if(m_InterfaceState)
         {
-            //check that the buffer is not full
-            if(m_ReceivingBuffer.num_free() > 0)
+            //the packet is moved in if the buffer is not full
+            if(m_ReceivingBuffer.nb_write(p_Packet))
                 {
-                    m_ReceivingBuffer.write(p_Packet);
+                    m_ReceivedPackets++;
                     return true;
                 }
-            else
-                return false;
         }
-    else
-        return false;
+    m_DroppedPackets++;
+    return false;
 }
 bool Interface::write(Packet& p_Frame)
 {
@@ -70,10 +84,28 @@ bool Interface::write(Packet& p_Frame)
 
 }
 
+bool Interface::nb_write(Packet& p_Frame)
+{
+	return isUp() && m_ForwardingBuffer.nb_write(p_Frame);
+}
+
+void Interface::setBurstSize(int p_BurstSize)
+{
+    m_BurstSize = p_BurstSize > 0 ? p_BurstSize : 1;
+}
+
+string Interface::getStatistics(void)
+{
+    ostringstream l_Stats;
+    l_Stats << m_ReceivedPackets << "," << m_TransmittedPackets << "," << m_DroppedPackets;
+    return l_Stats.str();
+}
+
 void Interface::interfaceDown(void)
 {
     //set interface down
     m_InterfaceState = DOWN;
+    m_StateChanged.notify(SC_ZERO_TIME);
     SC_REPORT_INFO(g_ReportID, m_Report.newReportString("DOWN"));
 }
 
@@ -87,6 +119,7 @@ bool Interface::interfaceUp(void)
         }
     else
         m_InterfaceState = DOWN;
+    m_StateChanged.notify(SC_ZERO_TIME);
     return m_InterfaceState;
 }
 
@@ -98,11 +131,9 @@ bool Interface::isUp(void)
 void Interface::emptyBuffers(void)
 {
     //empty the receiving buffer
-    while(m_ReceivingBuffer.num_available() > 0)
-        m_ReceivingBuffer.read();
+    m_ReceivingBuffer.clear();
     //empty the forwarding buffer
-    while(m_ForwardingBuffer.num_available() > 0)
-        m_ForwardingBuffer.read();
+    m_ForwardingBuffer.clear();
 
 }
 
@@ -119,3 +150,19 @@ void Interface::resetInterface(void)
     killInterface();
     interfaceUp();
 }
+
+const sc_event& Interface::stateChangedEvent(void)
+{
+    return m_StateChanged;
+}
+
+void Interface::waitForWork(void)
+{
+#ifdef _EVENT_DRIVEN
+    if(!m_InterfaceState)
+        wait(m_StateChanged);
+    wait(timeToNextEdge(CLOCK_PERIOD));
+#else
+    wait();
+#endif
+}
@@ -19,6 +19,8 @@
 #include "StringTools.hpp"
 #include "Configuration.hpp"
 #include "Output_If.hpp"
+#include "Input_If.hpp"
+#include "SPSCChannel.hpp"
 
 using namespace std;
 using namespace sc_core;
@@ -42,16 +44,18 @@ class Interface: public sc_module, public Interface_If, public Output_If<Packet>
 public:
 
 
+#ifndef _EVENT_DRIVEN
     /*! \brief Clock signal
      * \details 
      * \public
      */
     sc_in_clk port_Clk;
+#endif
 
     sc_port<Interface_If,1, SC_ZERO_OR_MORE_BOUND> port_Output;
 
 
-    sc_export<sc_fifo_in_if<Packet> > export_ToDataPlane;
+    sc_export<Input_If<Packet> > export_ToDataPlane;
 
     /*! \brief Network interface constructor
      * \details 
@@ -64,7 +68,7 @@ public:
     /*!
      * \sa Interface_If
      */  
-    virtual bool forward(Packet p_Packet);
+    virtual bool forward(Packet& p_Packet);
 
     /*! \fn void interfaceMain(void)
      *  \brief The SystemC process of the Interface module
@@ -97,8 +101,32 @@ public:
      */  
     virtual void resetInterface(void);
 
+    /*!
+     * \sa Interface_If
+     */
+    virtual const sc_event& stateChangedEvent(void);
+
     virtual bool write(Packet& p_Frame);
 
+    /*! \sa Output_If
+     */
+    virtual bool nb_write(Packet& p_Frame);
+
+    /*! \fn void setBurstSize(int p_BurstSize)
+     *  \brief Sets the number of packets forwarded per clock
+     * \public
+     */
+    void setBurstSize(int p_BurstSize);
+
+    /*! \fn string getStatistics(void)
+     *  \brief Returns the packet counters of the interface
+     *  \details Syntax: received,transmitted,dropped. The dropped
+     *  packets did not fit into the receiving buffer or arrived while
+     *  the interface was down.
+     * \public
+     */
+    string getStatistics(void);
+
 
     /*! \brief Indicate the systemC producer that this module has a process.
      * \sa http://www.iro.umontreal.ca/~lablasso/docs/SystemC2.0.1/html/classproducer.html
@@ -113,19 +141,20 @@ private:
   
 
 
-    /*! \property sc_fifo<Packet> m_ReceivingBuffer
+    /*! \property SPSCChannel<Packet> m_ReceivingBuffer
      *  \brief Receiving buffer
-     * \details 
+     * \details The packets are moved through the buffer, so the data
+     * plane rewrites the header of the only reference to the PDU
      * \private
      */
-    sc_fifo<Packet> m_ReceivingBuffer;
+    SPSCChannel<Packet> m_ReceivingBuffer;
 
-    /*! \property sc_fifo<Packet> m_ForwardingBuffer
+    /*! \property SPSCChannel<Packet> m_ForwardingBuffer
      * \brief Forwardig buffer
      * \details 
      * \private
      */
-    sc_fifo<Packet> m_ForwardingBuffer;
+    SPSCChannel<Packet> m_ForwardingBuffer;
 
     /*! \property bool m_InterfaceState 
      *  \brief The current state of the interface
@@ -134,6 +163,12 @@ private:
      */
     bool m_InterfaceState;
 
+    /*! \property sc_event m_StateChanged
+     *  \brief Notified when the interface goes up or down
+     *  \private
+     */
+    sc_event m_StateChanged;
+
     /*! \property StringTools m_Report
      *  \brief Internal reporting tool of the simulation
      *  \details
@@ -148,12 +183,45 @@ private:
      */
     Connection *m_IfConfig;
 
+    /*! \property int m_BurstSize
+     *  \brief The maximum number of packets forwarded per clock
+     *  \private
+     */
+    int m_BurstSize;
+
+    /*! \property unsigned long m_ReceivedPackets
+     *  \brief The packets written into the receiving buffer
+     *  \private
+     */
+    unsigned long m_ReceivedPackets;
+
+    /*! \property unsigned long m_TransmittedPackets
+     *  \brief The packets accepted by the neighbor
+     *  \private
+     */
+    unsigned long m_TransmittedPackets;
+
+    /*! \property unsigned long m_DroppedPackets
+     *  \brief The received packets that were dropped
+     *  \private
+     */
+    unsigned long m_DroppedPackets;
+
     /*! \fn void emptyBuffers(void)
      *  \brief empties both the receiving and forwarding buffers
      * \public
      */
     void emptyBuffers(void);
 
+    /*! \fn void waitForWork(void)
+     *  \brief Waits for the next clock edge at which the interface is
+     *  up
+     *  \details In the event-driven build a down interface sleeps
+     *  until it is brought up
+     * \private
+     */
+    void waitForWork(void);
+
 
 };
 
@@ -32,15 +32,17 @@ class Interface_If: virtual public sc_interface
 
 public:
 
-    /*! \fn virtual bool forward(Packet p_Packet) = 0
+    /*! \fn virtual bool forward(Packet& p_Packet) = 0
      *  \brief Writes the p_Packet to the receiving buffer of NIC that
      *  implements this IF
-     *  @param[in] Packet p_Packet The network frame carring BGP msg
+     *  \details The packet may be moved out of the argument if it is
+     *  taken
+     *  @param[in,out] Packet& p_Packet The network frame carring BGP msg
      *  or IP packet
      * \return bool true: success false: NIC down or the buffer is full
      * \public
      */
-    virtual bool forward(Packet p_Packet) = 0;
+    virtual bool forward(Packet& p_Packet) = 0;
     
     /*! \fn virtual void interfaceDown(void) = 0
      *  \brief Sets the NIC down
@@ -73,6 +75,12 @@ public:
      */
     virtual void resetInterface(void) = 0;
 
+    /*! \fn virtual const sc_event& stateChangedEvent(void) = 0
+     *  \brief Returns the event notified when the NIC goes up or down
+     * \public
+     */
+    virtual const sc_event& stateChangedEvent(void) = 0;
+
 
 };
 
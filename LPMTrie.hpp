@@ -0,0 +1,357 @@
+/*! \file  LPMTrie.hpp
+ *  \brief     Header file of LPMTrie class
+ *  \details   Defines a path-compressed binary trie for the longest
+ *  prefix match of IPv4 addresses.
+ */
+
+/*!
+ * \class LPMTrie
+ * \brief Longest prefix match trie
+ *  \details Stores values of type T under 32-bit prefix/length
+ *  keys. The trie is path-compressed: a node exists only if it holds
+ *  a value or if it branches to two children. Thus the depth of the
+ *  trie is bounded by the prefix length and a lookup visits at most
+ *  33 nodes without allocating any memory.
+ */
+
+
+#include <cstddef>
+
+using namespace std;
+
+
+#ifndef _LPMTRIE_H_
+#define _LPMTRIE_H_
+
+/*!
+ *The width of an IPv4 address in bits
+ */
+#define IPV4_BITS 32
+
+
+template <class T>
+class LPMTrie
+{
+
+public:
+
+    /*! \brief Default constructor
+     * \details Initiates an empty trie
+     * \public
+     */
+    LPMTrie(void):m_Root(NULL), m_Size(0){};
+
+    /*! \brief Destructor
+     * \details Frees all the nodes of the trie
+     * \public
+     */
+    ~LPMTrie(void)
+    {
+        clear();
+    };
+
+    /*! \fn void insert(unsigned p_Prefix, int p_Length, const T& p_Value)
+     * \brief Inserts or replaces the value of the given prefix
+     * \details The host bits of p_Prefix are ignored
+     * @param [in] unsigned p_Prefix The prefix in host byte order
+     * @param [in] int p_Length The prefix length 0-32
+     * @param [in] const T& p_Value The value to be stored
+     * \public
+     */
+    void insert(unsigned p_Prefix, int p_Length, const T& p_Value)
+    {
+        TrieNode **l_Slot = &m_Root;
+        unsigned l_Prefix = maskPrefix(p_Prefix, p_Length);
+
+        while(true)
+        {
+            TrieNode *l_Node = *l_Slot;
+
+            //empty slot: the prefix becomes a leaf here
+            if(l_Node == NULL)
+            {
+                *l_Slot = newNode(l_Prefix, p_Length, true, p_Value);
+                m_Size++;
+                return;
+            }
+
+            int l_Common = commonLength(l_Node->prefix, l_Node->length, l_Prefix, p_Length);
+
+            //exact match: replace the value
+            if(l_Common == l_Node->length && l_Common == p_Length)
+            {
+                if(!l_Node->hasValue)
+                    m_Size++;
+                l_Node->hasValue = true;
+                l_Node->value = p_Value;
+                return;
+            }
+
+            //the node is an ancestor of the new prefix: descend
+            if(l_Common == l_Node->length)
+            {
+                l_Slot = &l_Node->child[readBit(l_Prefix, l_Node->length)];
+                continue;
+            }
+
+            //the new prefix is an ancestor of the node
+            if(l_Common == p_Length)
+            {
+                TrieNode *l_New = newNode(l_Prefix, p_Length, true, p_Value);
+                l_New->child[readBit(l_Node->prefix, p_Length)] = l_Node;
+                *l_Slot = l_New;
+                m_Size++;
+                return;
+            }
+
+            //the prefixes diverge: add a branching node
+            TrieNode *l_Branch = newNode(maskPrefix(l_Prefix, l_Common), l_Common, false, T());
+            l_Branch->child[readBit(l_Node->prefix, l_Common)] = l_Node;
+            l_Branch->child[readBit(l_Prefix, l_Common)] = newNode(l_Prefix, p_Length, true, p_Value);
+            *l_Slot = l_Branch;
+            m_Size++;
+            return;
+        }
+    };
+
+    /*! \fn bool remove(unsigned p_Prefix, int p_Length)
+     * \brief Removes the value of the given prefix
+     * \details Nodes that no longer hold a value or branch are freed
+     * @param [in] unsigned p_Prefix The prefix in host byte order
+     * @param [in] int p_Length The prefix length 0-32
+     * \return bool true: prefix was removed - false: prefix was not found
+     * \public
+     */
+    bool remove(unsigned p_Prefix, int p_Length)
+    {
+        TrieNode **l_ParentSlot = NULL;
+        TrieNode **l_Slot = &m_Root;
+        unsigned l_Prefix = maskPrefix(p_Prefix, p_Length);
+
+        while(*l_Slot != NULL)
+        {
+            TrieNode *l_Node = *l_Slot;
+
+            if(l_Node->length > p_Length || maskPrefix(l_Prefix, l_Node->length) != l_Node->prefix)
+                return false;
+
+            if(l_Node->length < p_Length)
+            {
+                l_ParentSlot = l_Slot;
+                l_Slot = &l_Node->child[readBit(l_Prefix, l_Node->length)];
+                continue;
+            }
+
+            if(!l_Node->hasValue)
+                return false;
+
+            l_Node->hasValue = false;
+            l_Node->value = T();
+            m_Size--;
+
+            //a node with two children is still needed as a branch
+            if(l_Node->child[0] != NULL && l_Node->child[1] != NULL)
+                return true;
+
+            //splice the node out of the trie
+            *l_Slot = l_Node->child[0] != NULL ? l_Node->child[0] : l_Node->child[1];
+            delete l_Node;
+
+            //collapse a value-less parent that was left with one child
+            if(l_ParentSlot != NULL)
+            {
+                TrieNode *l_Parent = *l_ParentSlot;
+                if(!l_Parent->hasValue && (l_Parent->child[0] == NULL || l_Parent->child[1] == NULL))
+                {
+                    *l_ParentSlot = l_Parent->child[0] != NULL ? l_Parent->child[0] : l_Parent->child[1];
+                    delete l_Parent;
+                }
+            }
+            return true;
+        }
+        return false;
+    };
+
+    /*! \fn bool lookup(unsigned p_Address, T& p_Value) const
+     * \brief Finds the value of the longest prefix matching p_Address
+     * @param [in] unsigned p_Address The address in host byte order
+     * @param [out] T& p_Value The value of the longest matching prefix
+     * \return bool true: a matching prefix was found - false: no match
+     * \public
+     */
+    bool lookup(unsigned p_Address, T& p_Value) const
+    {
+        const TrieNode *l_Node = m_Root;
+        const TrieNode *l_Best = NULL;
+
+        while(l_Node != NULL)
+        {
+            if(maskPrefix(p_Address, l_Node->length) != l_Node->prefix)
+                break;
+            if(l_Node->hasValue)
+                l_Best = l_Node;
+            if(l_Node->length == IPV4_BITS)
+                break;
+            l_Node = l_Node->child[readBit(p_Address, l_Node->length)];
+        }
+
+        if(l_Best == NULL)
+            return false;
+
+        p_Value = l_Best->value;
+        return true;
+    };
+
+    /*! \fn T* find(unsigned p_Prefix, int p_Length)
+     * \brief Exact match search
+     * @param [in] unsigned p_Prefix The prefix in host byte order
+     * @param [in] int p_Length The prefix length 0-32
+     * \return T*: pointer to the stored value or NULL if not found
+     * \public
+     */
+    T* find(unsigned p_Prefix, int p_Length)
+    {
+        TrieNode *l_Node = m_Root;
+        unsigned l_Prefix = maskPrefix(p_Prefix, p_Length);
+
+        while(l_Node != NULL && l_Node->length <= p_Length)
+        {
+            if(maskPrefix(l_Prefix, l_Node->length) != l_Node->prefix)
+                return NULL;
+            if(l_Node->length == p_Length)
+                return l_Node->hasValue ? &l_Node->value : NULL;
+            l_Node = l_Node->child[readBit(l_Prefix, l_Node->length)];
+        }
+        return NULL;
+    };
+
+    /*! \fn void clear(void)
+     * \brief Removes all the prefixes from the trie
+     * \public
+     */
+    void clear(void)
+    {
+        freeNode(m_Root);
+        m_Root = NULL;
+        m_Size = 0;
+    };
+
+    /*! \fn void visit(V& p_Visitor) const
+     * \brief Calls p_Visitor(prefix, length, value) for each stored prefix
+     * \details A prefix is visited before the longer prefixes that it
+     * covers
+     * \public
+     */
+    template <class V>
+    void visit(V& p_Visitor) const
+    {
+        visitNode(m_Root, p_Visitor);
+    };
+
+    /*! \fn int size(void) const
+     * \brief Returns the number of stored prefixes
+     * \public
+     */
+    int size(void) const
+    {
+        return m_Size;
+    };
+
+    /*! \fn static unsigned maskPrefix(unsigned p_Prefix, int p_Length)
+     * \brief Clears the host bits of p_Prefix
+     * \public
+     */
+    static unsigned maskPrefix(unsigned p_Prefix, int p_Length)
+    {
+        return p_Length <= 0 ? 0 : p_Prefix & (0xFFFFFFFFu << (IPV4_BITS - p_Length));
+    };
+
+private:
+
+    /*! \brief A node of the trie
+     * \details prefix holds the significant bits, length the number
+     * of them. hasValue is false for pure branching nodes.
+     * \private
+     */
+    struct TrieNode
+    {
+        unsigned prefix;
+        int length;
+        bool hasValue;
+        T value;
+        TrieNode *child[2];
+    };
+
+    /*! \property TrieNode *m_Root
+     * \brief The root of the trie
+     * \private
+     */
+    TrieNode *m_Root;
+
+    /*! \property int m_Size
+     * \brief The number of stored prefixes
+     * \private
+     */
+    int m_Size;
+
+    TrieNode *newNode(unsigned p_Prefix, int p_Length, bool p_HasValue, const T& p_Value)
+    {
+        TrieNode *l_Node = new TrieNode;
+        l_Node->prefix = p_Prefix;
+        l_Node->length = p_Length;
+        l_Node->hasValue = p_HasValue;
+        l_Node->value = p_Value;
+        l_Node->child[0] = NULL;
+        l_Node->child[1] = NULL;
+        return l_Node;
+    };
+
+    void freeNode(TrieNode *p_Node)
+    {
+        if(p_Node == NULL)
+            return;
+        freeNode(p_Node->child[0]);
+        freeNode(p_Node->child[1]);
+        delete p_Node;
+    };
+
+    template <class V>
+    static void visitNode(const TrieNode *p_Node, V& p_Visitor)
+    {
+        if(p_Node == NULL)
+            return;
+        if(p_Node->hasValue)
+            p_Visitor(p_Node->prefix, p_Node->length, p_Node->value);
+        visitNode(p_Node->child[0], p_Visitor);
+        visitNode(p_Node->child[1], p_Visitor);
+    };
+
+    /*! \brief Returns the bit in position p_Position counted from the MSB
+     * \private
+     */
+    static int readBit(unsigned p_Value, int p_Position)
+    {
+        return (p_Value >> (IPV4_BITS - 1 - p_Position)) & 1;
+    };
+
+    /*! \brief Returns the number of leading bits that the two prefixes share
+     * \private
+     */
+    static int commonLength(unsigned p_A, int p_LengthA, unsigned p_B, int p_LengthB)
+    {
+        int l_Max = p_LengthA < p_LengthB ? p_LengthA : p_LengthB;
+        unsigned l_Diff = p_A ^ p_B;
+        if(l_Diff == 0)
+            return l_Max;
+        int l_Common = __builtin_clz(l_Diff);
+        return l_Common < l_Max ? l_Common : l_Max;
+    };
+
+    //the trie owns its nodes
+    LPMTrie(const LPMTrie&);
+    LPMTrie& operator = (const LPMTrie&);
+
+};
+
+
+#endif /* _LPMTRIE_H_ */
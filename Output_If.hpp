@@ -42,6 +42,18 @@ public:
    */
     virtual bool write(T& ) = 0;
 
+  /*! \brief Passes a message without waiting
+   * \details Allows the SystemC methods, which cannot wait, to pass
+   * messages. A writer that is waiting for a full buffer holds the
+   * mutex of write, so the mutex is only tried. A message handle is
+   * moved out of the argument only if the message is taken.
+   * @param[in] BGPMessage p_BGPMsg  The BGP message to be send
+   * \return bool True: as write, False: as write or if the message
+   * cannot be taken without waiting
+   * \public
+   */
+    virtual bool nb_write(T& ) = 0;
+
 
 
 
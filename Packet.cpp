@@ -9,31 +9,40 @@
 
 #include "Packet.hpp"
 #include "StringTools.hpp"
+#include <cstring>
+#include <utility>
 
 
 
 
 
-Packet::Packet(void)
+Packet::Packet(void):m_Buffer(NULL), m_ProtocolType(-1), m_UpdateInPDU(false), m_Pool(NULL)
 {
-    initPDU();
 }
 
 Packet::~Packet(void)
 {
+    releasePDU();
 }
 
-Packet::Packet(const Packet& p_Packet)
+Packet::Packet(const Packet& p_Packet):m_BGPPayload(p_Packet.m_BGPPayload), m_Buffer(p_Packet.m_Buffer), m_ProtocolType(p_Packet.m_ProtocolType), m_UpdateInPDU(p_Packet.m_UpdateInPDU), m_Pool(p_Packet.m_Pool)
 {
-    initPDU();
-    *this = p_Packet;
+    //share the PDU
+    if(m_Buffer != NULL)
+        m_Buffer->acquire();
+}
+
+Packet::Packet(Packet&& p_Packet):m_BGPPayload(std::move(p_Packet.m_BGPPayload)), m_Buffer(p_Packet.m_Buffer), m_ProtocolType(p_Packet.m_ProtocolType), m_UpdateInPDU(p_Packet.m_UpdateInPDU), m_Pool(p_Packet.m_Pool)
+{
+    //take over the PDU
+    p_Packet.m_Buffer = NULL;
+    p_Packet.m_UpdateInPDU = false;
 }
 
 
-Packet::Packet(BGPMessage& p_BGPPayload, int p_ProtocolType)
+Packet::Packet(BGPMessage& p_BGPPayload, int p_ProtocolType):m_Buffer(NULL), m_UpdateInPDU(false), m_Pool(NULL)
 {
-    initPDU();
-    m_BGPPayload = p_BGPPayload;
+    setBGPPayload(p_BGPPayload);
     m_ProtocolType = p_ProtocolType;
 
 
@@ -45,14 +54,46 @@ bool Packet::setProtocolType(int p_ProtocolType)
     return true; //TO-DO: validity check
 }
 
-void Packet::setBGPPayload(BGPMessage& p_BGPPayload)
+bool Packet::setBGPPayload(BGPMessage& p_BGPPayload)
 {
     m_BGPPayload = p_BGPPayload;
+    return encodeBGPPayload();
 }
 
-BGPMessage& Packet::getBGPPayload(void)
+bool Packet::setBGPPayload(BGPMessage&& p_BGPPayload)
 {
+    m_BGPPayload = std::move(p_BGPPayload);
+    return encodeBGPPayload();
+}
 
+/*! \sa Packet
+ */
+bool Packet::encodeBGPPayload(void)
+{
+    m_UpdateInPDU = false;
+
+    if(m_BGPPayload.m_Type != UPDATE)
+        return true;
+
+    //the UPDATE travels in the PDU in the wire format
+    if(!detachPDU())
+        return false;
+    if(m_BGPPayload.m_Update.encode(m_Buffer->m_Data, MTU) > 0)
+    {
+        m_BGPPayload.m_Update.clear();
+        m_UpdateInPDU = true;
+    }
+    return true;
+}
+
+BGPMessage& Packet::getBGPPayload(void)
+{
+    if(m_UpdateInPDU)
+    {
+        if(!m_BGPPayload.m_Update.decode(m_Buffer->m_Data, MTU))
+            m_BGPPayload.m_Update.clear();
+        m_UpdateInPDU = false;
+    }
     return m_BGPPayload;
 }
 
@@ -61,44 +102,109 @@ int Packet::getProtocolType(void)
     return m_ProtocolType;
 }
 
-void Packet::setPDU(const unsigned char *p_PDU)
+bool Packet::setPDU(const unsigned char *p_PDU)
 {
-    for (int i = 0; i < MTU; i++)
-        {
-            m_PDU[i] = p_PDU[i];
-        }
+    if(m_Buffer != NULL && p_PDU == m_Buffer->m_Data)
+        return true;
+    if(!detachPDU())
+        return false;
+    memcpy(m_Buffer->m_Data, p_PDU, MTU);
+    return true;
 }
 
 /*! \sa Packet
  */
 void Packet::getPDU(unsigned char *p_PDU)
 {
-    
-    for (int i = 0; i < MTU; i++)
+    memcpy(p_PDU, readPDU(), MTU);
+}
+
+/*! \sa Packet
+ */
+const unsigned char *Packet::getPDU(void) const
+{
+    return m_Buffer != NULL ? m_Buffer->m_Data : NULL;
+}
+
+/*! \sa Packet
+ */
+unsigned char *Packet::mutablePDU(void)
+{
+    if(m_Buffer != NULL && !m_Buffer->isShared())
+        return m_Buffer->m_Data;
+
+    //copy on write: the other packets keep the shared buffer
+    PacketBuffer *l_Shared = m_Buffer;
+    if(l_Shared != NULL)
+        l_Shared->acquire();
+    bool l_Allocated = takeBuffer();
+    if(l_Shared != NULL)
         {
-            p_PDU[i] = m_PDU[i];
+            if(l_Allocated)
+                memcpy(m_Buffer->m_Data, l_Shared->m_Data, MTU);
+            l_Shared->release();
         }
+    return l_Allocated ? m_Buffer->m_Data : NULL;
+}
+
+/*! \sa Packet
+ */
+bool Packet::hasPDU(void) const
+{
+    return m_Buffer != NULL;
+}
 
+/*! \sa Packet
+ */
+void Packet::setPacketPool(PacketPool *p_Pool)
+{
+    m_Pool = p_Pool;
+}
+
+/*! \sa Packet
+ */
+bool Packet::allocatePDU(void)
+{
+    if(!takeBuffer())
+        return false;
+    m_Buffer->clear();
+    return true;
 }
 
 
 bool Packet::operator == (const Packet& p_Packet) const {
 
-    for (int i = 0; i < MTU; i++)
-        {
-            if(m_PDU[i] != p_Packet.m_PDU[i])
-                return false;
-        }
-    return (p_Packet.m_BGPPayload == m_BGPPayload && p_Packet.m_ProtocolType == m_ProtocolType );
+    if(m_Buffer != p_Packet.m_Buffer && memcmp(readPDU(), p_Packet.readPDU(), MTU) != 0)
+        return false;
+    return (p_Packet.m_BGPPayload == m_BGPPayload && p_Packet.m_ProtocolType == m_ProtocolType && p_Packet.m_UpdateInPDU == m_UpdateInPDU);
 }
 
 Packet& Packet::operator = (const Packet& p_Packet) {
     m_BGPPayload = p_Packet.m_BGPPayload;
     m_ProtocolType = p_Packet.m_ProtocolType;
+    m_UpdateInPDU = p_Packet.m_UpdateInPDU;
+
+    //share the PDU. The pool of this packet is kept
+    if(p_Packet.m_Buffer != NULL)
+        p_Packet.m_Buffer->acquire();
+    releasePDU();
+    m_Buffer = p_Packet.m_Buffer;
 
-    initPDU();
-    setPDU(p_Packet.m_PDU);
+    return *this;
+}
+
+Packet& Packet::operator = (Packet&& p_Packet) {
+    if(this == &p_Packet)
+        return *this;
+    m_BGPPayload = std::move(p_Packet.m_BGPPayload);
+    m_ProtocolType = p_Packet.m_ProtocolType;
+    m_UpdateInPDU = p_Packet.m_UpdateInPDU;
 
+    //take over the PDU. The pool of this packet is kept
+    releasePDU();
+    m_Buffer = p_Packet.m_Buffer;
+    p_Packet.m_Buffer = NULL;
+    p_Packet.m_UpdateInPDU = false;
 
     return *this;
 }
@@ -107,18 +213,49 @@ void Packet::clearPacket(void)
 {
     m_BGPPayload.clearMessage();
     m_ProtocolType = -1;
-    initPDU();
+    m_UpdateInPDU = false;
+    releasePDU();
 }
 
 
 /*! \sa Packet
  */
-void Packet::initPDU(void)
+const unsigned char *Packet::readPDU(void) const
 {
-for (int i = 0; i < MTU; i++)
-    {
-        m_PDU[i] = 0;
-    }    
+    //a packet without a buffer has an all zero PDU
+    static const unsigned char l_EmptyPDU[MTU] = {0};
+    return m_Buffer != NULL ? m_Buffer->m_Data : l_EmptyPDU;
+}
+
+/*! \sa Packet
+ */
+void Packet::releasePDU(void)
+{
+    if(m_Buffer == NULL)
+        return;
+    m_Buffer->release();
+    m_Buffer = NULL;
+}
+
+/*! \sa Packet
+ */
+bool Packet::detachPDU(void)
+{
+    if(m_Buffer != NULL && !m_Buffer->isShared())
+        return true;
+    return takeBuffer();
+}
+
+/*! \sa Packet
+ */
+bool Packet::takeBuffer(void)
+{
+    releasePDU();
+    if(m_Pool != NULL)
+        m_Buffer = m_Pool->allocate();
+    else
+        m_Buffer = PacketBuffer::allocate();
+    return m_Buffer != NULL;
 }
 
 
@@ -132,14 +269,14 @@ string Packet::outputPDU(void)
             if(i%4 == 0)
                 l_out += "\n";
 
-            l_out += u8ToS(m_PDU[i]) + ",";
+            l_out += u8ToS(readPDU()[i]) + ",";
         }
 
     for (; i < MTU; i++)
         {
             if(i%4 == 0)
                 l_out += "\n";
-            l_temp = string(1,(char)m_PDU[i]);
+            l_temp = string(1,(char)readPDU()[i]);
             l_out += l_temp + ",";
         }
 
@@ -8,12 +8,22 @@
 
 /*! \class Packet
  *  \brief     
- *  \details   
+ *  \details   The PDU is held in a reference counted PacketBuffer.
+ *  Copies of a packet share the buffer, so passing a packet through
+ *  the FIFOs does not copy the PDU. getPDU() gives read access to
+ *  the shared buffer. The header of a packet in flight is rewritten
+ *  through mutablePDU(), which copies the PDU into a buffer of its own
+ *  first if the current one is shared. setPDU and setBGPPayload give
+ *  the packet a buffer of its own as well. A packet gets a buffer only when it needs
+ *  one. The buffer is taken from the PacketPool of the packet, or
+ *  from the heap if the packet has no pool.
  */
 
 #include <systemc>
 #include "BGPMessage.hpp"
 #include "StringTools.hpp"
+#include "PacketBuffer.hpp"
+#include "PacketPool.hpp"
 
 
 using std::cout;
@@ -28,7 +38,6 @@ using sc_dt::sc_bv;
 #ifndef PACKET_H
 #define PACKET_H
 
-#define MTU 576
 #define TYPE_IP 0
 #define TYPE_BGP 1
 #define TYPE_TCP_SYN 2
@@ -63,6 +72,15 @@ public:
      */
     Packet(const Packet& p_Packet);
 
+    /*!
+     * \brief Move constructor
+     * \details Takes over the BGP message and the PDU buffer of
+     * p_Packet, which is left without a buffer
+     * @param[in] Packet&& p_Packet The packet to be moved into this
+     * \public
+     */
+    Packet(Packet&& p_Packet);
+
     /*!
      * \brief Constructor with member data.
      * \details Initiates the packet data and all the id fields to given values.
@@ -76,11 +94,23 @@ public:
 
     /*!
      * \brief Set BGP message as payload
+     * \details The UPDATE fields are encoded into the PDU in the BGP
+     * wire format
      * @param[in] BGPMessage& p_BGPPayload Reference to the BGP
      * payload object 
+     * \return \b bool false if no buffer was available for the
+     * UPDATE and the packet shall be dropped
+     * \public
+     */
+    bool setBGPPayload(BGPMessage& p_BGPPayload);
+
+    /*!
+     * \brief Moves BGP message into the payload
+     * \details As setBGPPayload(BGPMessage&) without copying the
+     * message
      * \public
      */
-    void setBGPPayload(BGPMessage& p_BGPPayload);
+    bool setBGPPayload(BGPMessage&& p_BGPPayload);
 
 
     /*!
@@ -91,13 +121,14 @@ public:
      */
     bool setProtocolType(int p_ProtocolType);
 
-    /*! \fn void setPDU(const unsigned char *p_PDU); 
+    /*! \fn bool setPDU(const unsigned char *p_PDU); 
      * \brief Sets the PDU
      * \details 
      * @param [in] const unsigned char *p_PDU  
+     * \return bool: false if no buffer was available
      * \public
      */
-    void setPDU(const unsigned char *p_PDU);
+    bool setPDU(const unsigned char *p_PDU);
     
 
     /*! \fn void getPDU(unsigned char *p_PDU); 
@@ -108,9 +139,51 @@ public:
      */
     void getPDU(unsigned char *p_PDU);
 
+    /*! \fn const unsigned char *getPDU(void) const;
+     * \brief Returns the PDU for reading
+     * \details The buffer may be shared with the copies of this packet
+     * \return const unsigned char *: the MTU octets of the PDU or NULL
+     * if the packet has no buffer
+     * \public
+     */
+    const unsigned char *getPDU(void) const;
+
+    /*! \fn unsigned char *mutablePDU(void)
+     * \brief Returns the PDU for in place rewriting
+     * \details A buffer shared with the copies of this packet is
+     * copied first, so the copies do not see the changes. A packet
+     * without a buffer gets a zeroed one.
+     * \return unsigned char *: the MTU octets of the PDU or NULL if no
+     * buffer was available
+     * \public
+     */
+    unsigned char *mutablePDU(void);
+
+    /*! \fn bool hasPDU(void) const
+     * \brief Returns true if the packet has a buffer
+     * \public
+     */
+    bool hasPDU(void) const;
+
+    /*! \fn void setPacketPool(PacketPool *p_Pool)
+     * \brief Sets the pool from which the buffers of this packet are taken
+     * \details The pool is not assigned to the packet by operator =
+     * @param [in] PacketPool *p_Pool The pool or NULL for the heap
+     * \public
+     */
+    void setPacketPool(PacketPool *p_Pool);
+
+    /*! \fn bool allocatePDU(void)
+     * \brief Gives the packet a new zeroed buffer of its own
+     * \return bool: false if the pool is exhausted
+     * \public
+     */
+    bool allocatePDU(void);
+
 
     /*!
      * \brief Get BGP Message
+     * \details The UPDATE fields are decoded from the PDU
      * \return \b BGPMessage& Reference to BGP message object
      * \public
      */
@@ -142,6 +215,15 @@ public:
      */
     Packet& operator = (const Packet& p_Packet);
 
+    /*!
+     * \brief Overload of move assign operator
+     * \details Takes over the BGP message and the PDU buffer of
+     * p_Packet, which is left without a buffer. The pool of this packet
+     * is kept.
+     * \public
+     */
+    Packet& operator = (Packet&& p_Packet);
+
     /*! \relates sc_signal
      * \brief Overload stream operator
      * \details Write data members into given output stream.
@@ -165,7 +247,7 @@ public:
                 l_Result = "";
                 if(i%4 == 0)
                     l_out += "\n";
-                l_Value = p_Packet.m_PDU[i];
+                l_Value = p_Packet.readPDU()[i];
                 l_H = l_Value/100;
                 if(l_H != 0)
                     {
@@ -187,8 +269,8 @@ public:
         l_out = "";
         for (; i < MTU; i++)
             {
-                l_out += p_Packet.m_PDU[i]; //jos string väliin lisää pilkun tai rivin vaihdon  ennen ä, ö, tai å niin enkoodaus menee persiilleen
-                if(p_Packet.m_PDU[i] == 0)
+                l_out += p_Packet.readPDU()[i]; //jos string väliin lisää pilkun tai rivin vaihdon  ennen ä, ö, tai å niin enkoodaus menee persiilleen
+                if(p_Packet.readPDU()[i] == 0)
                     l_out += ",";
             }
         os << l_out << endl;
@@ -225,12 +307,14 @@ private:
      */
     BGPMessage m_BGPPayload;
     
-    /*! \property unsigned char m_PDU[MTU] 
+    /*! \property PacketBuffer *m_Buffer
      * \brief The PDU that this packet carries 
-     * \details IP packet is stored in this one
+     * \details IP packet is stored in this one. The buffer may be
+     * shared with the copies of this packet. NULL if the packet has
+     * no PDU.
      * \private
      */
-    unsigned char m_PDU[MTU];
+    PacketBuffer *m_Buffer;
 
     /*! \brief Holds the protocol type of the packet 
      * \details 
@@ -238,13 +322,57 @@ private:
      */
     int m_ProtocolType;
 
+    /*! \property bool m_UpdateInPDU
+     * \brief Indicates that the UPDATE fields of m_BGPPayload are
+     * encoded in the PDU
+     * \private
+     */
+    bool m_UpdateInPDU;
 
-    /*! \fn void initPDU(void) 
-     * \brief Sets all the fields in m_PDU to zero
-     * \details 
+    /*! \property PacketPool *m_Pool
+     * \brief The pool of the buffers of this packet
+     * \private
+     */
+    PacketPool *m_Pool;
+
+
+    /*! \fn const unsigned char *readPDU(void) const
+     * \brief Returns the PDU for reading
+     * \details A packet without a buffer reads as all zeros
+     * \private
+     */
+    const unsigned char *readPDU(void) const;
+
+    /*! \fn void releasePDU(void)
+     * \brief Releases the buffer of this packet
+     * \private
+     */
+    void releasePDU(void);
+
+    /*! \fn bool detachPDU(void)
+     * \brief Gives this packet a buffer of its own
+     * \details The content of a shared buffer is not copied, so this
+     * shall be called only before the whole PDU is rewritten
+     * \return bool: false if no buffer was available
+     * \private
+     */
+    bool detachPDU(void);
+
+    /*! \fn bool takeBuffer(void)
+     * \brief Gives this packet a new buffer whose content is left as
+     * it is
+     * \details Used when the whole PDU is copied into the buffer
+     * \return bool: false if no buffer was available
+     * \private
+     */
+    bool takeBuffer(void);
+
+    /*! \fn bool encodeBGPPayload(void)
+     * \brief Encodes the UPDATE fields of m_BGPPayload into the PDU
+     * \return bool: false if no buffer was available
      * \private
      */
-    void initPDU(void);
+    bool encodeBGPPayload(void);
     string u8ToS(unsigned char p_Value);
 };
 
@@ -0,0 +1,61 @@
+/*! \file PacketBuffer.cpp
+ *  \brief     Implementation of PacketBuffer class.
+ *  \details
+ */
+
+
+#include "PacketBuffer.hpp"
+#include "PacketPool.hpp"
+#include <cstring>
+
+
+PacketBuffer::PacketBuffer(void):m_References(1), m_Pool(NULL), m_Pooled(false)
+{
+    clear();
+}
+
+PacketBuffer::~PacketBuffer(void)
+{
+}
+
+/*! \sa PacketBuffer
+ */
+PacketBuffer *PacketBuffer::allocate(void)
+{
+    return new PacketBuffer();
+}
+
+/*! \sa PacketBuffer
+ */
+void PacketBuffer::acquire(void)
+{
+    m_References++;
+}
+
+/*! \sa PacketBuffer
+ */
+void PacketBuffer::release(void)
+{
+    if(--m_References > 0)
+        return;
+
+    if(m_Pool != NULL)
+        m_Pool->recycle(this);
+    else if(!m_Pooled)
+        delete this;
+    //else the slab of a destroyed pool is left allocated
+}
+
+/*! \sa PacketBuffer
+ */
+bool PacketBuffer::isShared(void) const
+{
+    return m_References > 1;
+}
+
+/*! \sa PacketBuffer
+ */
+void PacketBuffer::clear(void)
+{
+    memset(m_Data, 0, MTU);
+}
@@ -0,0 +1,103 @@
+/*! \file  PacketBuffer.hpp
+ *  \brief     Header file of PacketBuffer class
+ *  \details   Defines the reference counted storage of a PDU
+ */
+
+/*!
+ * \class PacketBuffer
+ * \brief Reference counted PDU storage
+ *  \details A Packet holds a handle to one of these instead of a PDU
+ *  array of its own. Copying a Packet only adds a reference, so the
+ *  FIFOs between the modules pass the PDU without copying it. When
+ *  the last reference is released the buffer returns to the
+ *  PacketPool it was taken from, or is freed if it has no pool.
+ */
+
+
+#ifndef _PACKETBUFFER_H_
+#define _PACKETBUFFER_H_
+
+/*!
+ *The size of the PDU
+ */
+#define MTU 576
+
+class PacketPool;
+
+
+class PacketBuffer
+{
+
+public:
+
+    /*! \fn static PacketBuffer *allocate(void)
+     * \brief Returns a new zeroed buffer with one reference
+     * \details The buffer is allocated from the heap. It is used by
+     * the packets that have no PacketPool.
+     * \public
+     */
+    static PacketBuffer *allocate(void);
+
+    /*! \fn void acquire(void)
+     * \brief Adds a reference to this buffer
+     * \public
+     */
+    void acquire(void);
+
+    /*! \fn void release(void)
+     * \brief Removes a reference from this buffer
+     * \details The buffer is recycled or freed when the last
+     * reference is removed
+     * \public
+     */
+    void release(void);
+
+    /*! \fn bool isShared(void) const
+     * \brief Returns true if more than one packet refers to this buffer
+     * \public
+     */
+    bool isShared(void) const;
+
+    /*! \fn void clear(void)
+     * \brief Sets all the octets of the PDU to zero
+     * \public
+     */
+    void clear(void);
+
+    /*! \property unsigned char m_Data[MTU]
+     * \brief The PDU
+     * \public
+     */
+    unsigned char m_Data[MTU];
+
+private:
+
+    friend class PacketPool;
+
+    PacketBuffer(void);
+
+    ~PacketBuffer(void);
+
+    /*! \property int m_References
+     * \brief The number of packets referring to this buffer
+     * \private
+     */
+    int m_References;
+
+    /*! \property PacketPool *m_Pool
+     * \brief The pool that owns this buffer
+     * \details NULL for a heap buffer and for a buffer whose pool
+     * has been destroyed
+     * \private
+     */
+    PacketPool *m_Pool;
+
+    /*! \property bool m_Pooled
+     * \brief Indicates that the buffer belongs to the slab of a pool
+     * \private
+     */
+    bool m_Pooled;
+};
+
+
+#endif /* _PACKETBUFFER_H_ */
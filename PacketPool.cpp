@@ -0,0 +1,128 @@
+/*! \file PacketPool.cpp
+ *  \brief     Implementation of PacketPool class.
+ *  \details
+ */
+
+
+#include "PacketPool.hpp"
+#include <sstream>
+#include <algorithm>
+
+
+PacketPool::PacketPool(int p_Size):m_Size(p_Size > 0 ? p_Size : 0), m_Allocated(0), m_HighWaterMark(0), m_Drops(0)
+{
+}
+
+PacketPool::~PacketPool(void)
+{
+    if(getInUse() == 0)
+    {
+        for (unsigned i = 0; i < m_Slabs.size(); i++)
+            delete[] m_Slabs[i];
+        return;
+    }
+
+    //packets of the other modules may still refer to the buffers
+    for (unsigned i = 0; i < m_Slabs.size(); i++)
+    {
+        int l_Count = min(PACKET_POOL_SLAB_SIZE, m_Allocated - (int)i*PACKET_POOL_SLAB_SIZE);
+        for (int j = 0; j < l_Count; j++)
+            m_Slabs[i][j].m_Pool = NULL;
+    }
+}
+
+/*! \sa PacketPool
+ */
+PacketBuffer *PacketPool::allocate(void)
+{
+    if(m_FreeBuffers.empty() && !grow())
+    {
+        m_Drops++;
+        return NULL;
+    }
+
+    PacketBuffer *l_Buffer = m_FreeBuffers.back();
+    m_FreeBuffers.pop_back();
+    l_Buffer->m_References = 1;
+    if(getInUse() > m_HighWaterMark)
+        m_HighWaterMark = getInUse();
+    return l_Buffer;
+}
+
+/*! \sa PacketPool
+ */
+void PacketPool::recycle(PacketBuffer *p_Buffer)
+{
+    m_FreeBuffers.push_back(p_Buffer);
+}
+
+/*! \sa PacketPool
+ */
+bool PacketPool::grow(void)
+{
+    int l_Count = min(PACKET_POOL_SLAB_SIZE, m_Size - m_Allocated);
+    if(l_Count <= 0)
+        return false;
+
+    PacketBuffer *l_Slab = new PacketBuffer[l_Count];
+    m_Slabs.push_back(l_Slab);
+    m_Allocated += l_Count;
+    for (int i = l_Count-1; i >= 0; i--)
+    {
+        l_Slab[i].m_Pool = this;
+        l_Slab[i].m_Pooled = true;
+        m_FreeBuffers.push_back(&l_Slab[i]);
+    }
+    return true;
+}
+
+/*! \sa PacketPool
+ */
+int PacketPool::getSize(void)
+{
+    return m_Size;
+}
+
+/*! \sa PacketPool
+ */
+int PacketPool::getAllocated(void)
+{
+    return m_Allocated;
+}
+
+/*! \sa PacketPool
+ */
+unsigned long PacketPool::getMemoryUsage(void)
+{
+    return (unsigned long)m_Allocated * sizeof(PacketBuffer);
+}
+
+/*! \sa PacketPool
+ */
+int PacketPool::getInUse(void)
+{
+    return m_Allocated - m_FreeBuffers.size();
+}
+
+/*! \sa PacketPool
+ */
+int PacketPool::getHighWaterMark(void)
+{
+    return m_HighWaterMark;
+}
+
+/*! \sa PacketPool
+ */
+unsigned long PacketPool::getDrops(void)
+{
+    return m_Drops;
+}
+
+/*! \sa PacketPool
+ */
+string PacketPool::getStatistics(void)
+{
+    ostringstream l_Stats;
+    l_Stats << m_Size << "," << getInUse() << "," << m_HighWaterMark << "," << m_Drops << "," << m_Allocated;
+    return l_Stats.str();
+}
@@ -0,0 +1,146 @@
+/*! \file  PacketPool.hpp
+ *  \brief     Header file of PacketPool class
+ *  \details   Defines the fixed size allocator of the packet buffers
+ */
+
+/*!
+ * \class PacketPool
+ * \brief Bounded pool of packet buffers
+ *  \details The size of the pool is an upper bound. The buffers are
+ *  allocated in slabs of PACKET_POOL_SLAB_SIZE when the free list
+ *  runs empty, so a router that forwards no data traffic costs no
+ *  buffers. allocate takes a buffer from the free list and the buffer
+ *  returns to the list when its last reference is released, so once
+ *  the pool has grown to the working set a running simulation does no
+ *  heap allocations for the PDUs. When the pool is exhausted allocate
+ *  fails and the packet is dropped.
+ *  The drops and the high-water mark of the buffers in use are
+ *  counted.
+ */
+
+
+#include <vector>
+#include <string>
+#include "PacketBuffer.hpp"
+
+using namespace std;
+
+
+#ifndef _PACKETPOOL_H_
+#define _PACKETPOOL_H_
+
+/*!
+ *The number of buffers allocated at once when the pool grows
+ */
+#define PACKET_POOL_SLAB_SIZE 32
+
+
+class PacketPool
+{
+
+public:
+
+    /*! \brief Builds an empty pool
+     * @param [in] int p_Size The maximum number of buffers in the pool
+     * \public
+     */
+    PacketPool(int p_Size);
+
+    /*! \brief Frees the slabs
+     * \details If packets still refer to the buffers, the slabs are
+     * left allocated and the buffers are detached from the pool
+     * \public
+     */
+    ~PacketPool(void);
+
+    /*! \fn PacketBuffer *allocate(void)
+     * \brief Returns a buffer with one reference
+     * \details The buffer keeps the bytes of its previous packet. It
+     * is not cleared, as a copied PDU overwrites it anyway.
+     * \return PacketBuffer*: the buffer or NULL if the pool is exhausted
+     * \public
+     */
+    PacketBuffer *allocate(void);
+
+    /*! \fn void recycle(PacketBuffer *p_Buffer)
+     * \brief Returns a buffer to the free list
+     * \details Called by the buffer when its last reference is released
+     * \public
+     */
+    void recycle(PacketBuffer *p_Buffer);
+
+    /*! \fn int getSize(void)
+     * \brief Returns the maximum number of buffers in the pool
+     * \public
+     */
+    int getSize(void);
+
+    /*! \fn int getAllocated(void)
+     * \brief Returns the number of buffers allocated so far
+     * \public
+     */
+    int getAllocated(void);
+
+    /*! \fn unsigned long getMemoryUsage(void)
+     * \brief Returns the size of the allocated buffers in bytes
+     * \public
+     */
+    unsigned long getMemoryUsage(void);
+
+    /*! \fn int getInUse(void)
+     * \brief Returns the number of buffers in use
+     * \public
+     */
+    int getInUse(void);
+
+    /*! \fn int getHighWaterMark(void)
+     * \brief Returns the highest number of buffers in use at once
+     * \public
+     */
+    int getHighWaterMark(void);
+
+    /*! \fn unsigned long getDrops(void)
+     * \brief Returns the number of failed allocations
+     * \public
+     */
+    unsigned long getDrops(void);
+
+    /*! \fn string getStatistics(void)
+     * \brief Returns the statistics of the pool
+     * \details Syntax: size,in_use,high_water_mark,drops,allocated
+     * \public
+     */
+    string getStatistics(void);
+
+private:
+
+    /*! \property vector<PacketBuffer *> m_Slabs
+     * \brief The slabs of buffers allocated so far
+     * \private
+     */
+    vector<PacketBuffer *> m_Slabs;
+
+    /*! \property vector<PacketBuffer *> m_FreeBuffers
+     * \brief The buffers not in use
+     * \private
+     */
+    vector<PacketBuffer *> m_FreeBuffers;
+
+    int m_Size;
+
+    int m_Allocated;
+
+    int m_HighWaterMark;
+
+    unsigned long m_Drops;
+
+    /*! \fn bool grow(void)
+     * \brief Allocates the next slab into the free list
+     * \return bool: false if the pool has reached its size
+     * \private
+     */
+    bool grow(void);
+};
+
+
+#endif /* _PACKETPOOL_H_ */
@@ -8,15 +8,18 @@
 
 #include "PacketProcessor.hpp"
 #include "ReportGlobals.hpp"
+#include <cstring>
 
 
-PacketProcessor::PacketProcessor(const char *p_Name):m_DestinationIP("127.0.0.2"), m_SourceIP("127.0.0.1"), m_Payload("--"), m_Valid(false), m_Converter(p_Name), m_Identification(0)
+PacketProcessor::PacketProcessor(const char *p_Name):m_DestinationIP("127.0.0.2"), m_DestinationAddress(0), m_SourceIP("127.0.0.1"), m_Payload("--"), m_Valid(false), m_Converter(p_Name), m_Identification(0), m_BurstChecksums(NULL), m_BurstCapacity(0)
 {
+    memset(m_EmptyBuffer, 0, MTU);
     resetPacketBuffer();
 }
 
 PacketProcessor::~PacketProcessor()
 {
+    delete[] m_BurstChecksums;
 
 }
 
@@ -98,94 +101,115 @@ bool PacketProcessor::processFrame(Packet& p_Frame)
     //invalidate the packet by default
     m_Valid = false;    
     //invalidate the destination IP by default
-    m_DestinationIP = ""; 
-    //reset the processing buffer
-    resetPacketBuffer();
-    //get IP packet from the frame
-    p_Frame.getPDU(m_PacketBuffer);
-
-    //VALIDATE THE PACKET
+    m_DestinationAddress = 0;
+    //process the IP packet of the frame in place
+    m_PacketBuffer = p_Frame.getPDU();
 
-
-    //check the link layer length 
-    if((readShort(&m_PacketBuffer[3])) < MIN_LENGTH)
+    //a frame without a PDU is dropped silently
+    if(m_PacketBuffer == NULL)
         {
-            //Report and drop
-            m_Converter.newReportString("Ilegal link layer length for packet: \n");
-            m_Converter.appendReportString(readIPPacket());
             resetPacketBuffer();
-            SC_REPORT_WARNING(g_ErrorID, m_Converter.getReportString());
             return false;
         }
 
-    //verify checksum
-    if(!(confirmCheckSum()))    
+    //VALIDATE THE PACKET
+    const char *l_Error = validateHeader();
+    if(l_Error != NULL)
         {
             //Report and drop
-            m_Converter.newReportString("Invalid CheckSum for packet: \n");
-            m_Converter.appendReportString(readIPPacket());
+            reportDrop(l_Error);
             resetPacketBuffer();
-            SC_REPORT_WARNING(g_ErrorID, m_Converter.getReportString());
             return false;
         }
+    //store the destination address
+    m_DestinationAddress = readAddress(&m_PacketBuffer[16]);
+    //validate the packet
+    m_Valid = true;
+    return true;
+}
 
-    //verify the version
-    if((readSubField(m_PacketBuffer[0], 7, 4) != VERSION))    
-        {
-            //Report and drop
-            m_Converter.newReportString("Invalid protocol version for packet: \n");
-            m_Converter.appendReportString(readIPPacket());
-            resetPacketBuffer();
-            SC_REPORT_WARNING(g_ErrorID, m_Converter.getReportString());
-            return false;
-        }
+/*! \sa PacketProcessor
+ */
+const char *PacketProcessor::validateHeader(void)
+{
+    const char *l_Error = validateFields();
+    if(l_Error != NULL)
+        return l_Error;
 
-    //verify the IHL
-    if((readSubField(m_PacketBuffer[0], 3, 0) < 5))
-        {
-            //Report and drop
-            m_Converter.newReportString("Ilegal header length for packet: \n");
-            m_Converter.appendReportString(readIPPacket());
-            resetPacketBuffer();
-            SC_REPORT_WARNING(g_ErrorID, m_Converter.getReportString());
-            return false;
-        }
-        
-    //verify the maximum length of the packet
-    if((readShort(&m_PacketBuffer[3])) > MAX_LENGTH)    
+    if(!Checksum::verify(m_PacketBuffer, (m_PacketBuffer[0] & 0x0F)*4))
+        return "Invalid CheckSum for packet";
+
+    return NULL;
+}
+
+/*! \sa PacketProcessor
+ */
+const char *PacketProcessor::validateFields(void)
+{
+    //the first octet holds the version and the IHL
+    unsigned l_IHL = m_PacketBuffer[0] & 0x0F;
+    if((m_PacketBuffer[0] >> 4) != VERSION)
+        return "Invalid protocol version for packet";
+
+    //the total length is in network byte order
+    unsigned l_Length = ((unsigned)m_PacketBuffer[2] << 8) | m_PacketBuffer[3];
+    if(l_Length < MIN_LENGTH)
+        return "Ilegal link layer length for packet";
+
+    if(l_IHL < IHL || l_IHL*4 > l_Length)
+        return "Ilegal header length for packet";
+
+    //the packet has to fit in the PDU
+    if(l_Length > MTU)
+        return "The packet length is too long";
+
+    return NULL;
+}
+
+/*! \sa PacketProcessor
+ */
+void PacketProcessor::reportDrop(const char *p_Reason)
+{
+    m_Converter.newReportString(p_Reason);
+    //the packet is written in the report only when debugging
+    if(sc_report_handler::get_verbosity_level() >= SC_DEBUG)
         {
-            //Report and drop
-            m_Converter.newReportString("The packet length is too long: \n");
+            m_Converter.appendReportString(": \n");
             m_Converter.appendReportString(readIPPacket());
-            resetPacketBuffer();
-            SC_REPORT_WARNING(g_ErrorID, m_Converter.getReportString());
-            return false;
         }
-    //store the destination address
-    m_DestinationIP = m_Converter.ipToString(&m_PacketBuffer[16]);
-    //validate the packet
-    m_Valid = true;
-    return true;
+    SC_REPORT_WARNING(g_ErrorID, m_Converter.getReportString());
 }
 
 /*! \sa PacketProcessor
  */
-string PacketProcessor::getDestination(void)
+unsigned PacketProcessor::getDestinationAddress(void)
 {
     
     //return
-    return m_DestinationIP;
+    return m_DestinationAddress;
 }
 
 /*! \sa PacketProcessor
  */
-bool PacketProcessor::forward(Packet *p_Frame)
+string PacketProcessor::getDestination(void)
 {
+    return m_Converter.uIntToIp(m_DestinationAddress);
+}
 
+/*! \sa PacketProcessor
+ */
+bool PacketProcessor::forward(Packet *p_Frame)
+{
+    //only the packet validated by processFrame can be forwarded
+    if(!m_Valid || m_PacketBuffer != p_Frame->getPDU())
+        return false;
+    m_Valid = false;
 
-    if(incrementalCheckSumUpdate())
+    //the TTL and the checksum are updated in the PDU of the frame,
+    //which is copied first if other frames share it
+    unsigned char *l_PDU = p_Frame->mutablePDU();
+    if(l_PDU != NULL && incrementalCheckSumUpdate(l_PDU))
         {
-            p_Frame->setPDU(m_PacketBuffer);
             resetPacketBuffer();
             return true;
         }
@@ -194,6 +218,89 @@ bool PacketProcessor::forward(Packet *p_Frame)
         return false;
 }
 
+/*! \sa PacketProcessor
+ */
+int PacketProcessor::forwardBurst(Packet *p_Frames, int p_Count, bool *p_Ready)
+{
+    if(p_Count <= 0)
+        return 0;
+
+    if(p_Count > m_BurstCapacity)
+        {
+            delete[] m_BurstChecksums;
+            m_BurstChecksums = new bool[p_Count];
+            m_BurstHeaders.resize(p_Count);
+            m_BurstLengths.resize(p_Count);
+            m_BurstFrames.resize(p_Count);
+            m_BurstCapacity = p_Count;
+        }
+
+    //check the header fields of the IP packets
+    int l_Checked = 0;
+    for (int i = 0; i < p_Count; i++)
+        {
+            p_Ready[i] = false;
+            if(p_Frames[i].getProtocolType() != TYPE_IP)
+                continue;
+            m_PacketBuffer = p_Frames[i].getPDU();
+            if(m_PacketBuffer == NULL)
+                continue;
+
+            const char *l_Error = validateFields();
+            if(l_Error != NULL)
+                {
+                    reportDrop(l_Error);
+                    continue;
+                }
+            m_BurstHeaders[l_Checked] = m_PacketBuffer;
+            m_BurstLengths[l_Checked] = (m_PacketBuffer[0] & 0x0F)*4;
+            m_BurstFrames[l_Checked] = i;
+            l_Checked++;
+        }
+
+    //verify the checksums of the burst at once
+    Checksum::verifyBatch(&m_BurstHeaders[0], &m_BurstLengths[0], l_Checked, m_BurstChecksums);
+
+    int l_ReadyCount = 0;
+    for (int j = 0; j < l_Checked; j++)
+        {
+            m_PacketBuffer = m_BurstHeaders[j];
+            if(!m_BurstChecksums[j])
+                {
+                    reportDrop("Invalid CheckSum for packet");
+                    continue;
+                }
+            //the TTL and the checksum are updated in place, in a
+            //copy of the PDU if other frames share it
+            unsigned char *l_PDU = p_Frames[m_BurstFrames[j]].mutablePDU();
+            if(l_PDU != NULL && incrementalCheckSumUpdate(l_PDU))
+                {
+                    p_Ready[m_BurstFrames[j]] = true;
+                    l_ReadyCount++;
+                }
+        }
+
+    resetPacketBuffer();
+    return l_ReadyCount;
+}
+
+/*! \sa PacketProcessor
+ */
+unsigned PacketProcessor::getDestinationAddress(Packet& p_Frame)
+{
+    const unsigned char *l_PDU = p_Frame.getPDU();
+    if(l_PDU == NULL)
+        return 0;
+    return readAddress(&l_PDU[16]);
+}
+
+/*! \sa PacketProcessor
+ */
+void PacketProcessor::setPacketPool(PacketPool *p_Pool)
+{
+    m_Frame.setPacketPool(p_Pool);
+}
+
 /*! \sa PacketProcessor
  */
 Packet& PacketProcessor::buildIPPacket(string p_DestinationIP, string p_SourceIP, string p_Payload)
@@ -203,40 +310,48 @@ Packet& PacketProcessor::buildIPPacket(string p_DestinationIP, string p_SourceIP
     m_DestinationIP = p_DestinationIP;
     m_SourceIP = p_SourceIP;
     m_Payload = p_Payload;    
+
+    //build the packet directly into a new frame
+    m_Frame.clearPacket();
+    if(!m_Frame.allocatePDU())
+        {
+            //the pool is exhausted and the packet is dropped
+            resetPacketBuffer();
+            return m_Frame;
+        }
+    unsigned char *l_PacketBuffer = m_Frame.mutablePDU();
    
     //set version
-    m_PacketBuffer[0] = (unsigned char)setSubField((unsigned)m_PacketBuffer[0], VERSION, 7, 4);
+    l_PacketBuffer[0] = (unsigned char)setSubField((unsigned)l_PacketBuffer[0], VERSION, 7, 4);
 
     //set standard header length
-    m_PacketBuffer[0] = (unsigned char)setSubField((unsigned)m_PacketBuffer[0], IHL, 3, 0);
+    l_PacketBuffer[0] = (unsigned char)setSubField((unsigned)l_PacketBuffer[0], IHL, 3, 0);
 
     //set the second field to zero (DSCP[7-2] and ECN[1-0])
 
     //set identification
-    setMultipleFields(&m_PacketBuffer[5], m_Identification++, SHORT);
+    setMultipleFields(&l_PacketBuffer[5], m_Identification++, SHORT);
     //set flags
-    clearBit(&m_PacketBuffer[6], 7); //reserved
-    clearBit(&m_PacketBuffer[6], 6); //Don't fragment DF
-    clearBit(&m_PacketBuffer[6], 5); //More fragments MF
+    clearBit(&l_PacketBuffer[6], 7); //reserved
+    clearBit(&l_PacketBuffer[6], 6); //Don't fragment DF
+    clearBit(&l_PacketBuffer[6], 5); //More fragments MF
     //set fragment offset
 
     //set TTL
-    m_PacketBuffer[8] = TTL;
+    l_PacketBuffer[8] = TTL;
     //set Protocol
-    m_PacketBuffer[9] = PROTOCOL;
+    l_PacketBuffer[9] = PROTOCOL;
 
     //set source IP
-    m_Converter.ipToUChar(m_SourceIP, &m_PacketBuffer[12]);
+    m_Converter.ipToUChar(m_SourceIP, &l_PacketBuffer[12]);
     //set destination IP
-    m_Converter.ipToUChar(m_DestinationIP, &m_PacketBuffer[16]);
+    m_Converter.ipToUChar(m_DestinationIP, &l_PacketBuffer[16]);
 
 
     //set paylod and packet length
-    setMultipleFields(&m_PacketBuffer[3], setPayload(&m_PacketBuffer[20]), SHORT);    
+    setMultipleFields(&l_PacketBuffer[3], setPayload(&l_PacketBuffer[20]), SHORT);    
 
-    addCheckSum(m_PacketBuffer);
-    //set the IP packet into the frame
-    m_Frame.setPDU(m_PacketBuffer);
+    addCheckSum(l_PacketBuffer);
     resetPacketBuffer();
 
     return m_Frame;
@@ -305,7 +420,7 @@ void PacketProcessor::setMultipleFields(unsigned char *ptr_PacketBuffer, unsigne
  
 /*! \sa PacketProcessor
  */
-unsigned short PacketProcessor::readShort(unsigned char *ptr_PacketBuffer)
+unsigned short PacketProcessor::readShort(const unsigned char *ptr_PacketBuffer)
 {
     
     unsigned short l_16b = 0;
@@ -318,6 +433,14 @@ unsigned short PacketProcessor::readShort(unsigned char *ptr_PacketBuffer)
     return l_16b;
 }
 
+/*! \sa PacketProcessor
+ */
+unsigned PacketProcessor::readAddress(const unsigned char *ptr_PacketBuffer)
+{
+    //the address is in network byte order
+    return ((unsigned)ptr_PacketBuffer[0] << 24) | ((unsigned)ptr_PacketBuffer[1] << 16) | ((unsigned)ptr_PacketBuffer[2] << 8) | ptr_PacketBuffer[3];
+}
+
 /*! \sa PacketProcessor
  */
 bool PacketProcessor::readBit(unsigned p_Field, unsigned p_BitPosition)
@@ -381,7 +504,7 @@ unsigned PacketProcessor::setPayload(unsigned char *ptr_PacketBuffer)
     for (unsigned i = 0; j < m_Payload.length(); i++)
         {
             //trunkate the message if it is too long
-            if(i == MTU)
+            if(i == MTU - HEADER_LENGTH)
                 break;
             ptr_PacketBuffer[i] = (unsigned char)m_Payload[j++];
         }
@@ -394,74 +517,23 @@ unsigned PacketProcessor::setPayload(unsigned char *ptr_PacketBuffer)
     
 }
 
-/*! \sa PacketProcessor
- */
-unsigned short PacketProcessor::calculateCheckSum(unsigned char *ptr_PacketBuffer)
-{
-    //checksum temp-store
-    unsigned short l_16b=0;
-    unsigned l_32b=0;
-    //sum the header fields in chunks of short
-    for (int i = 1; i < HEADER_LENGTH; i += 2)
-        {
-            //read next short from the header
-            l_16b = readShort(&ptr_PacketBuffer[i]);
-
-            //add it with the previous short
-            l_32b += l_16b;            
-        }
-
-
-    //Store low order bits
-    l_16b = 0;
-    l_16b |= l_32b;
-
-    //shift the carry bits
-    l_32b >>= 16;
-
-    //add the carry bits and low order bits
-    l_16b += l_32b;
-    return l_16b;    
-
-}
-
 /*! \sa PacketProcessor
  */
 void PacketProcessor::addCheckSum(unsigned char *ptr_PacketBuffer)
 {
     
-    //sum the header fields
-    unsigned short l_16b = calculateCheckSum(ptr_PacketBuffer);
-
-    //inverse the sum
-
-    l_16b = ~l_16b;
-
-    //set the result to the checksum field of the header
-    setMultipleFields(&ptr_PacketBuffer[CHECKSUM_FIELD], l_16b, SHORT);
+    //sum the header and set the inverse of the sum to the checksum
+    //field. CHECKSUM_FIELD is the low order octet of the field
+    Checksum::fill(ptr_PacketBuffer, HEADER_LENGTH, CHECKSUM_FIELD-1);
 }
 
 
-/*! \sa PacketProcessor
- */
-bool PacketProcessor::confirmCheckSum(void)
-{
-    //perform the first portion of the checksum calculation
-    unsigned short l_Result = calculateCheckSum(m_PacketBuffer);
-    //check the result
-    if(l_Result != 0xFFFF)
-        return false;//The l_Result was not all ones: Checksum is not valid
-    else
-        return true;//The l_Result was all ones: Checksum is valid
-}
-
 /*! \sa PacketProcessor
  */
 void PacketProcessor::resetPacketBuffer(void)
 {
-    //initialize all fields to zero
-    for (int i = 0; i < MTU; i++)
-        m_PacketBuffer[i] = 0;
+    //the processed frame is not touched
+    m_PacketBuffer = m_EmptyBuffer;
 }
 
 /*! \sa PacketProcessor
@@ -474,46 +546,25 @@ unsigned short PacketProcessor::readFragmentOffSet(void)
 
 /*! \sa PacketProcessor
  */
-bool PacketProcessor::incrementalCheckSumUpdate(void)
+bool PacketProcessor::incrementalCheckSumUpdate(unsigned char *p_Header)
 {
-
-    unsigned l_HCP = 0;
-    unsigned short l_HC = readShort(&m_PacketBuffer[11]);
-    unsigned short l_m = readShort(&m_PacketBuffer[9]);
-
-
-
-
-    m_PacketBuffer[8] -= 1; 
-
-
-
-    if (m_PacketBuffer[8] <= 0)
+    //drop the packet whose TTL expires
+    if (p_Header[8] <= 1)
         {
             resetPacketBuffer();
             return false;
         }
 
-    unsigned short l_mP = readShort(&m_PacketBuffer[9]);
-
-
-    //perform the incremental update
-    l_HC = ~l_HC;
-
-    l_m = ~l_m;
-
-    l_HCP = l_HC + l_m + l_mP;
-
-    l_HC = (l_HCP&0xFFFF0000)>>16;
-
-    l_HCP &= 0x0000FFFF;
-
-    l_HC += l_HCP;
-
-    l_HC = ~l_HC;
-
+    //the TTL shares a 16 bit word with the protocol field. The words
+    //are handled in the host byte order like the checksum
+    uint16_t l_Old, l_New, l_Checksum;
+    memcpy(&l_Old, &p_Header[8], sizeof(l_Old));
+    p_Header[8] -= 1;
+    memcpy(&l_New, &p_Header[8], sizeof(l_New));
 
-    setMultipleFields(&m_PacketBuffer[11], l_HC, 2);
+    memcpy(&l_Checksum, &p_Header[10], sizeof(l_Checksum));
+    l_Checksum = Checksum::update(l_Checksum, l_Old, l_New);
+    memcpy(&p_Header[10], &l_Checksum, sizeof(l_Checksum));
     return true;
 }
 
@@ -15,8 +15,12 @@
 #include "systemc"
 #include "Packet.hpp"
 #include "StringTools.hpp"
+#include "Checksum.hpp"
+#include <stdint.h>
+#include <vector>
 
 using namespace std;
+using namespace sc_core;
 
 
 
@@ -88,7 +92,8 @@ public:
      * @param [in] string p_DestinationIP
      * @param [in] string p_SourceIP
      * @param [in] string p_Payload
-     * \return Packet& reference to the frame that contains the built packet
+     * \return Packet& reference to the frame that contains the built
+     * packet. The frame has no PDU if the packet pool is exhausted.
      * \public
      */
     Packet& buildIPPacket(string p_DestinationIP, string p_SourceIP, string p_Payload);
@@ -103,29 +108,70 @@ public:
     
     /*! \fn bool processFrame(Packet& p_Packet); 
      * \brief Validates an IP packet 
-     * \details Check whether the passed packet is a valid IP packet. 
+     * \details Check whether the passed packet is a valid IP packet.
+     * The PDU of the packet is read in place, so the packet shall
+     * exist until its processing is finished.
      * @param [in] Packet p_Packet IP packet to be processed
      * \return bool: true == Packet is valid || false == Packet is not valid
      * \public
      */
     bool processFrame(Packet& p_Packet);
 
-    /*! \fn string getDestination(void); 
+    /*! \fn unsigned getDestinationAddress(void); 
      * \brief Returns the destination of the processed packet
      * \details 
+     * \return unsigned: the destination IP address in host byte
+     * order or 0 if no valid packet has been processed
+     * \public
+     */
+    unsigned getDestinationAddress(void);
+
+    /*! \fn string getDestination(void); 
+     * \brief Returns the destination of the processed packet as string
+     * \details For the reports only
      * \return string: the destination IP address as string 
      * \public
      */
     string getDestination(void);
 
     /*! \fn bool forward(Packet *p_Frame);
-     * \brief copies the processed frame to the passed reference
-     * \details decrements the TTL and recalculates the checksum using the incremental method
-     * @param[out] Packet& p_Frame Reference to the object in which the processed frame should be copied 
+     * \brief Prepares the processed frame for forwarding
+     * \details decrements the TTL and recalculates the checksum using
+     * the incremental method. The header is rewritten in place.
+     * @param[in,out] Packet& p_Frame The frame passed to processFrame
      * \return bool true: packet is ready to be forwarded - false: packet was dropped
      * \public
      */
     bool forward(Packet *p_Frame);
+
+    /*! \fn int forwardBurst(Packet *p_Frames, int p_Count, bool *p_Ready)
+     * \brief Validates a burst of frames and prepares the valid IP
+     * packets for forwarding
+     * \details The header fields of each IP packet are checked first
+     * and the checksums of the remaining packets are verified at once.
+     * The TTL and the checksum of the valid packets are updated in
+     * place. Frames that do not carry IP are left untouched.
+     * @param [in,out] Packet *p_Frames The frames of the burst
+     * @param [in] int p_Count The number of frames
+     * @param [out] bool *p_Ready true for the frames to be forwarded
+     * \return int: the number of frames to be forwarded
+     * \public
+     */
+    int forwardBurst(Packet *p_Frames, int p_Count, bool *p_Ready);
+
+    /*! \fn unsigned getDestinationAddress(Packet& p_Frame)
+     * \brief Returns the destination of the IP packet in the frame
+     * \return unsigned: the destination IP address in host byte order
+     * \public
+     */
+    unsigned getDestinationAddress(Packet& p_Frame);
+
+    /*! \fn void setPacketPool(PacketPool *p_Pool)
+     * \brief Sets the pool from which the built packets take their buffers
+     * @param [in] PacketPool *p_Pool The pool of the owner module
+     * \public
+     */
+    void setPacketPool(PacketPool *p_Pool);
     
 private:
 
@@ -135,6 +181,13 @@ private:
      * \private
      */
     string m_DestinationIP;
+
+    /*! \property unsigned m_DestinationAddress
+     * \brief The destination IP of the processed packet in host byte
+     * order
+     * \private
+     */
+    unsigned m_DestinationAddress;
     
     /*! \property string m_SourceIP 
      * \brief The source IP of the packet
@@ -171,12 +224,20 @@ private:
      */
     StringTools m_Converter;  
 
-    /*! \property unsigned char m_PacketBuffer[MTU] 
-     * \brief Buffer for the IP packet being processed
-     * \details 
+    /*! \property const unsigned char *m_PacketBuffer
+     * \brief The IP packet being processed
+     * \details Points to the PDU of the frame being built or
+     * processed, or to m_EmptyBuffer if there is none
+     * \private
+     */
+    const unsigned char *m_PacketBuffer;
+
+    /*! \property unsigned char m_EmptyBuffer[MTU]
+     * \brief All zero packet
+     * \details Read when no frame is being processed
      * \private
      */
-    unsigned char m_PacketBuffer[MTU];
+    unsigned char m_EmptyBuffer[MTU];
 
     /*! \property unsinged short m_Identification 
      * \brief The packet identification value
@@ -184,6 +245,36 @@ private:
      * \private
      */
     unsigned short m_Identification;
+
+    /*! \property vector<const unsigned char *> m_BurstHeaders
+     * \brief The headers of a burst whose fields are valid
+     * \private
+     */
+    vector<const unsigned char *> m_BurstHeaders;
+
+    /*! \property vector<unsigned> m_BurstLengths
+     * \brief The header lengths of m_BurstHeaders
+     * \private
+     */
+    vector<unsigned> m_BurstLengths;
+
+    /*! \property vector<int> m_BurstFrames
+     * \brief The frame indexes of m_BurstHeaders
+     * \private
+     */
+    vector<int> m_BurstFrames;
+
+    /*! \property bool *m_BurstChecksums
+     * \brief The checksum results of m_BurstHeaders
+     * \private
+     */
+    bool *m_BurstChecksums;
+
+    /*! \property int m_BurstCapacity
+     * \brief The size of the burst arrays
+     * \private
+     */
+    int m_BurstCapacity;
     
     
     
@@ -239,14 +330,23 @@ private:
      */
     unsigned setPayload(unsigned char *ptr_PacketBuffer);
 
-    /*! \fn unsigned short readShort(unsigned char *ptr_PacketBuffer); 
+    /*! \fn unsigned short readShort(const unsigned char *ptr_PacketBuffer); 
      * \brief Reads a short value from the packetBuffer
      * \details The pointer to the packet buffer defines the loworderbyte ofthe short
      * @param [in] unsigned char *ptr_PacketBuffer 
      * \return unsigned short: the value read from the buffer 
      * \private
      */
-    unsigned short readShort(unsigned char *ptr_PacketBuffer);
+    unsigned short readShort(const unsigned char *ptr_PacketBuffer);
+
+    /*! \fn unsigned readAddress(const unsigned char *ptr_PacketBuffer)
+     * \brief Reads an IP address from the packet buffer
+     * \details The pointer defines the high order octet of the address
+     * @param [in] const unsigned char *ptr_PacketBuffer
+     * \return unsigned: the address in host byte order
+     * \private
+     */
+    unsigned readAddress(const unsigned char *ptr_PacketBuffer);
 
     /*! \fn bool readBit(unsigned p_Value, unsigned p_BitPosition); 
      * \brief Reads the bit from the p_Value field in position defined by p_BitPosition 
@@ -282,20 +382,6 @@ private:
     unsigned buildSubFieldMask(unsigned p_MSB, unsigned p_LSB);
     
 
-    /*! \fn void calculateCheckSum(unsigned_char p_PacketBuffer); 
-     * \brief The common portion of the checksum calculation
-     * \details Divides the IP header into 16 bit fields, sums up
-     * those fields to a 32 bit field, and finally sums the 16 bit high order
-     * portion of the 32 bit field to the remaining low order portion and
-     * returns the sum
-     * @param [in] unsigned_char p_PacketBuffer  
-     * \return unsigned short: the first part of the header sum
-     * calculation: adding header fields in 16bit blocks and the sum
-     * of the carries and the loworder portion.
-     * \private
-     */
-    unsigned short calculateCheckSum(unsigned char *ptr_PacketBuffer);
-
     /*! \fn void addCheckSum(unsigned char *ptr_PacketBuffer); 
      * \brief Calculates and adds the check sum to the given IP packet
      * \details 
@@ -304,26 +390,48 @@ private:
      */
     void  addCheckSum(unsigned char *ptr_PacketBuffer);
 
-    /*! \fn bool confirmCheckSum(void); 
-     * \brief Confirms that the checksum of the IP packet in m_Frame is
-     * valid
-     * \details 
-     * \return bool: true - checksum is valid | false - check sum is not valid 
+    /*! \fn const char *validateHeader(void);
+     * \brief Validates the version, IHL, length and checksum of the
+     * IP packet pointed by m_PacketBuffer
+     * \details The fields are read straight from the octets and the
+     * checksum is verified by the Checksum module
+     * \return const char *: NULL if the header is valid, otherwise the
+     * reason to drop the packet
      * \private
      */
-    bool confirmCheckSum(void);
+    const char *validateHeader(void);
 
-    /*! \fn bool incremetalCheckSumUpdate(void); 
-     * \brief Recalculates the checksum value using the incremental method
-     * \details 
+    /*! \fn const char *validateFields(void);
+     * \brief Validates the version, IHL and length of the IP packet
+     * pointed by m_PacketBuffer
+     * \return const char *: NULL if the fields are valid, otherwise the
+     * reason to drop the packet
+     * \private
+     */
+    const char *validateFields(void);
+
+    /*! \fn void reportDrop(const char *p_Reason)
+     * \brief Reports the drop of the packet pointed by m_PacketBuffer
+     * \details The packet is written in the report only when the
+     * verbosity level is SC_DEBUG
+     * \private
+     */
+    void reportDrop(const char *p_Reason);
+
+    /*! \fn bool incrementalCheckSumUpdate(unsigned char *p_Header)
+     * \brief Decrements the TTL and updates the checksum using the
+     * incremental method of RFC 1624
+     * \details The header shall be the writable PDU of the forwarded
+     * frame, see Packet::mutablePDU
+     * @param [in/out] unsigned char *p_Header The IP header
      * \return bool true: packet is ready to be forwarded - false: packet was dropped
      * \private
      */
-    bool incrementalCheckSumUpdate(void);
+    bool incrementalCheckSumUpdate(unsigned char *p_Header);
 
     /*! \fn void resetPacketBuffer(void) 
-     * \brief Resets all the fields in the m_PacketBuffer array
-     * \details 
+     * \brief Detaches m_PacketBuffer from the processed frame
+     * \details m_PacketBuffer is set to point to the all zero packet
      * \private
      */
     void resetPacketBuffer(void);
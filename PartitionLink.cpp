@@ -0,0 +1,157 @@
+/*! \file PartitionLink.cpp
+ *  \brief     Implementation of PartitionLink module.
+ *  \details
+ */
+
+
+#include "PartitionLink.hpp"
+#include "ReportGlobals.hpp"
+#include <cstring>
+#include <sstream>
+
+
+PartitionLink::PartitionLink(sc_module_name p_ModuleName, PartitionChannel *p_Outbound, PartitionChannel *p_Inbound, const sc_time& p_Window):sc_module(p_ModuleName), m_Outbound(p_Outbound), m_Inbound(p_Inbound), m_Window(p_Window), m_PacketPool(PARTITION_CHANNEL_SIZE), m_LinkState(false), m_SentFrames(0), m_ReceivedFrames(0), m_DroppedFrames(0), m_Overflows(0)
+{
+    SC_THREAD(linkMain);
+}
+
+PartitionLink::~PartitionLink()
+{
+}
+
+void PartitionLink::linkMain(void)
+{
+    //the frames drained at the window boundary are delivered between
+    //the clock edges
+    wait(m_Window/2);
+    while(true)
+        {
+            while(!m_Arrived.empty())
+                {
+                    port_Local->forward(m_Arrived.front());
+                    m_Arrived.pop_front();
+                }
+            wait(m_Window);
+        }
+}
+
+bool PartitionLink::forward(Packet& p_Packet)
+{
+    if(!m_LinkState)
+        {
+            m_DroppedFrames++;
+            return false;
+        }
+
+    struct_PartitionRecord *l_Record = m_Outbound->claim();
+    if(l_Record == NULL)
+        {
+            if(m_Overflows++ == 0)
+                SC_REPORT_WARNING(g_ErrorID, "The channel to another partition is full");
+            return false;
+        }
+
+    //the copy shares the PDU, so decoding its UPDATE leaves the frame
+    //intact
+    Packet l_Frame(p_Packet);
+    BGPMessage& l_Msg = l_Frame.getBGPPayload();
+
+    l_Record->protocolType = l_Frame.getProtocolType();
+    l_Record->type = l_Msg.m_Type;
+    l_Record->AS = l_Msg.m_AS;
+    l_Record->holdDownTime = l_Msg.m_HoldDownTime;
+    l_Record->outboundInterface = l_Msg.m_OutboundInterface;
+    l_Record->msgId = l_Msg.m_MsgId;
+    l_Record->epoch = l_Msg.m_Epoch;
+    strncpy(l_Record->BGPIdentifier, l_Msg.m_BGPIdentifier.c_str(), PARTITION_IDENTIFIER_LENGTH - 1);
+    l_Record->BGPIdentifier[PARTITION_IDENTIFIER_LENGTH - 1] = '\0';
+    l_Record->hasPDU = l_Frame.hasPDU();
+    if(l_Record->hasPDU)
+        l_Frame.getPDU(l_Record->PDU);
+
+    m_Outbound->commit();
+    m_SentFrames++;
+    return true;
+}
+
+void PartitionLink::receive(void)
+{
+    const struct_PartitionRecord *l_Record;
+    while((l_Record = m_Inbound->front()) != NULL)
+        {
+            BGPMessage l_Msg;
+            l_Msg.m_Type = l_Record->type;
+            l_Msg.m_AS = l_Record->AS;
+            l_Msg.m_HoldDownTime = l_Record->holdDownTime;
+            l_Msg.m_OutboundInterface = l_Record->outboundInterface;
+            l_Msg.m_MsgId = l_Record->msgId;
+            l_Msg.m_Epoch = l_Record->epoch;
+            l_Msg.m_BGPIdentifier = l_Record->BGPIdentifier;
+            if(l_Msg.m_Type == UPDATE && !l_Msg.m_Update.decode(l_Record->PDU, MTU))
+                l_Msg.m_Update.clear();
+
+            Packet l_Frame;
+            l_Frame.setPacketPool(&m_PacketPool);
+            l_Frame.setProtocolType(l_Record->protocolType);
+            bool l_Stored = l_Frame.setBGPPayload(l_Msg);
+            if(l_Stored && l_Record->hasPDU && l_Msg.m_Type != UPDATE)
+                l_Stored = l_Frame.setPDU(l_Record->PDU);
+            m_Inbound->release();
+
+            if(!l_Stored)
+                {
+                    if(m_Overflows++ == 0)
+                        SC_REPORT_WARNING(g_ErrorID, "No buffer for a frame from another partition");
+                    continue;
+                }
+            m_Arrived.push_back(l_Frame);
+            m_ReceivedFrames++;
+        }
+}
+
+string PartitionLink::getStatistics(void)
+{
+    ostringstream l_Stats;
+    l_Stats << m_SentFrames << "," << m_ReceivedFrames << "," << m_DroppedFrames << "," << m_Overflows;
+    return l_Stats.str();
+}
+
+unsigned long PartitionLink::getOverflows(void)
+{
+    return m_Overflows;
+}
+
+void PartitionLink::interfaceDown(void)
+{
+    m_LinkState = false;
+    m_StateChanged.notify(SC_ZERO_TIME);
+}
+
+bool PartitionLink::interfaceUp(void)
+{
+    m_LinkState = true;
+    m_StateChanged.notify(SC_ZERO_TIME);
+    return m_LinkState;
+}
+
+bool PartitionLink::isUp(void)
+{
+    return m_LinkState;
+}
+
+void PartitionLink::killInterface(void)
+{
+    interfaceDown();
+    m_Arrived.clear();
+}
+
+void PartitionLink::resetInterface(void)
+{
+    killInterface();
+    interfaceUp();
+}
+
+const sc_event& PartitionLink::stateChangedEvent(void)
+{
+    return m_StateChanged;
+}
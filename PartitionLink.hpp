@@ -0,0 +1,208 @@
+/*! \file  PartitionLink.hpp
+ *  \brief     Header file of PartitionLink module
+ *  \details   Defines the link between two routers simulated in
+ *  different partitions
+ */
+
+/*!
+ * \class PartitionLink
+ * \brief Stands in for the interface of a router of another partition
+ *  \details The local router forwards its frames to this module as it
+ *  would to the neighbour's interface. The frames are serialized into
+ *  the outbound channel, which the neighbour's partition drains at the
+ *  end of each time window. The frames of the inbound channel are
+ *  drained by receive() between the windows and delivered to the local
+ *  router half a clock period later, so that they are read by the data
+ *  plane on the same clock edge as in the single kernel run.
+ *
+ *  A frame that does not fit into the outbound channel or into a packet
+ *  buffer of the link is lost, which the single kernel run would not
+ *  do. Such overflows are reported, and a partition whose links have
+ *  overflowed fails.
+ */
+
+
+#include "systemc"
+#include "Packet.hpp"
+#include "PacketPool.hpp"
+#include "Interface_If.hpp"
+#include "SPSCRing.hpp"
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+
+
+#ifndef _PARTITIONLINK_H_
+#define _PARTITIONLINK_H_
+
+/*!
+ * The maximum length of the BGP identifier in a record
+ */
+#define PARTITION_IDENTIFIER_LENGTH 32
+
+/*!
+ * The number of records in a channel. Shall be a power of two.
+ */
+#define PARTITION_CHANNEL_SIZE 256
+
+
+/*!
+ * \brief A frame serialized for a channel between partitions
+ * \details The record has no pointers so that it can be placed into
+ * memory shared by the partitions. The path attributes of an UPDATE
+ * travel in the PDU in the BGP wire format.
+ */
+struct struct_PartitionRecord
+{
+    int protocolType;
+    int type;
+    int AS;
+    int holdDownTime;
+    int outboundInterface;
+    unsigned long msgId;
+    unsigned long epoch;
+    char BGPIdentifier[PARTITION_IDENTIFIER_LENGTH];
+    bool hasPDU;
+    unsigned char PDU[MTU];
+};
+
+typedef SPSCRing<struct_PartitionRecord> PartitionChannel;
+
+/*!
+ * \brief The channels between the partitions
+ * \details The key is the router and the interface that send into the
+ * channel
+ */
+typedef map<pair<int, int>, PartitionChannel*> PartitionChannelMap;
+
+
+class PartitionLink: public sc_module, public Interface_If
+{
+
+public:
+
+    /*! \brief The receiving interface of the local router
+     * \public
+     */
+    sc_port<Interface_If> port_Local;
+
+    /*! \fn PartitionLink(sc_module_name p_ModuleName, PartitionChannel *p_Outbound, PartitionChannel *p_Inbound, const sc_time& p_Window)
+     * \brief Link constructor
+     * @param [in] PartitionChannel *p_Outbound The channel towards the
+     * neighbour
+     * @param [in] PartitionChannel *p_Inbound The channel from the
+     * neighbour
+     * @param [in] const sc_time& p_Window The length of the time window
+     * \public
+     */
+    PartitionLink(sc_module_name p_ModuleName, PartitionChannel *p_Outbound, PartitionChannel *p_Inbound, const sc_time& p_Window);
+
+    ~PartitionLink();
+
+    /*!
+     * \sa Interface_If
+     */
+    virtual bool forward(Packet& p_Packet);
+
+    /*!
+     * \sa Interface_If
+     */
+    virtual void interfaceDown(void);
+
+    /*!
+     * \sa Interface_If
+     */
+    virtual bool interfaceUp(void);
+
+    /*!
+     * \sa Interface_If
+     */
+    virtual bool isUp(void);
+
+    /*!
+     * \sa Interface_If
+     */
+    virtual void killInterface(void);
+
+    /*!
+     * \sa Interface_If
+     */
+    virtual void resetInterface(void);
+
+    /*!
+     * \sa Interface_If
+     */
+    virtual const sc_event& stateChangedEvent(void);
+
+    /*! \fn void receive(void)
+     *  \brief Drains the inbound channel
+     *  \details Shall be called between the time windows only
+     * \public
+     */
+    void receive(void);
+
+    /*! \fn string getStatistics(void)
+     *  \brief Returns the frame counters of the link
+     *  \details Syntax: sent,received,dropped,overflows. The dropped
+     *  frames were forwarded while the link was down.
+     * \public
+     */
+    string getStatistics(void);
+
+    /*! \fn unsigned long getOverflows(void)
+     *  \brief Returns the number of frames that did not fit into the
+     *  outbound channel or into a packet buffer
+     * \public
+     */
+    unsigned long getOverflows(void);
+
+    SC_HAS_PROCESS(PartitionLink);
+
+private:
+
+    /*! \fn void linkMain(void)
+     *  \brief Delivers the received frames in the middle of each clock
+     *  period
+     * \private
+     */
+    void linkMain(void);
+
+    PartitionChannel *m_Outbound;
+
+    PartitionChannel *m_Inbound;
+
+    sc_time m_Window;
+
+    /*! \property deque<Packet> m_Arrived
+     * \brief The frames waiting for delivery
+     * \private
+     */
+    deque<Packet> m_Arrived;
+
+    /*! \property PacketPool m_PacketPool
+     * \brief The buffers of the received frames
+     * \private
+     */
+    PacketPool m_PacketPool;
+
+    bool m_LinkState;
+
+    sc_event m_StateChanged;
+
+    unsigned long m_SentFrames;
+
+    unsigned long m_ReceivedFrames;
+
+    unsigned long m_DroppedFrames;
+
+    unsigned long m_Overflows;
+};
+
+
+#endif /* _PARTITIONLINK_H_ */
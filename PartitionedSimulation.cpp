@@ -0,0 +1,461 @@
+/*! \file PartitionedSimulation.cpp
+ *  \brief     Implementation of PartitionedSimulation class.
+ *  \details
+ */
+
+
+#include "PartitionedSimulation.hpp"
+#include "ReportGlobals.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <csignal>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*!
+ * \brief Rounds the size up to a multiple of a cache line
+ */
+static size_t alignSize(size_t p_Size)
+{
+    return (p_Size + 63) & ~(size_t)63;
+}
+
+
+PartitionedSimulation::PartitionedSimulation(SimulationConfig * const p_SimuConfiguration, int p_NumberOfPartitions):m_SimuConfiguration(p_SimuConfiguration), m_Window(1, SC_SEC), m_SharedMemory(NULL), m_SharedSize(0), m_Barrier(NULL)
+{
+    m_NumberOfPartitions = p_NumberOfPartitions;
+    if(m_NumberOfPartitions > m_SimuConfiguration->getNumberOfRouters())
+        m_NumberOfPartitions = m_SimuConfiguration->getNumberOfRouters();
+    if(m_NumberOfPartitions < 1)
+        m_NumberOfPartitions = 1;
+
+    assignRouters();
+    if(!allocateChannels())
+        SC_REPORT_WARNING(g_ErrorID, "Allocating the channels between the partitions failed");
+}
+
+PartitionedSimulation::~PartitionedSimulation()
+{
+    if(m_SharedMemory == NULL)
+        return;
+
+    for(PartitionChannelMap::iterator it = m_Channels.begin(); it != m_Channels.end(); ++it)
+        it->second->~PartitionChannel();
+    pthread_barrier_destroy(m_Barrier);
+    munmap(m_SharedMemory, m_SharedSize);
+}
+
+/*! \sa PartitionedSimulation
+ */
+bool PartitionedSimulation::run(const sc_time& p_Duration, const vector<struct_ScheduledCommand>& p_Commands, const string& p_ResultsFile)
+{
+    vector<pid_t> l_Children;
+    chrono::steady_clock::time_point l_WallClockStart = chrono::steady_clock::now();
+
+    //the buffered output would be written by every child
+    cout.flush();
+
+    for(int i = 0; i < m_NumberOfPartitions; i++)
+        {
+            pid_t l_Pid = fork();
+            if(l_Pid == 0)
+                {
+                    int l_Status = runPartition(i, p_Duration, p_Commands, p_ResultsFile);
+                    cout.flush();
+                    //the child leaves the clean up of the shared state
+                    //to the parent
+                    _exit(l_Status);
+                }
+            if(l_Pid < 0)
+                {
+                    SC_REPORT_WARNING(g_ErrorID, "Starting a partition failed");
+                    //the started partitions would wait for it forever
+                    for(unsigned j = 0; j < l_Children.size(); j++)
+                        kill(l_Children[j], SIGTERM);
+                    for(unsigned j = 0; j < l_Children.size(); j++)
+                        waitpid(l_Children[j], NULL, 0);
+                    return false;
+                }
+            l_Children.push_back(l_Pid);
+        }
+
+    bool l_Success = true;
+    for(unsigned l_Running = l_Children.size(); l_Running > 0; l_Running--)
+        {
+            int l_Status;
+            pid_t l_Pid = wait(&l_Status);
+            if(l_Pid < 0)
+                break;
+            if(!WIFEXITED(l_Status) || WEXITSTATUS(l_Status) != 0)
+                {
+                    if(l_Success)
+                        {
+                            SC_REPORT_WARNING(g_ErrorID, "A partition failed");
+                            //the others would wait for it at the barrier
+                            for(unsigned j = 0; j < l_Children.size(); j++)
+                                if(l_Children[j] != l_Pid)
+                                    kill(l_Children[j], SIGTERM);
+                        }
+                    l_Success = false;
+                }
+        }
+
+    double l_WallClock = chrono::duration<double>(chrono::steady_clock::now() - l_WallClockStart).count();
+    if(p_ResultsFile.empty())
+        return l_Success;
+    if(l_Success)
+        return mergeResults(p_ResultsFile, p_Commands, l_WallClock);
+
+    for(int i = 0; i < m_NumberOfPartitions; i++)
+        remove(getPartFileName(p_ResultsFile, i).c_str());
+    return false;
+}
+
+/*! \sa PartitionedSimulation
+ */
+int PartitionedSimulation::getNumberOfPartitions(void)
+{
+    return m_NumberOfPartitions;
+}
+
+/*! \sa PartitionedSimulation
+ */
+int PartitionedSimulation::getPartition(int p_RouterId)
+{
+    return m_Assignment[p_RouterId];
+}
+
+/*! \sa PartitionedSimulation
+ */
+int PartitionedSimulation::getDefaultNumberOfPartitions(void)
+{
+    long l_Count = sysconf(_SC_NPROCESSORS_ONLN);
+    return l_Count > 0 ? (int)l_Count : 1;
+}
+
+/*! \sa PartitionedSimulation
+ */
+void PartitionedSimulation::assignRouters(void)
+{
+    int l_Count = m_SimuConfiguration->getNumberOfRouters();
+    vector<bool> l_Visited(l_Count, false);
+    vector<int> l_Order;
+    deque<int> l_Queue;
+
+    //the order is deterministic: the roots and the neighbours are
+    //visited in the order of their indices
+    for(int l_Root = 0; l_Root < l_Count; l_Root++)
+        {
+            if(l_Visited[l_Root])
+                continue;
+            l_Visited[l_Root] = true;
+            l_Queue.push_back(l_Root);
+
+            while(!l_Queue.empty())
+                {
+                    int l_Router = l_Queue.front();
+                    l_Queue.pop_front();
+                    l_Order.push_back(l_Router);
+
+                    RouterConfig *l_Handle = m_SimuConfiguration->getRouterConfigurationPtr(l_Router);
+                    for(int j = 0; j < l_Handle->getNumberOfInterfaces(); j++)
+                        {
+                            if(!l_Handle->isConnection(j))
+                                continue;
+                            int l_Neighbor = l_Handle->getNeighborRouterId(j);
+                            if(l_Neighbor == 0x7FFFFFFF || l_Visited[l_Neighbor])
+                                continue;
+                            l_Visited[l_Neighbor] = true;
+                            l_Queue.push_back(l_Neighbor);
+                        }
+                }
+        }
+
+    //contiguous parts whose sizes differ by one at most
+    m_Assignment.assign(l_Count, 0);
+    for(int k = 0; k < l_Count; k++)
+        m_Assignment[l_Order[k]] = (int)((long)k * m_NumberOfPartitions / l_Count);
+}
+
+/*! \sa PartitionedSimulation
+ */
+bool PartitionedSimulation::allocateChannels(void)
+{
+    vector<pair<int, int> > l_Senders;
+
+    //a channel for each interface that sends to another partition
+    for(int i = 0; i < m_SimuConfiguration->getNumberOfRouters(); i++)
+        {
+            RouterConfig *l_Handle = m_SimuConfiguration->getRouterConfigurationPtr(i);
+            for(int j = 0; j < l_Handle->getNumberOfInterfaces(); j++)
+                {
+                    if(!l_Handle->isConnection(j))
+                        continue;
+                    int l_Neighbor = l_Handle->getNeighborRouterId(j);
+                    if(l_Neighbor != 0x7FFFFFFF && m_Assignment[l_Neighbor] != m_Assignment[i])
+                        l_Senders.push_back(make_pair(i, j));
+                }
+        }
+
+    size_t l_BarrierSize = alignSize(sizeof(pthread_barrier_t));
+    size_t l_RingSize = alignSize(sizeof(PartitionChannel));
+    size_t l_SlotsSize = alignSize(PARTITION_CHANNEL_SIZE * sizeof(struct_PartitionRecord));
+
+    //the mapping is inherited by the partitions, so the pointers into
+    //it are valid in every process
+    m_SharedSize = l_BarrierSize + l_Senders.size() * (l_RingSize + l_SlotsSize);
+    m_SharedMemory = mmap(NULL, m_SharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(m_SharedMemory == MAP_FAILED)
+        {
+            m_SharedMemory = NULL;
+            return false;
+        }
+
+    char *l_Region = (char *)m_SharedMemory;
+
+    pthread_barrierattr_t l_Attributes;
+    pthread_barrierattr_init(&l_Attributes);
+    pthread_barrierattr_setpshared(&l_Attributes, PTHREAD_PROCESS_SHARED);
+    m_Barrier = (pthread_barrier_t *)l_Region;
+    int l_Result = pthread_barrier_init(m_Barrier, &l_Attributes, m_NumberOfPartitions);
+    pthread_barrierattr_destroy(&l_Attributes);
+    if(l_Result != 0)
+        {
+            munmap(m_SharedMemory, m_SharedSize);
+            m_SharedMemory = NULL;
+            return false;
+        }
+    l_Region += l_BarrierSize;
+
+    for(unsigned k = 0; k < l_Senders.size(); k++)
+        {
+            struct_PartitionRecord *l_Slots = (struct_PartitionRecord *)(l_Region + l_RingSize);
+            m_Channels[l_Senders[k]] = new (l_Region) PartitionChannel(l_Slots, PARTITION_CHANNEL_SIZE);
+            l_Region += l_RingSize + l_SlotsSize;
+        }
+    return true;
+}
+
+/*! \sa PartitionedSimulation
+ */
+int PartitionedSimulation::runPartition(int p_PartitionId, const sc_time& p_Duration, const vector<struct_ScheduledCommand>& p_Commands, const string& p_ResultsFile)
+{
+    if(m_SharedMemory == NULL)
+        return 1;
+
+    //the resident size before the partition is built
+    struct rusage l_BaselineUsage;
+    getrusage(RUSAGE_SELF, &l_BaselineUsage);
+
+    //the partitions are not connected to a GUI
+    ServerSocket l_Socket;
+#ifndef _EVENT_DRIVEN
+    sc_clock l_Clock("clk", m_Window);
+#endif
+    Simulation l_Simulation("Test", l_Socket, m_SimuConfiguration, m_Assignment, p_PartitionId, m_Channels, m_Window);
+#ifndef _EVENT_DRIVEN
+    l_Simulation.port_Clk(l_Clock);
+#endif
+    for(unsigned i = 0; i < p_Commands.size(); i++)
+        l_Simulation.scheduleCommand(p_Commands[i]);
+
+    chrono::steady_clock::time_point l_WallClockStart = chrono::steady_clock::now();
+
+    //every partition runs the same sequence of windows, so they meet
+    //at the barrier equally many times
+    sc_time l_Step = m_Window/4;
+    while(sc_time_stamp() < p_Duration)
+        {
+            if(sc_time_stamp() + l_Step > p_Duration)
+                l_Step = p_Duration - sc_time_stamp();
+            sc_start(l_Step);
+
+            //all the frames of the window are in the channels
+            synchronize();
+            l_Simulation.receiveLinks();
+            //the channels are drained before the next window fills them
+            synchronize();
+
+            //a STOP command has no router, so all the partitions stop
+            //in the same window
+            if(l_Simulation.isStopped())
+                break;
+
+            l_Step = m_Window;
+        }
+    double l_WallClock = chrono::duration<double>(chrono::steady_clock::now() - l_WallClockStart).count();
+
+    int l_Status = 0;
+    if(l_Simulation.getLinkOverflows() > 0)
+        {
+            SC_REPORT_WARNING(g_ErrorID, "Frames between the partitions were lost");
+            l_Status = 1;
+        }
+
+    if(!p_ResultsFile.empty())
+        {
+            ofstream l_Results(getPartFileName(p_ResultsFile, p_PartitionId).c_str());
+            l_Simulation.writeUsage(l_Results, l_WallClock, l_BaselineUsage.ru_maxrss);
+            l_Simulation.writeResults(l_Results);
+            if(!l_Results)
+                {
+                    SC_REPORT_WARNING(g_ErrorID, "Cannot write the results of a partition");
+                    l_Status = 1;
+                }
+        }
+    return l_Status;
+}
+
+/*! \sa PartitionedSimulation
+ */
+bool PartitionedSimulation::mergeResults(const string& p_ResultsFile, const vector<struct_ScheduledCommand>& p_Commands, double p_WallClock)
+{
+    bool l_Success = true;
+    long l_Sessions = 0, l_PeakKB = 0, l_BaselineKB = 0, l_FixedKB = 0;
+    unsigned long l_Messages = 0;
+    vector<deque<string> > l_Commands(m_NumberOfPartitions);
+    vector<vector<vector<string> > > l_Phases(m_NumberOfPartitions);
+    map<int, string> l_Routers;
+    string l_Links;
+
+    for(int k = 0; k < m_NumberOfPartitions; k++)
+        {
+            string l_Name = getPartFileName(p_ResultsFile, k);
+            ifstream l_Part(l_Name.c_str());
+            if(!l_Part)
+                {
+                    SC_REPORT_WARNING(g_ErrorID, "Cannot read the results of a partition");
+                    l_Success = false;
+                    continue;
+                }
+
+            string l_Line;
+            while(getline(l_Part, l_Line))
+                {
+                    vector<string> l_Fields = ConfigurationParser::split(l_Line, ",");
+                    if(l_Fields.size() < 2)
+                        continue;
+
+                    if(l_Fields[0] == "WALL_CLOCK")
+                        continue;
+                    else if(l_Fields[0] == "MEMORY" && l_Fields.size() > 4)
+                        {
+                            l_Sessions += atol(l_Fields[1].c_str());
+                            l_PeakKB += atol(l_Fields[2].c_str());
+                            l_BaselineKB += atol(l_Fields[3].c_str());
+                            l_FixedKB += atol(l_Fields[4].c_str());
+                        }
+                    else if(l_Fields[0] == "THROUGHPUT")
+                        l_Messages += strtoul(l_Fields[1].c_str(), NULL, 10);
+                    else if(l_Fields[0] == "COMMAND")
+                        l_Commands[k].push_back(l_Line);
+                    else if(l_Fields[0] == "CONVERGENCE")
+                        l_Phases[k].push_back(l_Fields);
+                    else if(l_Fields[0] == "LINK")
+                        l_Links += l_Line + "\n";
+                    else
+                        l_Routers[atoi(l_Fields[1].c_str())] += l_Line + "\n";
+                }
+            l_Part.close();
+            remove(l_Name.c_str());
+        }
+    if(!l_Success)
+        return false;
+
+    ofstream l_Results(p_ResultsFile.c_str());
+    l_Results << "WALL_CLOCK," << p_WallClock << endl;
+    long l_SessionKB = l_PeakKB - l_BaselineKB - l_FixedKB;
+    l_Results << "MEMORY," << l_Sessions << "," << l_PeakKB << "," << l_BaselineKB << "," << l_FixedKB << "," << (l_Sessions > 0 ? l_SessionKB * 1024 / l_Sessions : 0) << endl;
+    l_Results << "THROUGHPUT," << l_Messages << "," << (p_WallClock > 0 ? l_Messages/p_WallClock : 0) << endl;
+
+    //a command is logged by the partition of its router, and a command
+    //without a router by the first partition
+    for(unsigned i = 0; i < p_Commands.size(); i++)
+        {
+            int l_Router = ConfigurationParser::getCommandRouter(p_Commands[i].command, m_SimuConfiguration->getNumberOfRouters());
+            deque<string>& l_Log = l_Commands[l_Router >= 0 ? m_Assignment[l_Router] : 0];
+            //the commands after the end of the run were not executed
+            if(l_Log.empty())
+                continue;
+            l_Results << l_Log.front() << endl;
+            l_Log.pop_front();
+        }
+
+    //every partition has the same phases, each with the counts of its
+    //own routers
+    for(unsigned p = 0; p < l_Phases[0].size(); p++)
+        {
+            vector<string>& l_First = l_Phases[0][p];
+            if(l_First.size() < 6)
+                {
+                    l_Success = false;
+                    break;
+                }
+            string l_Convergence = l_First[2];
+            double l_Longest = atof(l_Convergence.c_str());
+            unsigned long l_Updates = 0, l_Withdrawn = 0;
+            for(int k = 0; k < m_NumberOfPartitions; k++)
+                {
+                    if(l_Phases[k].size() != l_Phases[0].size() || l_Phases[k][p].size() < 6)
+                        {
+                            l_Success = false;
+                            break;
+                        }
+                    vector<string>& l_Phase = l_Phases[k][p];
+                    if(atof(l_Phase[2].c_str()) > l_Longest)
+                        {
+                            l_Longest = atof(l_Phase[2].c_str());
+                            l_Convergence = l_Phase[2];
+                        }
+                    l_Updates += strtoul(l_Phase[3].c_str(), NULL, 10);
+                    l_Withdrawn += strtoul(l_Phase[4].c_str(), NULL, 10);
+                }
+            if(!l_Success)
+                break;
+
+            //the command may contain commas
+            string l_Command = l_First[5];
+            for(unsigned f = 6; f < l_First.size(); f++)
+                l_Command += "," + l_First[f];
+            l_Results << "CONVERGENCE," << l_First[1] << "," << l_Convergence << "," << l_Updates << "," << l_Withdrawn << "," << l_Command << endl;
+        }
+    if(!l_Success)
+        SC_REPORT_WARNING(g_ErrorID, "The convergence phases of the partitions differ");
+
+    for(map<int, string>::iterator it = l_Routers.begin(); it != l_Routers.end(); ++it)
+        l_Results << it->second;
+    l_Results << l_Links;
+
+    if(!l_Results)
+        {
+            SC_REPORT_WARNING(g_ErrorID, "Cannot write the results");
+            return false;
+        }
+    return l_Success;
+}
+
+/*! \sa PartitionedSimulation
+ */
+string PartitionedSimulation::getPartFileName(const string& p_ResultsFile, int p_PartitionId)
+{
+    ostringstream l_Name;
+    l_Name << p_ResultsFile << "." << p_PartitionId;
+    return l_Name.str();
+}
+
+/*! \sa PartitionedSimulation
+ */
+void PartitionedSimulation::synchronize(void)
+{
+    pthread_barrier_wait(m_Barrier);
+}
@@ -0,0 +1,191 @@
+/*! \file PartitionedSimulation.hpp
+ *  \brief     Runs the simulation in parallel partitions
+ */
+
+
+/*!
+ * \class PartitionedSimulation
+ * \brief Splits the routers into partitions that are simulated in
+ * parallel
+ *  \details The SystemC kernel is a single instance per process, so
+ *  each partition is simulated by a process of its own. The routers
+ *  are ordered breadth first from router 0 and the order is split into
+ *  contiguous parts, which keeps the neighbours mostly in the same
+ *  partition. The frames between the partitions travel through
+ *  single producer single consumer channels in memory shared by the
+ *  processes.
+ *
+ *  The partitions are synchronized conservatively. A frame forwarded
+ *  on a clock edge is read by the neighbour on the next edge, so the
+ *  clock period of the routers is the minimum latency of a link and it
+ *  is used as the time window. The windows end a quarter period after
+ *  the edges. After each window all the partitions wait for each
+ *  other, drain their inbound channels and wait again before the next
+ *  window. The drained frames are delivered in the middle of the next
+ *  period, so the routers see the same frames on the same edges as in
+ *  the single kernel run.
+ *
+ *  Each partition runs the scheduled commands of its own routers and
+ *  writes the results of its routers into a file of its own. The
+ *  parent process merges the files into the results of the whole
+ *  simulation, which have the same records as the results of the
+ *  single kernel run followed by the statistics of the links between
+ *  the partitions. A frame lost by a full channel fails the partition.
+ */
+
+
+#include "systemc"
+#include "Configuration.hpp"
+#include "Simulation.hpp"
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace sc_core;
+using namespace sc_dt;
+
+
+#ifndef _PARTITIONEDSIMULATION_H_
+#define _PARTITIONEDSIMULATION_H_
+
+
+class PartitionedSimulation
+{
+
+public:
+
+    /*!
+     * \brief Constructor
+     * \details Assigns the routers to the partitions and allocates the
+     * channels
+     * @param[in] SimulationConfig * const p_SimuConfiguration The
+     * configuration of the simulation
+     * @param[in] int p_NumberOfPartitions The number of partitions. At
+     * most one partition per router is used.
+     * \public
+     */
+    PartitionedSimulation(SimulationConfig * const p_SimuConfiguration, int p_NumberOfPartitions);
+
+    ~PartitionedSimulation();
+
+    /*! \fn bool run(const sc_time& p_Duration, const vector<struct_ScheduledCommand>& p_Commands, const string& p_ResultsFile)
+     *  \brief Runs all the partitions until p_Duration
+     *  \details Shall be called before any SystemC object is
+     *  instantiated. Returns when all the partitions have finished and
+     *  their results have been merged.
+     *  @param[in] const vector<struct_ScheduledCommand>& p_Commands The
+     *  commands of the batch run
+     *  @param[in] const string& p_ResultsFile The file of the merged
+     *  results. No results are written if empty.
+     *  \return bool true: all the partitions finished - false: a
+     *  partition failed or the results could not be merged
+     * \public
+     */
+    bool run(const sc_time& p_Duration, const vector<struct_ScheduledCommand>& p_Commands, const string& p_ResultsFile);
+
+    /*! \fn int getNumberOfPartitions(void)
+     * \public
+     */
+    int getNumberOfPartitions(void);
+
+    /*! \fn int getPartition(int p_RouterId)
+     *  \brief Returns the partition of the given router
+     * \public
+     */
+    int getPartition(int p_RouterId);
+
+    /*! \fn static int getDefaultNumberOfPartitions(void)
+     *  \brief Returns the number of online processors
+     * \public
+     */
+    static int getDefaultNumberOfPartitions(void);
+
+private:
+
+    SimulationConfig *m_SimuConfiguration;
+
+    int m_NumberOfPartitions;
+
+    /*!
+     * \property vector<int> m_Assignment
+     * \brief The partition of each router
+     * \private
+     */
+    vector<int> m_Assignment;
+
+    /*!
+     * \property PartitionChannelMap m_Channels
+     * \brief The channels between the partitions
+     * \private
+     */
+    PartitionChannelMap m_Channels;
+
+    /*!
+     * \property sc_time m_Window
+     * \brief The time window. Equals the clock period of the routers.
+     * \private
+     */
+    sc_time m_Window;
+
+    /*!
+     * \property void *m_SharedMemory
+     * \brief The region shared by the partitions
+     * \details Holds the barrier and the channels
+     * \private
+     */
+    void *m_SharedMemory;
+
+    size_t m_SharedSize;
+
+    pthread_barrier_t *m_Barrier;
+
+    /*! \fn void assignRouters(void)
+     *  \brief Splits the breadth first order of the routers into
+     *  partitions
+     * \private
+     */
+    void assignRouters(void);
+
+    /*! \fn bool allocateChannels(void)
+     *  \brief Maps the shared region and builds the barrier and a
+     *  channel for each direction of the links between partitions
+     * \private
+     */
+    bool allocateChannels(void);
+
+    /*! \fn int runPartition(int p_PartitionId, const sc_time& p_Duration, const vector<struct_ScheduledCommand>& p_Commands, const string& p_ResultsFile)
+     *  \brief Simulates one partition window by window
+     *  \details Writes the results of the partition into p_ResultsFile
+     *  followed by a dot and the partition
+     *  \return int: the exit status of the process
+     * \private
+     */
+    int runPartition(int p_PartitionId, const sc_time& p_Duration, const vector<struct_ScheduledCommand>& p_Commands, const string& p_ResultsFile);
+
+    /*! \fn bool mergeResults(const string& p_ResultsFile, const vector<struct_ScheduledCommand>& p_Commands, double p_WallClock)
+     *  \brief Merges the results of the partitions into p_ResultsFile
+     *  and removes the files of the partitions
+     *  \details The resource usage is summed over the partitions, the
+     *  commands are written in the order of the script and the
+     *  convergence phases are merged: the updates are summed and the
+     *  convergence time is the longest one of the partitions.
+     * \private
+     */
+    bool mergeResults(const string& p_ResultsFile, const vector<struct_ScheduledCommand>& p_Commands, double p_WallClock);
+
+    /*! \fn string getPartFileName(const string& p_ResultsFile, int p_PartitionId)
+     *  \brief Returns the name of the results file of a partition
+     * \private
+     */
+    string getPartFileName(const string& p_ResultsFile, int p_PartitionId);
+
+    /*! \fn void synchronize(void)
+     *  \brief Waits until all the partitions have reached the barrier
+     * \private
+     */
+    void synchronize(void);
+};
+
+
+#endif /* _PARTITIONEDSIMULATION_H_ */
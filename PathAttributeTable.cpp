@@ -0,0 +1,98 @@
+/*! \file PathAttributeTable.cpp
+ *  \brief     Implementation of PathAttributeTable class.
+ *  \details
+ */
+
+
+#include "PathAttributeTable.hpp"
+#include <sstream>
+
+
+PathAttributeTable::PathAttributeTable(void):m_NextId(1)
+{
+}
+
+PathAttributeTable::~PathAttributeTable(void)
+{
+    for(unordered_set<struct_PathAttributes *, AttributeHash, AttributeEqual>::iterator it = m_Attributes.begin(); it != m_Attributes.end(); ++it)
+        delete *it;
+}
+
+/*! \sa PathAttributeTable
+ */
+const struct_PathAttributes *PathAttributeTable::intern(unsigned char p_Origin, const vector<unsigned>& p_ASPath)
+{
+    struct_PathAttributes l_Key;
+    l_Key.origin = p_Origin;
+    l_Key.ASPath = p_ASPath;
+
+    unordered_set<struct_PathAttributes *, AttributeHash, AttributeEqual>::iterator l_Entry = m_Attributes.find(&l_Key);
+    if(l_Entry != m_Attributes.end())
+    {
+        (*l_Entry)->references++;
+        return *l_Entry;
+    }
+
+    struct_PathAttributes *l_Attributes = new struct_PathAttributes();
+    l_Attributes->id = m_NextId++;
+    l_Attributes->origin = p_Origin;
+    l_Attributes->ASPath = p_ASPath;
+    l_Attributes->references = 1;
+    m_Attributes.insert(l_Attributes);
+    return l_Attributes;
+}
+
+/*! \sa PathAttributeTable
+ */
+void PathAttributeTable::acquire(const struct_PathAttributes *p_Attributes)
+{
+    const_cast<struct_PathAttributes *>(p_Attributes)->references++;
+}
+
+/*! \sa PathAttributeTable
+ */
+void PathAttributeTable::release(const struct_PathAttributes *p_Attributes)
+{
+    struct_PathAttributes *l_Attributes = const_cast<struct_PathAttributes *>(p_Attributes);
+    if(--l_Attributes->references > 0)
+        return;
+
+    m_Attributes.erase(l_Attributes);
+    delete l_Attributes;
+}
+
+/*! \sa PathAttributeTable
+ */
+int PathAttributeTable::size(void)
+{
+    return m_Attributes.size();
+}
+
+/*! \sa PathAttributeTable
+ */
+string PathAttributeTable::ASPathToString(const struct_PathAttributes *p_Attributes)
+{
+    ostringstream l_Path;
+    for(unsigned i = 0; i < p_Attributes->ASPath.size(); i++)
+    {
+        if(i > 0)
+            l_Path << "-";
+        l_Path << p_Attributes->ASPath[i];
+    }
+    return l_Path.str();
+}
+
+size_t PathAttributeTable::AttributeHash::operator()(const struct_PathAttributes *p_Attributes) const
+{
+    //FNV-1a over the origin and the AS numbers
+    size_t l_Hash = 2166136261u;
+    l_Hash = (l_Hash ^ p_Attributes->origin) * 16777619u;
+    for(unsigned i = 0; i < p_Attributes->ASPath.size(); i++)
+        l_Hash = (l_Hash ^ p_Attributes->ASPath[i]) * 16777619u;
+    return l_Hash;
+}
+
+bool PathAttributeTable::AttributeEqual::operator()(const struct_PathAttributes *p_Attributes1, const struct_PathAttributes *p_Attributes2) const
+{
+    return p_Attributes1->origin == p_Attributes2->origin && p_Attributes1->ASPath == p_Attributes2->ASPath;
+}
@@ -0,0 +1,122 @@
+/*! \file  PathAttributeTable.hpp
+ *  \brief     Header file of PathAttributeTable class
+ *  \details   Defines the shared storage of the BGP path attributes
+ */
+
+/*!
+ * \class PathAttributeTable
+ * \brief Interned path attribute sets
+ *  \details Holds one copy of each distinct combination of ORIGIN and
+ *  AS_PATH. The routes of the routing table point to the shared copy,
+ *  so routes learned with the same attributes do not duplicate the
+ *  AS-path. Since the sets are unique, two routes have the same
+ *  attributes exactly when they point to the same set.
+ *
+ *  The sets are reference counted. intern and acquire add a
+ *  reference and release removes one. A set is freed when its last
+ *  reference is released.
+ */
+
+
+#include <vector>
+#include <string>
+#include <unordered_set>
+
+using namespace std;
+
+
+#ifndef _PATHATTRIBUTETABLE_H_
+#define _PATHATTRIBUTETABLE_H_
+
+/*! \brief One interned path attribute set
+ * \details The first AS of the path is the one closest to this router
+ */
+struct struct_PathAttributes
+{
+    int id;
+    unsigned char origin;
+    vector<unsigned> ASPath;
+    int references;
+};
+
+
+class PathAttributeTable
+{
+
+public:
+
+    PathAttributeTable(void);
+
+    ~PathAttributeTable(void);
+
+    /*! \fn const struct_PathAttributes *intern(unsigned char p_Origin, const vector<unsigned>& p_ASPath)
+     * \brief Returns the shared set with the given attributes
+     * \details The set is created if it does not exist. A reference
+     * is added to the returned set.
+     * @param [in] unsigned char p_Origin The ORIGIN attribute
+     * @param [in] const vector<unsigned>& p_ASPath The AS_PATH attribute
+     * \return const struct_PathAttributes*: the interned set
+     * \public
+     */
+    const struct_PathAttributes *intern(unsigned char p_Origin, const vector<unsigned>& p_ASPath);
+
+    /*! \fn void acquire(const struct_PathAttributes *p_Attributes)
+     * \brief Adds a reference to an interned set
+     * \public
+     */
+    void acquire(const struct_PathAttributes *p_Attributes);
+
+    /*! \fn void release(const struct_PathAttributes *p_Attributes)
+     * \brief Removes a reference from an interned set
+     * \details The set is freed when the last reference is removed
+     * \public
+     */
+    void release(const struct_PathAttributes *p_Attributes);
+
+    /*! \fn int size(void)
+     * \brief Returns the number of distinct sets
+     * \public
+     */
+    int size(void);
+
+    /*! \fn static string ASPathToString(const struct_PathAttributes *p_Attributes)
+     * \brief Returns the AS-path in the "-" separated form
+     * \details E.g. 100-4212-231-22
+     * \public
+     */
+    static string ASPathToString(const struct_PathAttributes *p_Attributes);
+
+private:
+
+    /*! \brief Hash of the attribute values
+     * \private
+     */
+    struct AttributeHash
+    {
+        size_t operator()(const struct_PathAttributes *p_Attributes) const;
+    };
+
+    /*! \brief Compares the attribute values
+     * \private
+     */
+    struct AttributeEqual
+    {
+        bool operator()(const struct_PathAttributes *p_Attributes1, const struct_PathAttributes *p_Attributes2) const;
+    };
+
+    /*! \property unordered_set<struct_PathAttributes *> m_Attributes
+     * \brief The interned sets
+     * \private
+     */
+    unordered_set<struct_PathAttributes *, AttributeHash, AttributeEqual> m_Attributes;
+
+    /*! \property int m_NextId
+     * \brief Id for the next new set
+     * \details Gives the sets a stable order
+     * \private
+     */
+    int m_NextId;
+};
+
+
+#endif /* _PATHATTRIBUTETABLE_H_ */
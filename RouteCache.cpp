@@ -0,0 +1,68 @@
+/*! \file RouteCache.cpp
+ *  \brief     Implementation of RouteCache class.
+ *  \details
+ */
+
+
+#include "RouteCache.hpp"
+#include <sstream>
+
+
+RouteCache::RouteCache(void)
+{
+    clear();
+}
+
+/*! \sa RouteCache
+ */
+bool RouteCache::lookup(unsigned p_Address, unsigned long p_Generation, int& p_OutputPort)
+{
+    struct_CacheEntry& l_Entry = m_Entries[slot(p_Address)];
+    if(l_Entry.valid && l_Entry.address == p_Address && l_Entry.generation == p_Generation)
+        {
+            m_Hits++;
+            p_OutputPort = l_Entry.outputPort;
+            return true;
+        }
+    m_Misses++;
+    return false;
+}
+
+/*! \sa RouteCache
+ */
+void RouteCache::insert(unsigned p_Address, unsigned long p_Generation, int p_OutputPort)
+{
+    struct_CacheEntry& l_Entry = m_Entries[slot(p_Address)];
+    l_Entry.address = p_Address;
+    l_Entry.generation = p_Generation;
+    l_Entry.outputPort = p_OutputPort;
+    l_Entry.valid = true;
+}
+
+/*! \sa RouteCache
+ */
+void RouteCache::clear(void)
+{
+    for (int i = 0; i < ROUTE_CACHE_SIZE; i++)
+        m_Entries[i].valid = false;
+    m_Hits = 0;
+    m_Misses = 0;
+}
+
+/*! \sa RouteCache
+ */
+string RouteCache::getStatistics(void)
+{
+    ostringstream l_Stats;
+    l_Stats << ROUTE_CACHE_SIZE << "," << m_Hits << "," << m_Misses;
+    return l_Stats.str();
+}
+
+/*! \sa RouteCache
+ */
+unsigned RouteCache::slot(unsigned p_Address)
+{
+    p_Address ^= p_Address >> 16;
+    p_Address ^= p_Address >> 8;
+    return p_Address & (ROUTE_CACHE_SIZE - 1);
+}
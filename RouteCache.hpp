@@ -0,0 +1,100 @@
+/*! \file  RouteCache.hpp
+ *  \brief     Header file of RouteCache class
+ *  \details   Defines the destination to output port cache of the data plane
+ */
+
+/*!
+ * \class RouteCache
+ * \brief Direct-mapped cache of resolved routes
+ *  \details Each destination address maps to one slot. A slot is valid
+ *  only if it was filled during the current generation of the routing
+ *  table, so the whole cache is invalidated by a new generation
+ *  without touching the slots.
+ */
+
+
+#include <string>
+
+using namespace std;
+
+
+#ifndef _ROUTECACHE_H_
+#define _ROUTECACHE_H_
+
+/*!
+ * The number of slots in the cache. Shall be a power of two.
+ */
+#define ROUTE_CACHE_SIZE 256
+
+
+class RouteCache
+{
+
+public:
+
+    RouteCache(void);
+
+    /*! \fn bool lookup(unsigned p_Address, unsigned long p_Generation, int& p_OutputPort)
+     * \brief Looks up a destination from the cache
+     * @param [in] unsigned p_Address The destination in host byte order
+     * @param [in] unsigned long p_Generation The current generation of
+     * the routing table
+     * @param [out] int& p_OutputPort The cached output port
+     * \return bool: true on a hit
+     * \public
+     */
+    bool lookup(unsigned p_Address, unsigned long p_Generation, int& p_OutputPort);
+
+    /*! \fn void insert(unsigned p_Address, unsigned long p_Generation, int p_OutputPort)
+     * \brief Stores a resolved route into the slot of the destination
+     * \public
+     */
+    void insert(unsigned p_Address, unsigned long p_Generation, int p_OutputPort);
+
+    /*! \fn void clear(void)
+     * \brief Invalidates all the slots and resets the statistics
+     * \public
+     */
+    void clear(void);
+
+    /*! \fn string getStatistics(void)
+     * \brief Returns the statistics of the cache
+     * \details Syntax: size,hits,misses
+     * \public
+     */
+    string getStatistics(void);
+
+private:
+
+    /*!
+     * \brief One slot of the cache
+     */
+    struct struct_CacheEntry
+    {
+        unsigned address;
+        unsigned long generation;
+        int outputPort;
+        bool valid;
+    };
+
+    /*! \property struct_CacheEntry m_Entries[ROUTE_CACHE_SIZE]
+     * \brief The slots
+     * \private
+     */
+    struct_CacheEntry m_Entries[ROUTE_CACHE_SIZE];
+
+    unsigned long m_Hits;
+
+    unsigned long m_Misses;
+
+    /*! \fn unsigned slot(unsigned p_Address)
+     * \brief Returns the slot of the address
+     * \details The octets are mixed so that the hosts of one subnet
+     * spread over the cache
+     * \private
+     */
+    unsigned slot(unsigned p_Address);
+};
+
+
+#endif /* _ROUTECACHE_H_ */
@@ -24,6 +24,7 @@ Router::Router(sc_module_name p_ModuleName, RouterConfig * const p_RouterConfigu
     l_Report->newReportString("Interface count: ");
     SC_REPORT_INFO(g_DebugID, l_Report->appendReportString(m_RouterConfiguration->getNumberOfInterfaces()));
 
+#ifndef _EVENT_DRIVEN
     /// \li define clock period for Router
     m_ClkPeriod = new const sc_time(1, SC_SEC);
 
@@ -38,6 +39,7 @@ Router::Router(sc_module_name p_ModuleName, RouterConfig * const p_RouterConfigu
     m_IP.port_Clk(*m_ClkRouter);
     //pass clock to the routing table module
     m_RoutingTable.port_Clk(*m_ClkRouter);
+#endif
 
     SC_REPORT_INFO(g_DebugID, l_Report->newReportString("Binding the planes."));
 
@@ -93,8 +95,11 @@ Router::Router(sc_module_name p_ModuleName, RouterConfig * const p_RouterConfigu
 				export_ReceivingInterface[i] = new sc_export<Interface_If>;
 				export_ReceivingInterface[i]->bind(*m_NetworkInterface[i]);
 
+#ifndef _EVENT_DRIVEN
 			//bind the clock to the network interface
 			m_NetworkInterface[i]->port_Clk(*m_ClkRouter);
+#endif
+			m_NetworkInterface[i]->setBurstSize(m_RouterConfiguration->getBurstSize());
 
 			//bind the interfaces to the data plane
 			m_IP.port_FromInterface(m_NetworkInterface[i]->export_ToDataPlane);
@@ -131,8 +136,10 @@ Router::~Router()
     delete m_NetworkInterface;
 
 
+#ifndef _EVENT_DRIVEN
     delete m_ClkPeriod;
     delete m_ClkRouter;
+#endif
 }
 
 void Router::interfaceUp(int p_InterfaceId)
@@ -151,6 +158,16 @@ void Router::interfaceDown(int p_InterfaceId)
     SC_REPORT_INFO(g_DebugID, m_Name.newReportString("Network interface Down."));
 }
 
+string Router::getInterfaceStatistics(int p_InterfaceId)
+{
+    return m_NetworkInterface[p_InterfaceId]->getStatistics();
+}
+
+string Router::getRouteCacheStatistics(void)
+{
+    return m_IP.getRouteCacheStatistics();
+}
+
 bool Router::interfaceIsUp(int p_InterfaceId)
 {
     return m_NetworkInterface[p_InterfaceId]->isUp();
@@ -202,6 +219,20 @@ bool Router::connectInterface(Router *p_TargetRouter,int p_LocalInterface, int p
         }
 }
 
+bool Router::connectInterface(PartitionLink *p_Link, int p_LocalInterface, bool p_Client)
+{
+    if(interfaceIsUp(p_LocalInterface))
+        return false;
+
+    port_ForwardingInterface[p_LocalInterface]->bind(*p_Link);
+    p_Link->port_Local.bind(*(export_ReceivingInterface[p_LocalInterface]));
+    if(p_Client)
+        m_RouterConfiguration->setNICMode(p_LocalInterface, CLIENT);
+    interfaceUp(p_LocalInterface);
+    p_Link->interfaceUp();
+    return true;
+}
+
 void Router::killRouter(void)
 {
     //kill interfaces
@@ -302,6 +333,44 @@ void Router::removeLocalPref(int p_AS)
     m_RoutingTable.removeLocalPref(p_AS);
 }
 
+bool Router::withdrawPrefix(unsigned p_Prefix, int p_Length)
+{
+    struct_Prefix l_Prefix;
+    l_Prefix.prefix = p_Prefix;
+    l_Prefix.length = p_Length;
+    return m_RoutingTable.withdrawLocalPrefix(l_Prefix);
+}
+
+string Router::getRIBStatistics(void)
+{
+    return m_RoutingTable.getRIBStatistics();
+}
+
+string Router::getFIBStatistics(void)
+{
+    return m_RoutingTable.getFIBStatistics();
+}
+
+string Router::getPacketPoolStatistics(void)
+{
+    return m_IP.getPacketPoolStatistics();
+}
+
+unsigned long Router::getFixedMemory(void)
+{
+    return m_IP.getPacketPoolMemory() + m_RoutingTable.getFIBMemory();
+}
+
+const struct_MessageCounters& Router::getMessageCounters(void)
+{
+    return m_Bgp.getMessageCounters();
+}
+
+string Router::getDuplicateStatistics(void)
+{
+    return m_Bgp.getDuplicateStatistics();
+}
+
 
 
 
@@ -25,6 +25,7 @@
 #include "StringTools.hpp"
 #include "Configuration.hpp"
 #include "Host.hpp"
+#include "PartitionLink.hpp"
 
 using namespace std;
 using namespace sc_core;
@@ -99,6 +100,19 @@ public:
 
     bool connectInterface(Host *p_TargetHost,int p_LocalInterface);
 
+    /*! \fn bool connectInterface(PartitionLink *p_Link, int p_LocalInterface, bool p_Client)
+     *  \brief Connects the given interface of this router to a router
+     *  of another partition
+     *  @param[in] PartitionLink *p_Link The link to the other partition
+     *  @param[in] int p_LocalInterface
+     *  @param[in] bool p_Client true: the interface is the client of
+     *  the session
+     *  \return bool true: if success - false: if the interface is
+     *  already connected
+     * \public
+     */
+    bool connectInterface(PartitionLink *p_Link, int p_LocalInterface, bool p_Client);
+
     /*! \fn void killRouter(void)
      *  \brief Sets all the interfaces of this router down, clears all
      *  the buffers, clears all BGP sessions, resets the BGP
@@ -174,6 +188,20 @@ public:
      */
     string getRawRoutingTable(void);
 
+    /*! \fn string getInterfaceStatistics(int p_InterfaceId)
+     *  \brief get the packet counters of the given interface
+     *  \sa Interface::getStatistics
+     * \public
+     */
+    string getInterfaceStatistics(int p_InterfaceId);
+
+    /*! \fn string getRouteCacheStatistics(void)
+     *  \brief get the hit and miss counts of the route cache
+     *  \sa DataPlane::getRouteCacheStatistics
+     * \public
+     */
+    string getRouteCacheStatistics(void);
+
     /*! \fn void setPreferredAS(int p_AS, int p_pref_value)
      *  \brief give preference value for AS
      * \public
@@ -186,8 +214,60 @@ public:
      */
     void removeLocalPref(int p_AS);
 
+    /*! \fn bool withdrawPrefix(unsigned p_Prefix, int p_Length)
+     *  \brief withdraw a prefix originated by the router from its peers
+     *  \return bool: false if the router does not originate the prefix
+     * \public
+     */
+    bool withdrawPrefix(unsigned p_Prefix, int p_Length);
+
+    /*! \fn string getRIBStatistics(void)
+     *  \brief get the number of routes and the memory estimate of the
+     *  routing tables
+     *  \sa RoutingTable::getRIBStatistics
+     * \public
+     */
+    string getRIBStatistics(void);
+
+    /*! \fn string getFIBStatistics(void)
+     *  \brief get the size and the use of the forwarding table
+     *  \sa RoutingTable::getFIBStatistics
+     * \public
+     */
+    string getFIBStatistics(void);
+
+    /*! \fn string getPacketPoolStatistics(void)
+     *  \brief get the use of the packet pool of the data plane
+     *  \sa DataPlane::getPacketPoolStatistics
+     * \public
+     */
+    string getPacketPoolStatistics(void);
+
+    /*! \fn unsigned long getFixedMemory(void)
+     *  \brief get the bytes of the packet pool and the forwarding table
+     *  \details These do not grow with the number of sessions
+     * \public
+     */
+    unsigned long getFixedMemory(void);
+
+    /*! \fn const struct_MessageCounters& getMessageCounters(void)
+     *  \brief get the counters of the BGP messages sent by the router
+     *  \sa ControlPlane::getMessageCounters
+     * \public
+     */
+    const struct_MessageCounters& getMessageCounters(void);
+
+    /*! \fn string getDuplicateStatistics(void)
+     *  \brief get the statistics of the duplicate messages received
+     *  by the router
+     *  \sa ControlPlane::getDuplicateStatistics
+     * \public
+     */
+    string getDuplicateStatistics(void);
+
 private:
 
+#ifndef _EVENT_DRIVEN
     /*!
      * \property   const sc_time *clk_Periods
      * \brief
@@ -199,10 +279,11 @@ private:
     /*!
      * \property sc_clock *clk_Router
      * \brief Pointer to sc_clock
-     * \details
+     * \details The event-driven build has no clock
      * \private
      */
     sc_clock *m_ClkRouter;
+#endif
 
 
 
@@ -11,14 +11,18 @@
 
 #include "RoutingTable.hpp"
 #include "ReportGlobals.hpp"
+#include "Packet.hpp"
+#include "ClockTick.hpp"
 #include <algorithm>
+#include <sstream>
 
 
 
 
-RoutingTable::RoutingTable(sc_module_name p_ModName, ControlPlaneConfig * const p_RTConfig):sc_module(p_ModName), m_RTConfig(p_RTConfig), limit(300, SC_SEC), m_Reporter(""), m_AS("")
+RoutingTable::RoutingTable(sc_module_name p_ModName, ControlPlaneConfig * const p_RTConfig):sc_module(p_ModName), m_RTConfig(p_RTConfig), m_NextRouteId(1), m_PeakRIBMemory(0), limit(300, SC_SEC), m_Reporter(""), m_AS("")
 {
 
+	m_Generation = 0;
 	setUp(true);
 
 	m_UpdateOut.m_AS = m_RTConfig->getASNumber();
@@ -30,7 +34,9 @@ RoutingTable::RoutingTable(sc_module_name p_ModName, ControlPlaneConfig * const
 
 	m_AS = m_RTConfig->getASNumberAsString();
     SC_THREAD(routingTableMain);
+#ifndef _EVENT_DRIVEN
     sensitive << port_Clk.pos();
+#endif
     SC_REPORT_INFO(g_DebugRTID, m_Reporter.newReportString("Elaborated"));
     cout << name() << ": my AS: " << m_AS << endl;
 }
@@ -43,14 +49,6 @@ RoutingTable::~RoutingTable()
 
 void RoutingTable::routingTableMain(void)
 {
-    m_headOfRawTable = new struct_Route();
-    m_endOfRawTable = new struct_Route();
-    m_iterator = new struct_Route();
-
- //   l_LocalRoute->next = 0;
-    m_headOfRoutingTable = new struct_Route();
-    m_endOfRoutingTable = new struct_Route();
-
     addLocalRoute();
 
 
@@ -70,7 +68,7 @@ void RoutingTable::routingTableMain(void)
     //The main thread of routing table module starts
     while(true)
         {
-            wait();
+            waitForWork();
 
     		if(!isRunning())
     			continue;
@@ -116,24 +114,11 @@ void RoutingTable::routingTableMain(void)
                         else if(m_sessions.at(i) == 1) // Case 4
                         {
                             m_sessions.at(i) = 0;
-                            // Iterate through the RawTable and send withdraw message to peers if route's outputport is i
-                            m_iterator = m_headOfRawTable;
-                            while(m_iterator->next != 0)
-                            {
-                                m_iterator= m_iterator->next;
-                              if(m_iterator->OutputPort == i)
-                                {
-                                    // Clear m_iterator->ASpath for sendWithdraw.
-                                    m_iterator->ASes = "";
-                                    for (int j = 0; j < m_RTConfig->getNumberOfInterfaces()-1; j++) {
-                                    	if(j != i)
-                                    		sendWithdraw(*m_iterator,j);
-
-									}
-                                }
-                            }
-                            // Remove all the router from RawRoutingTable where outputport is i.
+                            // Remove all the routes learned from peer i. The best routes that change
+                            // are withdrawn from or re-advertised to the other peers.
                             deleteRoutes(i);
+                            // The peer has forgotten what it was sent
+                            clearAdjRibOut(i);
 
                         }
 
@@ -141,67 +126,46 @@ void RoutingTable::routingTableMain(void)
 
                 }
 
-            if(m_ReceivingBuffer.num_available() > 0)
-            {
-//            	cout << name() << " receiving buffer has: " << m_ReceivingBuffer.num_available() << endl;
-            	m_ReceivingBuffer.read(m_BGPMsg);
-            	if(m_PreviousInput == m_BGPMsg)
-            		m_NewInputMsg = false;
-            	else
-            		m_NewInputMsg = true;
-            }
-            else
-            	m_NewInputMsg = false;
+            //the sessions have dropped the duplicates
+            m_NewInputMsg = m_ReceivingBuffer.nb_read(m_BGPMsg);
 
             ///BGP notification and update output port
             // port_Output->write(m_BGPMsg);
 
 
-            if((m_BGPMsg.m_Type = UPDATE) && m_NewInputMsg)
+            if(m_NewInputMsg && m_BGPMsg->m_Type == UPDATE)
             {
+                BGPUpdate & update = m_BGPMsg->m_Update;
 
-               // Read the first integer of the m_BGPMsg.m_Message. That indicates if this UPDATE-message is an advertise or a withdraw
+                // Withdrawn routes are removed from the Adj-RIB-In of the sending peer
+                for(unsigned i = 0; i < update.m_WithdrawnRoutes.size(); i++)
+                    handleWithdraw(update.m_WithdrawnRoutes[i], m_BGPMsg->m_OutboundInterface);
 
-                if(m_BGPMsg.m_Message.substr(0,1) == "0")
-                {
-                    // First char was 0, so this is a withdraw-message
-                    handleWithdraw(m_BGPMsg.m_Message);
-                }
-                else if(m_BGPMsg.m_Message.substr(0,1) == "1")
+                // All the NLRI share the path attributes. Add them to own RawTable with own AS in AS-path.
+                // The next update forwards them to peers if the best route changed
+                for(unsigned i = 0; i < update.m_NLRI.size(); i++)
                 {
-
-                    // This is an advertise-message. Add it to own RawTable, add own AS in AS-path and then forward the message to peers
-                    //      antti oti pois kun buffaa muistia.
-
-                	if(!addRouteToRawTable(m_BGPMsg.m_Message,m_BGPMsg.m_OutboundInterface))
+                	if(!addRouteToRawTable(update.m_NLRI[i], update.m_Origin, update.m_ASPath, m_BGPMsg->m_OutboundInterface))
                 	{
-cout << "Oma as: " << m_AS << "  ei lisätty raw tableen: " << m_BGPMsg.m_Message << endl;
-printRawRoutingTable();
-                		continue;
+                	    m_Reporter.newReportString(" UPDATE was not added to raw table: ");
+                	    SC_REPORT_INFO(g_DebugRTID, m_Reporter.appendReportString(update.toString()));
                 	}
-                    //      antti oti pois kun buffaa muistia.
-                    for (int k = 0; k < m_RTConfig->getNumberOfInterfaces()-1; k++) {
-                    	if(m_BGPMsg.m_OutboundInterface != k && port_Session[k]->isSessionValid())
-                    	{
-//                    		cout << name() << " advertises to the peer in interface: " << k << endl;
-                    		advertiseRoute(m_endOfRoutingTable, k);
-
-                    	}
-					}
-               }
-                else
-                {
-
                 }
             }
-            else if(m_BGPMsg.m_Type == NOTIFICATION && m_NewInputMsg)
+            else if(m_NewInputMsg && m_BGPMsg->m_Type == NOTIFICATION)
             {
                 cout << "In notification handling" << endl;
-                handleNotification(m_BGPMsg);
+                handleNotification(*m_BGPMsg);
             }
 
 
+            // Only the prefixes touched during this cycle are resolved
+            if(!m_DirtyPrefixes.empty())
                 updateRoutingTable();
+
+            // The queued changes are sent once the MRAI of the peer expires
+            for(unsigned i = 0; i < m_OutboundQueue.size(); i++)
+                flushOutboundQueue(i);
                 /*
                 cout << "Raw table: " << endl;
                 printRawRoutingTable();
@@ -223,214 +187,161 @@ printRawRoutingTable();
 }
 
 /*
-    1. Iterate through RawRoutingTable and check that every route in it is also found in MainRoutingTable.
-    When same route is found from both tables check which one is preferred and update that to MainRoutingTable.
-
-    2. Iterate through MainRT and verify that there isn't any route that doesn't exist in RawRT.
+    Incremental update of MainRoutingTable. Run the decision process only for the prefixes marked dirty
+    since the previous update and then apply the resulting change list to the FIB and to the outbound queues.
 */
 void RoutingTable::updateRoutingTable()
 {
-    // 1. Verify that every route in RawRT is found from MainRT
-    struct_Route * l_iteratorRaw = m_headOfRawTable;
+    for(unordered_set<RouteKey>::iterator it = m_DirtyPrefixes.begin(); it != m_DirtyPrefixes.end(); ++it)
+        selectBestRoute(*it);
+    m_DirtyPrefixes.clear();
+
+    for(unsigned i = 0; i < m_ChangeList.size(); i++)
+        applyRouteChange(m_ChangeList[i]);
+    m_ChangeList.clear();
 
-    bool l_routeInBothTables;   // Used to check that every route in RawTable exists in MainRoutingTable
+    m_PeakRIBMemory = max(m_PeakRIBMemory, ribMemory());
+
+    // Nothing points to the unlinked routes anymore
+    for(unsigned i = 0; i < m_RemovedRoutes.size(); i++)
+        releaseRoute(m_RemovedRoutes[i]);
+    m_RemovedRoutes.clear();
+}
 
 /*
-    if(m_headOfRoutingTable->next == 0)
-        setRoute(m_headOfRawTable->next);
+    Pick the preferred route among the candidates of p_Key and store it to MainRoutingTable.
+    The current best route is kept on ties. If the best route of the prefix changed, append the change
+    to m_ChangeList and return true. A re-advertisement of the best route with the same interned path
+    attributes and output port only replaces the route object, so the FIB, the generation and the peers
+    are left untouched.
 */
-    // Iterate RawTable
-    while(l_iteratorRaw->next != 0)
+bool RoutingTable::selectBestRoute(RouteKey p_Key)
+{
+    struct_Route * currentRoute = 0;
+    map<RouteKey, struct_Route *>::iterator mainEntry = m_MainTable.find(p_Key);
+    if(mainEntry != m_MainTable.end())
+        currentRoute = mainEntry->second;
+
+    struct_Route * bestRoute = 0;
+    unordered_map<RouteKey, vector<struct_Route *> >::iterator candidateEntry = m_Candidates.find(p_Key);
+    if(candidateEntry != m_Candidates.end())
     {
-        l_iteratorRaw = l_iteratorRaw->next;
+        vector<struct_Route *> & candidates = candidateEntry->second;
+        if(find(candidates.begin(), candidates.end(), currentRoute) != candidates.end())
+            bestRoute = currentRoute;
 
-        m_iterator = m_headOfRoutingTable;
-        l_routeInBothTables = false;
-
-        // Iterate MainRoutingTable
-        while(m_iterator->next != 0)
+        for(unsigned i = 0; i < candidates.size(); i++)
         {
-            m_iterator= m_iterator->next;
-            // Check if RawTable route has the same Prefix&Mask than current MainRoutingTable route
-            if(sameRoutes(*m_iterator, *l_iteratorRaw))
-            {
-                // Same Prefix&Mask combination was found from both tables. Check which route is preferred
-                // Only one match in mainRT, so no need to continue iterating mainRT --> break inner while-loop
-                addPreferredRoute(*m_iterator, *l_iteratorRaw);
-                l_routeInBothTables = true;
-                break;
-            }
-        }
-        // Check that RawRoute was found from MainRoutingTable
-        if(!l_routeInBothTables)
-        {
-            setRoute(*l_iteratorRaw);
+            if(bestRoute == 0 || isPreferred(candidates[i], bestRoute))
+                bestRoute = candidates[i];
         }
 
+        if(candidates.empty())
+            m_Candidates.erase(candidateEntry);
     }
 
-    // 2. Now verify that every route in MainRT is also found from RawRT
-    l_iteratorRaw = m_headOfRawTable;
-    m_iterator = m_headOfRoutingTable;
+    if(bestRoute == currentRoute)
+        return false;
 
-    // Iterate MainRT
-    bool foundFromRawTable;
-    while(m_iterator->next != 0)
+    if(bestRoute != 0 && currentRoute != 0 && bestRoute->attributes == currentRoute->attributes
+       && bestRoute->OutputPort == currentRoute->OutputPort)
     {
-        l_iteratorRaw = m_headOfRawTable;
-        foundFromRawTable = false;
-        m_iterator = m_iterator->next;
-
-        // Iterate RawRT
-        while(l_iteratorRaw->next != 0)
-        {
-
-            l_iteratorRaw = l_iteratorRaw->next;
-            if(sameRoutes(*m_iterator,*l_iteratorRaw))
-            {
-                foundFromRawTable = true;
-                break;
-            }
-        }
-        if(!foundFromRawTable)
-        {
-            // struct_Route didin't exist in RawRT so remove it from MainTable
-            removeFromRoutingTable(m_iterator->id);
-        }
+        mainEntry->second = bestRoute;
+        return false;
     }
 
-
-
+    struct_RouteChange change;
+    change.key = p_Key;
+    change.newRoute = bestRoute;
+    change.oldRoute = currentRoute;
+    if(bestRoute == 0)
+    {
+        // No candidates left for the prefix
+        change.type = ROUTE_REMOVED;
+        m_MainTable.erase(mainEntry);
+    }
+    else
+    {
+        change.type = currentRoute == 0 ? ROUTE_ADDED : ROUTE_REPLACED;
+        m_MainTable[p_Key] = bestRoute;
+    }
+    m_ChangeList.push_back(change);
+    return true;
 }
 
 /*
-    Compare two routes and return true if they are the same
+    Write the changed best route to the FIB. Then queue the prefix to all the valid sessions.
 */
-bool RoutingTable::sameRoutes(struct_Route p_route1, struct_Route p_route2)
+void RoutingTable::applyRouteChange(const struct_RouteChange & p_change)
 {
-    if(p_route1.prefix == p_route2.prefix && p_route1.mask == p_route2.mask)
-        return true;
+    unsigned l_prefix = (unsigned)(p_change.key >> 32);
+    int l_mask = (int)(p_change.key & 0xFFFFFFFF);
+    if(p_change.type == ROUTE_REMOVED)
+        m_FIB.removeRoute(l_prefix, l_mask);
     else
-        return false;
-}
+        m_FIB.setRoute(l_prefix, l_mask, p_change.newRoute->OutputPort);
+    m_Generation++;
 
-// Return the AS Path length
-int RoutingTable::ASpathLength(struct_Route p_route)
-{
-    int ASCount = count(p_route.ASes.begin(), p_route.ASes.end(), '-') + 1;
-    return ASCount;
+    for (int k = 0; k < m_RTConfig->getNumberOfInterfaces()-1; k++)
+    {
+        if(port_Session[k]->isSessionValid())
+            queueRoute(p_change.key, k);
+    }
 }
 
 /*
-    Add new route to MainRoutingTable
+    Return true if p_route1 is preferred over p_route2. Policies:
+    1. Higher preference value of the preferredASes on the AS-path
+    2. Shorter AS-path
+    3. Origin type, not used?
 */
-void RoutingTable::setRoute(struct_Route p_route)
+bool RoutingTable::isPreferred(struct_Route * p_route1, struct_Route * p_route2)
 {
-    struct_Route * newRoute = new struct_Route();
-
-    newRoute->id = (m_endOfRoutingTable->id)+1;
-    newRoute->prefix = p_route.prefix;
-    newRoute->mask = p_route.mask;
-    newRoute->OutputPort = p_route.OutputPort;
-    newRoute->ASes = p_route.ASes;
+    int route1_pref = localPreference(p_route1);
+    int route2_pref = localPreference(p_route2);
 
+    if(route1_pref != route2_pref)
+        return route1_pref > route2_pref;
 
-    if(m_headOfRoutingTable->next == 0)
-    {
-        // RoutingTable is empty. So add the first struct_Route in it
-        m_headOfRoutingTable->next = newRoute;
-        m_endOfRoutingTable = newRoute;
-        newRoute->next = 0;
-    }
-    else
-    {
-        // RoutingTable wasn't empty
-        m_endOfRoutingTable->next = newRoute;
-        m_endOfRoutingTable = newRoute;
-        newRoute->next = 0;
-    }
+    return ASpathLength(p_route1) < ASpathLength(p_route2);
 }
 
 /*
-    Take two routes as a parameter, check which one is preferred and
-    if the one from RawTable is preferred, replace the other one with that.
-    Which route is preferred is decided by policies.
-    p_route1 is already in MainRoutingTable, so do nothing if that route is preferred over p_route2.
-
+    Iterate through the AS-path of p_route and return the highest preference value of the preferred ASes on it.
+    0 is returned if none of the ASes is preferred.
 */
-void RoutingTable::addPreferredRoute(struct_Route p_route1, struct_Route p_route2)
+int RoutingTable::localPreference(struct_Route * p_route)
 {
-    /*
-        Add preferred route to routing table according to policies. Policies:
-        1. Check if which route has higher preferredAS
-        2. Check AS-path length
-        3. Origin type, not used?
-
-    */
-
-    /*  1. TODO: only picks up the highes value. What if p_route1 and p_route2 have same highest value but different 2. highest value?
-        Solution: calculate sum instead of the highest value?
-    */
-    int route1_highest_pref = 0;
-    int route2_highest_pref = 0;
-    int AS;
-    unsigned newPosition = 0;
-    unsigned oldPosition = 0;
-
-    // 1. Iterate through preferredASes and check if other struct_Route has preferred AS on its ASpath
-    for(unsigned i = 0;i<preferredASes.size();i = i+2)
-    {
-        while(newPosition < p_route1.ASes.size())
-        {
-            newPosition = p_route1.ASes.find("-",oldPosition+1);
-            AS =  atoi((p_route1.ASes.substr(oldPosition,newPosition-oldPosition)).c_str());
-            oldPosition = newPosition+1;
-
-            if(AS == preferredASes.at(i))
-            {
-                if(route1_highest_pref < preferredASes.at(i+1))
-                    route1_highest_pref = preferredASes.at(i+1);
-            }
-        }
-        newPosition = 0;
-        oldPosition = 0;
+    int highestPref = 0;
+    if(preferredASes.empty())
+        return highestPref;
 
-
-        while(newPosition < p_route2.ASes.size())
+    const vector<unsigned> & ASPath = p_route->attributes->ASPath;
+    for(unsigned j = 0; j < ASPath.size(); j++)
+    {
+        for(unsigned i = 0;i+1<preferredASes.size();i = i+2)
         {
-
-            newPosition = p_route2.ASes.find("-",oldPosition+1);
-            AS =  atoi((p_route2.ASes.substr(oldPosition,newPosition-oldPosition)).c_str());
-            oldPosition = newPosition+1;
-
-            if(AS == preferredASes.at(i))
-            {
-                if(route2_highest_pref < preferredASes.at(i+1))
-                    route2_highest_pref = preferredASes.at(i+1);
-            }
+            if(ASPath[j] == (unsigned)preferredASes.at(i) && highestPref < preferredASes.at(i+1))
+                highestPref = preferredASes.at(i+1);
         }
     }
+    return highestPref;
+}
 
+// Return the AS Path length
+int RoutingTable::ASpathLength(struct_Route * p_route)
+{
+    return p_route->attributes->ASPath.size();
+}
 
-
-    if(route2_highest_pref > route1_highest_pref)
-    {
-        // p_route2 was preferred over p_route1. So remove p_route1 from MainRoutingTable and replace it by p_route2
-        removeFromRoutingTable(p_route1.id);
-        setRoute(p_route2);
-        return;
-    }
-
-    // 2. AS-path length
-    if(ASpathLength(p_route1) < ASpathLength(p_route2))
-    {
-        // p_route2 had shorter AS-path, so replace p_route1
-        removeFromRoutingTable(p_route1.id);
-        setRoute(p_route2);
-        return;
-    }
-
-
+// Return the key of the prefix&mask combination. The host bits of the prefix are cleared
+RouteKey RoutingTable::routeKey(unsigned p_prefix, int p_mask)
+{
+    if(p_mask <= 0)
+        p_prefix = 0;
+    else if(p_mask < 32)
+        p_prefix &= 0xFFFFFFFFu << (32 - p_mask);
+    return ((RouteKey)p_prefix << 32) | (unsigned)p_mask;
 }
 
 /*
@@ -438,33 +349,34 @@ void RoutingTable::addPreferredRoute(struct_Route p_route1, struct_Route p_route
 */
 string RoutingTable::getRoutingTable()
 {
-    return routingTableToString(m_headOfRoutingTable);
-}
+    string table;
+    table.append("<TABLE>");
 
-/*
-    Return RawRoutingTable
-*/
-string RoutingTable::getRawRoutingTable()
-{
-    return routingTableToString(m_headOfRawTable);
-}
+    for(map<RouteKey, struct_Route *>::iterator it = m_MainTable.begin(); it != m_MainTable.end(); ++it)
+    {
+        table.append(routeToString(*it->second));
+        table.append(";");
+    }
+    table.append("</TABLE>");
 
+    return table;
+}
 
 /*
-    Iterate through the routing table, beginning from p_route.
-    Create a string from the routes and return that string.
+    Return RawRoutingTable. The routes are listed peer by peer.
 */
-string RoutingTable::routingTableToString(struct_Route * p_route)
+string RoutingTable::getRawRoutingTable()
 {
-    m_iterator = p_route;
     string table;
     table.append("<TABLE>");
 
-    while(m_iterator->next != 0)
+    for(unsigned i = 0; i < m_AdjRibIn.size(); i++)
     {
-        m_iterator = m_iterator->next;
-        table.append(routeToString(*m_iterator));
-        table.append(";");
+        for(unordered_map<RouteKey, struct_Route *>::iterator it = m_AdjRibIn[i].begin(); it != m_AdjRibIn[i].end(); ++it)
+        {
+            table.append(routeToString(*it->second));
+            table.append(";");
+        }
     }
     table.append("</TABLE>");
 
@@ -479,7 +391,7 @@ string RoutingTable::routeToString(struct_Route p_route)
 {
     stringstream ss;
     ss.str("");
-    ss << p_route.id  << "," << p_route.prefix << "," << p_route.mask << "," << p_route.ASes << "," << p_route.OutputPort;
+    ss << p_route.id  << "," << p_route.prefix << "," << p_route.mask << "," << PathAttributeTable::ASPathToString(p_route.attributes) << "," << p_route.OutputPort;
     return ss.str();
 }
 
@@ -489,27 +401,18 @@ void RoutingTable::printRoutingTable()
 {
 	cout << name() << endl;
 
-    // Set the iterator in the beginning of table
-    m_iterator = m_headOfRoutingTable;
-
-    while(m_iterator->next != 0)
-    {
-        m_iterator = m_iterator->next;
-        printOneRoute(*m_iterator);
-    }
+    for(map<RouteKey, struct_Route *>::iterator it = m_MainTable.begin(); it != m_MainTable.end(); ++it)
+        printOneRoute(*it->second);
 
 }
 
 // Print the RawRoutingTable
 void RoutingTable::printRawRoutingTable()
 {
-    // Set the iterator in the beginning of table
-    m_iterator = m_headOfRawTable;
-
-    while(m_iterator->next != 0)
+    for(unsigned i = 0; i < m_AdjRibIn.size(); i++)
     {
-        m_iterator = m_iterator->next;
-        printOneRoute(*m_iterator);
+        for(unordered_map<RouteKey, struct_Route *>::iterator it = m_AdjRibIn[i].begin(); it != m_AdjRibIn[i].end(); ++it)
+            printOneRoute(*it->second);
     }
 
 }
@@ -518,461 +421,272 @@ void RoutingTable::printRawRoutingTable()
 void RoutingTable::printOneRoute(struct_Route p_route)
 {
     stringstream ss;
-    ss << "Id:" << p_route.id <<" Prefix: " <<  p_route.prefix << " Mask: " <<  p_route.mask << " Output port: " << p_route.OutputPort << " ASes: " << p_route.ASes;
+    ss << "Id:" << p_route.id <<" Prefix: " <<  p_route.prefix << " Mask: " <<  p_route.mask << " Output port: " << p_route.OutputPort << " ASes: " << PathAttributeTable::ASPathToString(p_route.attributes);
     string message = ss.str();
     cout << message << endl;
 }
 
 /*
-    Add new route to RawRoutingTable
-    TODO: check why this is being called continuesly
+    Add new route to the Adj-RIB-In of the peer in OutputPort.
+    A route that the peer advertised earlier for the same prefix&mask is replaced.
+    The prefix is marked dirty, so the next update runs the decision process for it.
 */
-bool RoutingTable::addRouteToRawTable(string p_msg,int OutputPort)
+bool RoutingTable::addRouteToRawTable(const struct_Prefix & p_prefix, unsigned char p_origin, const vector<unsigned> & p_ASPath, int OutputPort)
 {
 
     struct_Route * newRoute = new struct_Route();
 
-    // Get ID for this new route
-    newRoute->id = (m_endOfRawTable->id)+1;
-
     // Set data to newRoute in CreateRoute(...)
-   if(!createRoute(p_msg,OutputPort,newRoute))
+   if(!createRoute(p_prefix,p_origin,p_ASPath,OutputPort,newRoute))
    {
 	   m_Reporter.newReportString(" Route was not add to raw table: ");
-		SC_REPORT_INFO(g_DebugRTID, m_Reporter.appendReportString(p_msg));
-cout << "ei lisätty reittiä" << endl;
+		SC_REPORT_INFO(g_DebugRTID, m_Reporter.appendReportString(m_Reporter.uIntToIp(p_prefix.prefix)));
+	   delete newRoute;
 	   return false;
    }
-	   // Add new struct_Route object to the RoutingTable
 
-    // Check if the RoutingTable is empty
-    if(m_headOfRawTable->next == 0)
-    {
-       // RoutinTable was empty. Add the first item in it. It's also the last item of it.
-        m_headOfRawTable->next = newRoute;
-        m_endOfRawTable = newRoute;
-        newRoute->next = 0;
-    }
-    else
-    {
-       // RoutinTable wasn't empty. Add new struct_Route object in it. Add it to the end.
-        m_endOfRawTable->next = newRoute;
-        m_endOfRawTable = newRoute;
-        newRoute->next = 0;
-    }
+    // Get ID for this new route
+    newRoute->id = m_NextRouteId++;
+    newRoute->key = routeKey(p_prefix.prefix, newRoute->mask);
+
+    // Unlink the previous advertisement of the peer
+    removeFromRawTable(OutputPort, newRoute->key);
 
-   // SC_REPORT_INFO(g_DebugRTID, m_Reporter.newReportString("Routing table update after a route is added into the raw table"));
-    updateRoutingTable();
+    if((unsigned)OutputPort >= m_AdjRibIn.size())
+        m_AdjRibIn.resize(OutputPort+1);
+    m_AdjRibIn[OutputPort][newRoute->key] = newRoute;
+    m_Candidates[newRoute->key].push_back(newRoute);
+    m_DirtyPrefixes.insert(newRoute->key);
     return true;
 }
 
 /*
-    Create a struct_Route object from p_msg. p_msg must be constructed as follows:
-    0 or 1,IP,Mask,ASes(e.g. 1,10.255.0.100,8,550-7564-4)
-    Parse message and collect IP,Mask,ASes which are separated by ","-mark
+    Create a struct_Route object from an NLRI prefix and the path attributes it was advertised with.
+    An empty AS-path means the local route, which is only accepted on the last port.
+    Otherwise the route is rejected if own AS is already on the path, and own AS is prepended to it.
+    The attributes are interned, so the routes with the same path share them.
 */
-bool RoutingTable::createRoute(string p_msg,int p_outputPort ,struct_Route * p_route)
+bool RoutingTable::createRoute(const struct_Prefix & p_prefix, unsigned char p_origin, const vector<unsigned> & p_ASPath, int p_outputPort, struct_Route * p_route)
 {
-    // Use these to collect data separetad by semicolon
-    int position = 2;
-    unsigned IP_end,Mask_end, ASes_end;
-
-    for(int i=0;i<3;i++)
-    {
-        position = p_msg.find(",",position+1);
-        if(i==0)
-            IP_end = position;
-        else if(i==1)
-            Mask_end = position;
-        else if(i==2)
-            ASes_end = position;
-    }
-
-    string IPAddress = p_msg.substr(2,IP_end-2);
-    string Mask = p_msg.substr((IP_end+1),(Mask_end-IP_end-1));  // -1 to remove ";"-sign
-    string ASes = p_msg.substr((Mask_end+1),(ASes_end-Mask_end-1));
-
-//cout << "IPAddress: " << IPAddress << "mask: " << Mask << " ASes: " << ASes << endl;
-	string l_AS;
-    if(ASes.compare(AS_EMPTY) == 0)//local route is to be created
+    unsigned ownAS = m_RTConfig->getASNumber();
+    if(p_ASPath.empty())//local route is to be created
     {
     	if(p_outputPort == m_RTConfig->getNumberOfInterfaces()-1)
     	{
-    		ASes = m_RTConfig->getASNumberAsString();
     		SC_REPORT_INFO(g_DebugRTID, m_Reporter.newReportString(" Local route was created"));
-   	}
+    	}
     	else
     	{
     	    SC_REPORT_WARNING(g_DebugRTID, m_Reporter.newReportString(" Wrong output port for local route"));
     	    return false;
     	}
     }
-    else if(ASes.find("-") == string::npos) // route that is advertised an adjacent router
+    //Check if own AS exist in the path. If own as was found, just return false
+    else if(find(p_ASPath.begin(), p_ASPath.end(), ownAS) != p_ASPath.end())
     {
-
-    	if(ASes.compare(m_AS) == 0) //create route only if it is not from this router
-    	{
-    		cout << "AS found from the path" << endl;
-    		m_Reporter.newReportString(" Local route advertisement received, advertised AS: ");
-    		m_Reporter.appendReportString(ASes);
-    		m_Reporter.appendReportString(" Local AS: ");
-    		SC_REPORT_WARNING(g_DebugRTID, m_Reporter.appendReportString(m_AS));
-    	    return false;
-    	}
-    	else
-    	{
-        	l_AS = m_AS + "-";
-    		// Add own AS in AS-path
-    		l_AS += ASes;
-    		ASes = l_AS;
-    		m_Reporter.newReportString(" Adjacent AS route created, AS: ");
-    	    SC_REPORT_INFO(g_DebugRTID, m_Reporter.appendReportString(ASes));
-
-    	}
+        m_Reporter.newReportString(" Own AS found from the advertised path, local AS: ");
+        SC_REPORT_WARNING(g_DebugRTID, m_Reporter.appendReportString(m_AS));
+        return false;
     }
-    else //other
-    {
-    	position = 0;
-       	ASes_end = ASes.find("-",position);
-   	//Check if own AS exist in the path
-    	while(ASes_end != string::npos)
-    	{
-    		l_AS = ASes.substr(position, ASes_end-position);
-        	//if own as was found, just return false
-    		if(l_AS.compare(m_AS) == 0)
-    		{
-    			cout << "AS PATH: " << ASes << " My path: " << m_AS << endl;
-//            	cout << " as from the message: " << ASes<< endl;
-            	return false;
-    		}
-    		position = ASes_end + 1;
-        	ASes_end = ASes.find("-",position);
 
-    	}
-    	l_AS = m_AS + "-";
-		// Add own AS in AS-path
-		l_AS += ASes;
-		ASes = l_AS;
-		m_Reporter.newReportString(" More than one hop route created, AS: ");
-	    SC_REPORT_INFO(g_DebugRTID, m_Reporter.appendReportString(ASes));
+    // Add own AS in AS-path
+    vector<unsigned> ASPath;
+    ASPath.reserve(p_ASPath.size() + 1);
+    ASPath.push_back(ownAS);
+    ASPath.insert(ASPath.end(), p_ASPath.begin(), p_ASPath.end());
 
-    }
- //=======
-//
-//    stringstream ss;
-//    // Add own AS in AS-path
-//    if(ASes.size() == 0)
-//    {
-//        // Add own as without "-" in the beginning since this is the first AS-number
-//        ss << m_RTConfig->getASNumber();
-//        ASes.append(ss.str());
-//
-//    }
-//    else
-//    {
-//        ASes.append("-");
-//        ss << m_RTConfig->getASNumber();
-//        ASes.append(ss.str());
-//    }
-//
-//>>>>>>> 4ee3ed4b07096339af037a9f7c39dbd08e896861
-//cout << name() << ": struct_Route added: " << ASes << " @ " << sc_time_stamp() << endl;
     // Set the values to struct_Route pointer
-    p_route->prefix = IPAddress;
-    p_route->mask = atoi(Mask.c_str());
-    p_route->ASes = ASes;
+    p_route->prefix = m_Reporter.uIntToIp(p_prefix.prefix);
+    p_route->mask = p_prefix.length;
+    p_route->attributes = m_PathAttributes.intern(p_origin, ASPath);
     p_route->OutputPort = p_outputPort;
     return true;
 }
 
-/*
-    Remove given route from RawRoutingTable
-*/
-void RoutingTable::removeFromRawTable(int p_routeId)
+// Delete p_route and release its path attributes
+void RoutingTable::releaseRoute(struct_Route * p_route)
 {
-    struct_Route * deleteRoute;
-    struct_Route * tempRoute;
-    deleteRoute = m_headOfRawTable;
-    while(deleteRoute->next != 0)
-    {
-        tempRoute = deleteRoute;
-        deleteRoute = deleteRoute->next;
-        if(deleteRoute->id == p_routeId)
-        {
-            if(deleteRoute == m_endOfRoutingTable)
-            {
-                m_endOfRoutingTable = tempRoute;
-            }
-            tempRoute->next = deleteRoute->next;
-            delete deleteRoute;
-            return;
-        }
-    }
+    m_PathAttributes.release(p_route->attributes);
+    delete p_route;
 }
 
 /*
-    Remove given route from MainRoutingTable
+    Unlink the route of p_Key from the Adj-RIB-In of p_outputPort and from the candidates of the prefix.
+    The prefix is marked dirty and the route is deleted at the end of the next update.
 */
-void RoutingTable::removeFromRoutingTable(int p_routeId)
+bool RoutingTable::removeFromRawTable(int p_outputPort, RouteKey p_Key)
 {
-    struct_Route * deleteRoute = new struct_Route();
-    struct_Route * tempRoute = new struct_Route();
-    deleteRoute = m_headOfRoutingTable;
-    while(deleteRoute->next != 0)
-    {
-        tempRoute = deleteRoute;
-        deleteRoute = deleteRoute->next;
-        if(deleteRoute->id == p_routeId)
-        {
-            tempRoute->next = deleteRoute->next;
-            if(deleteRoute == m_endOfRoutingTable)
-            {
-                m_endOfRoutingTable = tempRoute;
-            }
-            return;
-        }
-    }
+    if(p_outputPort < 0 || (unsigned)p_outputPort >= m_AdjRibIn.size())
+        return false;
+
+    unordered_map<RouteKey, struct_Route *>::iterator ribEntry = m_AdjRibIn[p_outputPort].find(p_Key);
+    if(ribEntry == m_AdjRibIn[p_outputPort].end())
+        return false;
+
+    struct_Route * removedRoute = ribEntry->second;
+    m_AdjRibIn[p_outputPort].erase(ribEntry);
+
+    vector<struct_Route *> & candidates = m_Candidates[p_Key];
+    candidates.erase(find(candidates.begin(), candidates.end(), removedRoute));
+    m_RemovedRoutes.push_back(removedRoute);
+    m_DirtyPrefixes.insert(p_Key);
+    return true;
 }
 
 /*
-    Remove all Routes from RawRoutingTable and then update MainRoutingTable too(i.e. clear it)
+    Remove all Routes from RawRoutingTable and clear MainRoutingTable and the FIB too
 */
 void RoutingTable::clearRoutingTables()
 {
-    if(m_headOfRawTable->next == 0)
-        return;
-    m_iterator = m_headOfRawTable->next;
-    struct_Route * l_deleteRoute;
-
-    while(m_iterator->next != 0)
+    for(unsigned i = 0; i < m_AdjRibIn.size(); i++)
     {
-        l_deleteRoute = m_iterator;
-        m_iterator = m_iterator->next;
-        removeFromRawTable(l_deleteRoute->id);
+        for(unordered_map<RouteKey, struct_Route *>::iterator it = m_AdjRibIn[i].begin(); it != m_AdjRibIn[i].end(); ++it)
+            releaseRoute(it->second);
     }
-    l_deleteRoute = m_iterator;
-    removeFromRawTable(l_deleteRoute->id);
-	SC_REPORT_INFO(g_DebugRTID,m_Reporter.newReportString("Routing table is being updated after clearRoutingTables was called"));
-    updateRoutingTable();
+    for(unsigned i = 0; i < m_RemovedRoutes.size(); i++)
+        releaseRoute(m_RemovedRoutes[i]);
+    for(unsigned i = 0; i < m_AdjRibOut.size(); i++)
+        clearAdjRibOut(i);
+    m_AdjRibIn.clear();
+    m_Candidates.clear();
+    m_MainTable.clear();
+    m_DirtyPrefixes.clear();
+    m_ChangeList.clear();
+    m_RemovedRoutes.clear();
+    m_OutboundQueue.clear();
+    m_AdjRibOut.clear();
+    m_FIB.clear();
+    m_Generation++;
+	SC_REPORT_INFO(g_DebugRTID,m_Reporter.newReportString("Routing tables were cleared"));
 }
 
 
 /*
-    Delete all the routes from RawRoutingTable that have p_outputPort as output port.
-    Then update MainRoutingTable if changes were made
+    Unlink the originated route of p_prefix from the local port. The next update withdraws it from the peers
+    unless another peer still advertises the prefix.
 */
-void RoutingTable::deleteRoutes(int p_outputPort)
+bool RoutingTable::withdrawLocalPrefix(const struct_Prefix & p_prefix)
 {
-    m_iterator = m_headOfRawTable;
-    bool routesDeleted = false;
-    while(m_iterator->next != 0)
-    {
-        m_iterator = m_iterator->next;
-        if(m_iterator->OutputPort == p_outputPort)
-        {
-            // Same output port so delete the route from RawTable and send UPDATE-withdraw message to all peers
-
-            for (int i = 0; i < m_RTConfig->getNumberOfInterfaces()-1; i++) {
-
-            	if(p_outputPort != i)
-            		sendWithdraw(*m_iterator, i);
-            }
-
-
-            removeFromRawTable(m_iterator->id);
-            routesDeleted = true;
-        }
-    }
-    // If RawTable was modified update MainRoutingTable
-    if(routesDeleted)
-    {
-    	SC_REPORT_INFO(g_DebugRTID,m_Reporter.newReportString("Routing table is being updated after delete routes was called"));
-        updateRoutingTable();
-    }
+    bool removed = removeFromRawTable(m_RTConfig->getNumberOfInterfaces()-1, routeKey(p_prefix.prefix, p_prefix.length));
+    if(removed)
+        m_Wakeup.notify(SC_ZERO_TIME);
+    return removed;
 }
 
-// Handle withdraw-message. Remove given route from RawRoutingTable, update MainRoutingTable and forward this message
-// Withdraw-message syntax: withdraw/ad,prefix,mask,AS-path (i.e. 0,100.200.50.0,16,50-123-321-999)
-void RoutingTable::handleWithdraw(string p_message)
-{
-    /*  First check that own AS is not in AS-path.
-        If own AS is found from AS-path --> do nothing since the package has made a circle and this router has already handled this packege
-    */
-    stringstream ss;
-
-
-    if(p_message.find(m_AS) == string::npos)
-    {
-        // Own AS number was found from AS-path so exit from this method
-        return;
-    }
-
-    // Parse message
-    int pos_prefix, pos_mask, pos_ASes;
-    int position = 1;
-    for(int i = 0; i < 3;i++)
-    {
-        position = p_message.find(",",position+1);
-
-        if(i==0)
-            pos_prefix = position;
-        else if(i==1)
-            pos_mask = position;
-        else if(i==2)
-            pos_ASes = position;
-    }
-    string l_prefix = p_message.substr(2,pos_prefix-2);
-    string l_mask = p_message.substr((pos_prefix+1),(pos_mask-pos_prefix-1));  // -1 to remove ","-sign
-    string l_ASpath = p_message.substr((pos_mask+1),(pos_ASes-pos_mask-1));
-
-//   cout << "|Prefix|" << l_prefix << "|Mask|" << l_mask << "|ASes|" << l_ASpath << "|end|" << endl;
-
-
-    ss.str("");
-    struct_Route * l_iterator;
-    struct_Route * removedRoute = new struct_Route;
-    l_iterator = m_headOfRawTable;
-    while(l_iterator->next != 0)
-    {
-        l_iterator = l_iterator->next;
-        ss << l_iterator->mask;
-
-        // Comapre if p_message and current ruote have same prefix,mask and AS-path
-        if(l_iterator->prefix == l_prefix && ss.str() == l_mask && l_iterator->ASes == l_ASpath)
-        {
-            // Same, so remove this route from own RawRoutingTable and send advertise to peers
-
-            removedRoute->prefix = l_iterator->prefix;
-            removedRoute->mask = l_iterator->mask;
-
-            l_ASpath.append("-");
-            ss.str("");
-            // Add own AS-number to AS-path
-            ss << m_RTConfig->getASNumber();
-            l_ASpath.append(ss.str());
-            removedRoute->ASes = l_ASpath;
-
-            for (int i = 0; i < m_RTConfig->getNumberOfInterfaces()-1; i++) {
-
-            	if(removedRoute->OutputPort != i)
-            		sendWithdraw(*removedRoute, i);
-            }
-            // Now remove this route from RawRoutingTable
-            removeFromRawTable(l_iterator->id);
-        }
-        ss.str("");
-    }
-
-    delete removedRoute;
-}
 /*
-    Send withdraw-message to all peers. If this message is created in this router write peer's and own AS-number to p_route.ASes.
-    Otherwise p_route.ASes should already include this router's AS, since it's added in handleWithdraw()
+    Return the number of routes in the Adj-RIBs-In and in MainRoutingTable together with the current and the
+    peak memory estimate
 */
-void RoutingTable::sendWithdraw(struct_Route p_route, int p_OutputPort)
+string RoutingTable::getRIBStatistics()
 {
-	//return if this the session that the withdraw is to be sent is down
-    if(!port_Session[p_OutputPort]->isSessionValid())
-    	return;
+    unsigned long routes = 0;
+    for(unsigned i = 0; i < m_AdjRibIn.size(); i++)
+        routes += m_AdjRibIn[i].size();
 
-    stringstream ss;
-//    if(p_route.ASes.size() == 0)
-//    {
-//        // This withdraw message is created in this router, so get peer AS-number and own AS-number
-//        string peerAS = port_Session[p_route.OutputPort]->getPeerAS();
-//        int ownAS = m_RTConfig->getASNumber();
-//        ss << peerAS << "-" << ownAS;
-//        p_route.ASes = ss.str();
-//        ss.str("");
-//
-//    }
-    // Construct the message here
-
-    // This is withdraw-message so it begins with "0"
-    string l_message = "0,";
-    l_message.append(p_route.prefix);
-    l_message.append(",");
-    ss << p_route.mask;
-    l_message.append(ss.str());
-    l_message.append(",");
-
-
-    m_UpdateOut.m_Type = UPDATE;
-    m_UpdateOut.m_Message = l_message;
-    m_UpdateOut.m_OutboundInterface = p_OutputPort;
+    ostringstream stats;
+    stats << routes << "," << m_MainTable.size() << "," << ribMemory() << "," << max(m_PeakRIBMemory, ribMemory());
+    return stats.str();
+}
 
-    // Send the message
+string RoutingTable::getFIBStatistics()
+{
+    return m_FIB.getStatistics();
+}
 
-    port_Output->write(m_UpdateOut);
+unsigned long RoutingTable::getFIBMemory()
+{
+    return m_FIB.getMemoryUsage();
 }
 
-void RoutingTable::handleNotification(BGPMessage p_msg)
+/*
+    Estimate the memory of the RIBs from the number of their entries. Each hash or tree entry is counted as its
+    value and two pointers of node overhead, each route with its prefix string and each attribute set with its
+    AS-path of typical length. The estimate is cheap enough to be taken after every update.
+*/
+unsigned long RoutingTable::ribMemory()
 {
+    const unsigned long node = 2*sizeof(void *);
+    const unsigned long routeEntry = sizeof(RouteKey) + sizeof(struct_Route *) + node + sizeof(struct_Route) + 16;
+    const unsigned long candidateEntry = sizeof(RouteKey) + sizeof(vector<struct_Route *>) + node + sizeof(struct_Route *);
+    const unsigned long bestEntry = sizeof(RouteKey) + sizeof(struct_Route *) + 2*node;
+    const unsigned long ribOutEntry = sizeof(RouteKey) + sizeof(struct_PathAttributes *) + node;
+    const unsigned long attributeEntry = sizeof(struct_PathAttributes) + 4*sizeof(unsigned) + node;
+
+    unsigned long routes = 0, advertised = 0;
+    for(unsigned i = 0; i < m_AdjRibIn.size(); i++)
+        routes += m_AdjRibIn[i].size();
+    for(unsigned i = 0; i < m_AdjRibOut.size(); i++)
+        advertised += m_AdjRibOut[i].size();
+
+    return (routes + m_RemovedRoutes.size())*routeEntry + m_Candidates.size()*candidateEntry
+        + m_MainTable.size()*bestEntry + advertised*ribOutEntry + m_PathAttributes.size()*attributeEntry;
 }
 
 /*
-    Find struct_Route object from RoutingTable by given IPAddress.
-    Iterate through the RoutingTable and find the longest match with the given IPAddress.
-    Then return pointer to the struct_Route object that had the longest match
+    Delete all the routes from RawRoutingTable that have p_outputPort as output port.
+    The prefixes the peer had advertised are marked dirty
 */
-struct_Route * RoutingTable::findRoute(string p_prefix)
+void RoutingTable::deleteRoutes(int p_outputPort)
 {
-    struct_Route * l_route = new struct_Route();
-    int l_longestMatch = 0;
-    int l_matchLength;
-    m_iterator = m_headOfRoutingTable;
+    if(p_outputPort < 0 || (unsigned)p_outputPort >= m_AdjRibIn.size() || m_AdjRibIn[p_outputPort].empty())
+        return;
+
+    // Detach the whole Adj-RIB-In of the peer
+    unordered_map<RouteKey, struct_Route *> removedRoutes;
+    removedRoutes.swap(m_AdjRibIn[p_outputPort]);
 
-    while(m_iterator->next != 0)
+    for(unordered_map<RouteKey, struct_Route *>::iterator it = removedRoutes.begin(); it != removedRoutes.end(); ++it)
     {
-        m_iterator = m_iterator->next;
-        l_matchLength = matchLength(m_iterator, p_prefix);
-        // if new match is longer than current longest match, set it as new longest match
-        if(l_matchLength >= l_longestMatch)
-        {
-            l_longestMatch = l_matchLength;
-            l_route = m_iterator;
-        }
+        vector<struct_Route *> & candidates = m_Candidates[it->first];
+        candidates.erase(find(candidates.begin(), candidates.end(), it->second));
+        m_RemovedRoutes.push_back(it->second);
+        m_DirtyPrefixes.insert(it->first);
     }
-    return l_route;
+
+	SC_REPORT_INFO(g_DebugRTID,m_Reporter.newReportString("Routing table is being updated after delete routes was called"));
 }
 
-// Return how many "bits" from prefix match with IP address.
-int RoutingTable::matchLength(struct_Route * p_route, string p_IP)
+// Handle a withdrawn route received from the peer in p_outputPort. Remove given route from its Adj-RIB-In.
+// The next update resolves the prefix and forwards the change to the other peers
+void RoutingTable::handleWithdraw(const struct_Prefix & p_prefix, int p_outputPort)
 {
-    int matchLength = 0;
-    string routePrefix = p_route->prefix;
-    for(unsigned i = 0; i < p_IP.size();i++)
-    {
-
-        if(p_IP.at(i) == routePrefix.at(i))
-            matchLength++;
-        else
-            break;
-    }
-    return matchLength;
+    removeFromRawTable(p_outputPort, routeKey(p_prefix.prefix, p_prefix.length));
+}
 
+void RoutingTable::handleNotification(BGPMessage p_msg)
+{
 }
 
 /*
     Take ip address as a parameter and return the outputport.
     DataPlane uses this function to find out where to forward its packets.
+    The lookup reads the DIR-24-8 forwarding table, so it takes at most two memory accesses.
 */
-int RoutingTable::resolveRoute(string p_IPAddress)
+int RoutingTable::resolveRoute(unsigned p_IPAddress)
 {
 	if(!isRunning())
 		return -1;
 
-    SC_REPORT_INFO(g_DebugID, StringTools(name()).appendReportString("resolveRoute-method was called.") );
-    struct_Route * foundRoute = findRoute(p_IPAddress);
+    // Longest prefix match from the forwarding table. No match means no route.
+    int outputPort = m_FIB.lookup(p_IPAddress);
 
-
-
-    if(foundRoute->OutputPort < m_RTConfig->getNumberOfInterfaces() && foundRoute->OutputPort >= 0)
-    	return foundRoute->OutputPort;
+    if(outputPort < m_RTConfig->getNumberOfInterfaces() && outputPort >= 0)
+    	return outputPort;
     else
     	return -1;
 }
 
+unsigned long RoutingTable::getGeneration(void)
+{
+    return m_Generation;
+}
+
+// Text form of resolveRoute for the GUI and the reports
+int RoutingTable::resolveRoute(string p_IPAddress)
+{
+    return resolveRoute(m_Reporter.ipToUInt(p_IPAddress));
+}
+
 // Add new AS to the preferred ASes vector
 void RoutingTable::setLocalPreference(int p_AS, int p_preferenceValue)
 {
@@ -997,72 +711,187 @@ void RoutingTable::removeLocalPref(int p_AS)
 }
 void RoutingTable::addLocalRoute()
 {
-    //add local AS route in the routing table
-    struct_Route *l_LocalRoute = new struct_Route();
-    l_LocalRoute->id = 1;
-    l_LocalRoute->prefix = m_RTConfig->getIPAsString();
-    l_LocalRoute->mask = StringTools().sToI(m_RTConfig->getIPMaskAsString());
-    l_LocalRoute->ASes = AS_EMPTY;
-    l_LocalRoute->OutputPort = m_RTConfig->getNumberOfInterfaces()-1;
+    //add local AS route in the routing table. The route has an empty AS-path
+    struct_Prefix l_LocalPrefix;
+    l_LocalPrefix.prefix = m_Reporter.ipToUInt(m_RTConfig->getIPAsString());
+    l_LocalPrefix.length = StringTools().sToI(m_RTConfig->getIPMaskAsString());
 
-    stringstream ss;
-    string routeAsString = "1,";  // It's advertisement, not withdraw, so string begins by "1"
-    routeAsString.append(l_LocalRoute->prefix);
-    routeAsString.append(",");
-    ss << l_LocalRoute->mask;
-    routeAsString.append(ss.str());
-    routeAsString.append(",");
-    routeAsString.append(l_LocalRoute->ASes);
-    addRouteToRawTable(routeAsString, l_LocalRoute->OutputPort);
+    addRouteToRawTable(l_LocalPrefix, ORIGIN_IGP, vector<unsigned>(), m_RTConfig->getNumberOfInterfaces()-1);
 
+    //and the other prefixes that the AS originates
+    const vector<struct_Prefix>& l_Originated = m_RTConfig->getOriginatedPrefixes();
+    for(unsigned i = 0; i < l_Originated.size(); i++)
+        addRouteToRawTable(l_Originated[i], ORIGIN_IGP, vector<unsigned>(), m_RTConfig->getNumberOfInterfaces()-1);
 }
 
-// Advertise this route to peers
-
-void RoutingTable::advertiseRoute(struct_Route * p_route, int p_Outputport)
+// Queue p_Key's prefix to the peer in p_Outputport. The message is built when the queue is flushed
+void RoutingTable::queueRoute(RouteKey p_Key, int p_Outputport)
 {
-    stringstream ss;
-    string routeAsString = "1,";  // It's advertisement, not withdraw, so string begins by "1"
-    routeAsString.append(p_route->prefix);
-    routeAsString.append(",");
-    ss << p_route->mask;
-    routeAsString.append(ss.str());
-    routeAsString.append(",");
-    routeAsString.append(p_route->ASes);
-    cout << name() << " advertising route: " << routeAsString << " @ " << sc_time_stamp() << endl;
-//    routeAsString.append("-");
-//    routeAsString.append(m_RTConfig->getASNumberAsString());
-
-    m_UpdateOut.m_Message = routeAsString;
-    m_UpdateOut.m_Type = UPDATE;
-
-    m_UpdateOut.m_OutboundInterface = p_Outputport;
     //do not advertise to the local as port
-    if(m_UpdateOut.m_OutboundInterface != m_RTConfig->getNumberOfInterfaces()-1)
-    {
-    	if(m_Previous == m_UpdateOut)
-    		cout << "Same message was send" << endl;
-    	port_Output->write(m_UpdateOut);
-    }
-m_Previous = m_UpdateOut;
+    if(p_Outputport >= m_RTConfig->getNumberOfInterfaces()-1)
+        return;
 
+    if((unsigned)p_Outputport >= m_OutboundQueue.size())
+        m_OutboundQueue.resize(p_Outputport+1);
+    m_OutboundQueue[p_Outputport].insert(p_Key);
 }
 
-// Advertise the whole table to given peer
-void RoutingTable::advertiseRawRoutingTable(int p_outputPort)
+/*
+    Build UPDATE-messages from the queued prefixes of the peer in p_Outputport once the MRAI of the session
+    has expired. Until then the changes stay in the queue, so a prefix that flaps is sent only once.
+    The queued prefixes are compared to the Adj-RIB-Out of the peer: unchanged routes are suppressed and
+    only the prefixes advertised earlier are withdrawn. Routes with the same AS-path share their path
+    attributes, so they are packed into the same message as long as it fits into the MTU.
+    A route is not advertised back to the peer it was learned from.
+*/
+void RoutingTable::flushOutboundQueue(int p_Outputport)
 {
-    struct_Route * l_route;
-    l_route = m_headOfRoutingTable;
-    while(l_route->next != 0)
+    if((unsigned)p_Outputport >= m_OutboundQueue.size() || m_OutboundQueue[p_Outputport].empty())
+        return;
+    set<RouteKey> & queue = m_OutboundQueue[p_Outputport];
+
+    // The whole table is sent again when the session comes up
+    if(!port_Session[p_Outputport]->isSessionValid())
     {
-        l_route = l_route->next;
+        clearAdjRibOut(p_Outputport);
+        return;
+    }
 
-    	if(l_route->OutputPort != p_outputPort)
-    	{
-    		advertiseRoute(l_route, p_outputPort);
-    	}
+    if(!port_Session[p_Outputport]->isMRAIExpired())
+        return;
+
+    if((unsigned)p_Outputport >= m_AdjRibOut.size())
+        m_AdjRibOut.resize(p_Outputport+1);
+    unordered_map<RouteKey, const struct_PathAttributes *> & adjRibOut = m_AdjRibOut[p_Outputport];
+
+    BGPUpdate & update = m_UpdateOut.m_Update;
+    update.clear();
+    bool updateSent = false;
+
+    // Group the advertised routes by their path attributes. The groups are ordered by the attribute id
+    map<int, vector<RouteKey> > routeGroups;
+    for(set<RouteKey>::iterator it = queue.begin(); it != queue.end(); ++it)
+    {
+        map<RouteKey, struct_Route *>::iterator mainEntry = m_MainTable.find(*it);
+        unordered_map<RouteKey, const struct_PathAttributes *>::iterator sentEntry = adjRibOut.find(*it);
+        if(mainEntry == m_MainTable.end() || mainEntry->second->OutputPort == p_Outputport)
+        {
+            // Nothing to withdraw if the peer was never told about the prefix
+            if(sentEntry == adjRibOut.end())
+                continue;
+            m_PathAttributes.release(sentEntry->second);
+            adjRibOut.erase(sentEntry);
+
+            update.addWithdrawnRoute((unsigned)(*it >> 32), (int)(*it & 0xFFFFFFFF));
+            if(update.getEncodedLength() > MTU)
+            {
+                update.m_WithdrawnRoutes.pop_back();
+                sendUpdate(p_Outputport);
+                updateSent = true;
+                update.clear();
+                update.addWithdrawnRoute((unsigned)(*it >> 32), (int)(*it & 0xFFFFFFFF));
+            }
+        }
+        else if(sentEntry == adjRibOut.end() || sentEntry->second != mainEntry->second->attributes)
+        {
+            // Interned attributes are equal only if they are the same object
+            const struct_PathAttributes * attributes = mainEntry->second->attributes;
+            m_PathAttributes.acquire(attributes);
+            if(sentEntry != adjRibOut.end())
+                m_PathAttributes.release(sentEntry->second);
+            adjRibOut[*it] = attributes;
+            routeGroups[attributes->id].push_back(*it);
+        }
+    }
+    queue.clear();
+
+    unsigned nextHop = m_Reporter.ipToUInt(m_RTConfig->getIPAsString());
+    for(map<int, vector<RouteKey> >::iterator group = routeGroups.begin(); group != routeGroups.end(); ++group)
+    {
+        const struct_PathAttributes * attributes = adjRibOut[group->second.front()];
+
+        // The withdrawn routes can share the message with the first group only
+        if(!update.m_NLRI.empty())
+        {
+            sendUpdate(p_Outputport);
+            updateSent = true;
+            update.clear();
+        }
+        update.m_Origin = attributes->origin;
+        update.m_ASPath = attributes->ASPath;
+        update.m_NextHop = nextHop;
+
+        for(unsigned i = 0; i < group->second.size(); i++)
+        {
+            RouteKey key = group->second[i];
+            update.addNLRI((unsigned)(key >> 32), (int)(key & 0xFFFFFFFF));
+            if(update.getEncodedLength() > MTU)
+            {
+                // Continue in a new message with the same path attributes
+                update.m_NLRI.pop_back();
+                sendUpdate(p_Outputport);
+                updateSent = true;
+                update.m_WithdrawnRoutes.clear();
+                update.m_NLRI.clear();
+                update.addNLRI((unsigned)(key >> 32), (int)(key & 0xFFFFFFFF));
+            }
+        }
+    }
 
+    if(!update.isEmpty())
+    {
+        sendUpdate(p_Outputport);
+        updateSent = true;
     }
+
+    // The changes of the next MRAI period are collected to the queue
+    if(updateSent)
+        port_Session[p_Outputport]->resetMRAI();
+}
+
+// Forget what was queued to or advertised to the peer in p_Outputport
+void RoutingTable::clearAdjRibOut(int p_Outputport)
+{
+    if((unsigned)p_Outputport < m_OutboundQueue.size())
+        m_OutboundQueue[p_Outputport].clear();
+    if((unsigned)p_Outputport >= m_AdjRibOut.size())
+        return;
+    unordered_map<RouteKey, const struct_PathAttributes *> & adjRibOut = m_AdjRibOut[p_Outputport];
+    for(unordered_map<RouteKey, const struct_PathAttributes *>::iterator it = adjRibOut.begin(); it != adjRibOut.end(); ++it)
+        m_PathAttributes.release(it->second);
+    adjRibOut.clear();
+}
+
+// Send the prefixes of m_UpdateOut to the peer in p_Outputport. The path attributes are kept for the next message
+void RoutingTable::sendUpdate(int p_Outputport)
+{
+    m_Reporter.newReportString(" sending update: ");
+    SC_REPORT_INFO(g_DebugRTID, m_Reporter.appendReportString(m_UpdateOut.m_Update.toString()));
+
+    // The prefix lists are moved to the new message, which is then handed over to the control plane
+    BGPMessageHandle message(new BGPMessage);
+    message->m_Type = UPDATE;
+    message->m_OutboundInterface = p_Outputport;
+    message->m_AS = m_UpdateOut.m_AS;
+    message->m_BGPIdentifier = m_UpdateOut.m_BGPIdentifier;
+    message->m_HoldDownTime = m_UpdateOut.m_HoldDownTime;
+    BGPUpdate & update = m_UpdateOut.m_Update;
+    message->m_Update.m_Origin = update.m_Origin;
+    message->m_Update.m_ASPath = update.m_ASPath;
+    message->m_Update.m_NextHop = update.m_NextHop;
+    message->m_Update.m_WithdrawnRoutes.swap(update.m_WithdrawnRoutes);
+    message->m_Update.m_NLRI.swap(update.m_NLRI);
+    port_Output->write(message);
+}
+
+// Advertise the whole table to given peer. The Adj-RIB-Out of a new session is empty, so every route is sent
+void RoutingTable::advertiseRawRoutingTable(int p_outputPort)
+{
+    clearAdjRibOut(p_outputPort);
+    for(map<RouteKey, struct_Route *>::iterator it = m_MainTable.begin(); it != m_MainTable.end(); ++it)
+        queueRoute(it->first, p_outputPort);
+
+    flushOutboundQueue(p_outputPort);
 }
 
 
@@ -1071,15 +900,7 @@ void RoutingTable::advertiseRawRoutingTable(int p_outputPort)
 */
 int RoutingTable::tableLength()
 {
-    int length = 0;
-    struct_Route * l_iterator = new struct_Route;
-    l_iterator = m_headOfRoutingTable;
-    while(l_iterator->next!=0)
-    {
-        length++;
-        l_iterator = l_iterator->next;
-    }
-    return length;
+    return m_MainTable.size();
 }
 
 // IIRO for testing. FIll routing table and add some preferred ASes
@@ -1100,12 +921,8 @@ void RoutingTable::fillRoutingTable()
     int mask;
     int OutputPort;
 
-    int AS1;
-    int AS2;
-    int AS3;
-    string ASes;
+    vector<unsigned> ASPath(3);
     stringstream ss;
-    string l_message;
     srand(time(NULL));
 
     for(int i=0;i<4;i++)
@@ -1119,12 +936,9 @@ void RoutingTable::fillRoutingTable()
         prefix = ss.str();
         ss.str("");
 
-        AS1 = 1+(rand()%5000);
-        AS2 = 1+(rand()%5000);
-        AS3 = 1+(rand()%5000);
-        ss << AS1 << "-" << AS2 << "-" << AS3;
-        ASes = ss.str();
-        ss.str("");
+        ASPath[0] = 1+(rand()%5000);
+        ASPath[1] = 1+(rand()%5000);
+        ASPath[2] = 1+(rand()%5000);
 
         mask = 1+(rand()%8);
         OutputPort = 1+(rand()%20);
@@ -1133,40 +947,42 @@ void RoutingTable::fillRoutingTable()
         if(i==1)
         {
             prefix = "50.40.200.0";
-            ASes = "50-70-100";
+            ASPath[0] = 50;
+            ASPath[1] = 70;
+            ASPath[2] = 100;
             mask = 2;
             OutputPort = 10;
         }
-        int withdrawOrAd = 0;
+        struct_Prefix l_prefix;
+        l_prefix.prefix = m_Reporter.ipToUInt(prefix);
+        l_prefix.length = mask;
 
-        ss << withdrawOrAd << "," << prefix << "," << mask << "," << ASes;
-        l_message = ss.str();
-
-        addRouteToRawTable(l_message,OutputPort);
-        addRouteToRawTable(l_message,OutputPort);
+        addRouteToRawTable(l_prefix,ORIGIN_IGP,ASPath,OutputPort);
+        addRouteToRawTable(l_prefix,ORIGIN_IGP,ASPath,OutputPort);
 
     }
 
 }
 
-bool RoutingTable::write(BGPMessage& p_BGPMsg)
+bool RoutingTable::write(BGPMessageHandle& p_BGPMsg)
 {
-	m_ReceivingBufferMutex.lock();
 	if(isRunning())
 		m_ReceivingBuffer.write(p_BGPMsg);
-	m_ReceivingBufferMutex.unlock();
 	return true;
 }
 
+bool RoutingTable::nb_write(BGPMessageHandle& p_BGPMsg)
+{
+	return !isRunning() || m_ReceivingBuffer.nb_write(p_BGPMsg);
+}
+
 
 void RoutingTable::killRoutingTable(void)
 {
 	setUp(false);
 	clearRoutingTables();
-	while(m_ReceivingBuffer.num_available() > 0)
-		m_ReceivingBuffer.read(m_BGPMsg);
-
-	m_BGPMsg.clearMessage();
+	m_ReceivingBuffer.clear();
+	m_BGPMsg.reset();
 
 
 }
@@ -1175,12 +991,75 @@ void RoutingTable::reviveRoutingTable(void)
 {
 	addLocalRoute();
 	setUp(true);
+	m_Wakeup.notify(SC_ZERO_TIME);
+}
+
+void RoutingTable::end_of_elaboration()
+{
+	m_WorkEvents |= m_ReceivingBuffer.data_written_event();
+	m_WorkEvents |= m_Wakeup;
+	for (int i = 0; i < port_Session.size(); i++)
+		m_WorkEvents |= port_Session[i]->validityChangedEvent();
+}
+
+/*
+    The queued changes wait for the MRAI of their peer. They are work once it has expired, or once the session
+    is down and the queue is cleared
+*/
+bool RoutingTable::hasWork(sc_time & p_nextExpiry)
+{
+	p_nextExpiry = SC_ZERO_TIME;
+	if(m_ReceivingBuffer.num_available() > 0 || !m_DirtyPrefixes.empty())
+		return true;
+	for(unsigned i = 0; i < m_OutboundQueue.size(); i++)
+	{
+		if(m_OutboundQueue[i].empty())
+			continue;
+		if((int)i >= port_Session.size() || !port_Session[i]->isSessionValid())
+			return true;
+		sc_time expiry = port_Session[i]->getMRAIExpiry();
+		if(expiry <= sc_time_stamp())
+			return true;
+		if(p_nextExpiry == SC_ZERO_TIME || expiry < p_nextExpiry)
+			p_nextExpiry = expiry;
+	}
+	if(m_sessions.size() < (unsigned)m_RTConfig->getNumberOfInterfaces()-1)
+		return true;
+	for(unsigned i = 0; i < m_sessions.size() && (int)i < port_Session.size(); i++)
+		if(m_sessions[i] != (port_Session[i]->isSessionValid() ? 1 : 0))
+			return true;
+	return false;
+}
+
+void RoutingTable::waitForWork(void)
+{
+#ifdef _EVENT_DRIVEN
+	sc_time nextExpiry;
+	if(hasWork(nextExpiry))
+		wait(timeToNextEdge(CLOCK_PERIOD));
+	else if(nextExpiry == SC_ZERO_TIME)
+	{
+		wait(m_WorkEvents);
+		wait(timeToNextEdge(CLOCK_PERIOD));
+	}
+	else
+	{
+		// Sleep until the edge where a clocked thread would find the MRAI expired, unless other work comes first
+		sc_time edge = firstEdgeFrom(nextExpiry, CLOCK_PERIOD);
+		wait(edge - sc_time_stamp(), m_WorkEvents);
+		if(sc_time_stamp() < edge)
+			wait(timeToNextEdge(CLOCK_PERIOD));
+	}
+#else
+	wait();
+#endif
 }
 
 void RoutingTable::setUp(bool p_Value)
 {
 	m_UpMutex.lock();
 	m_Up = p_Value;
+	m_Generation++;
 	m_UpMutex.unlock();
 }
 
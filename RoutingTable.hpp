@@ -20,7 +20,14 @@
 #include "Configuration.hpp"
 #include "BGPSession_If.hpp"
 #include "Output_If.hpp"
+#include "SPSCChannel.hpp"
 #include "StringTools.hpp"
+#include "ForwardingTable.hpp"
+#include "PathAttributeTable.hpp"
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace std;
 using namespace sc_core;
@@ -32,27 +39,44 @@ using namespace sc_dt;
 
 #define AS_EMPTY "#"
 
+// Key of a prefix&mask combination: the prefix in the high 32 bits and the mask in the low ones
+typedef unsigned long long RouteKey;
+
 struct struct_Route
 {
     int id;
     string prefix;
     int mask;
-    string ASes;
+    const struct_PathAttributes * attributes;  // interned ORIGIN and AS-path, own AS first
     int OutputPort;
-    struct_Route * next;
+    RouteKey key;
+};
+
+// Type of a change in the best route of a prefix
+enum RouteChangeType {ROUTE_ADDED, ROUTE_REPLACED, ROUTE_REMOVED};
+
+// One entry of the change list produced by the decision process
+struct struct_RouteChange
+{
+    RouteChangeType type;
+    RouteKey key;
+    struct_Route * newRoute;    // best route after the change, 0 if the prefix was removed
+    struct_Route * oldRoute;    // best route before the change, 0 if the prefix was added
 };
 
-class RoutingTable: public sc_module, public RoutingTable_If, public Output_If<BGPMessage>
+class RoutingTable: public sc_module, public RoutingTable_If, public Output_If<BGPMessageHandle>
 {
 
 public:
 
 
+#ifndef _EVENT_DRIVEN
     /*! \brief System clock signal
      * \details The router's internal clock
      * \public
      */
     sc_in_clk port_Clk;
+#endif
 
 
     /*! \brief Control port
@@ -66,10 +90,10 @@ public:
      * \details The RoutingTable writes all the BGP messages to be send
      * to its neighbors into
      * this port. The port should be bind to the Data Plane's.
-     * receiving FIFO
+     * receiving FIFO. The messages are moved to the port.
      * \public
      */
-    sc_port<Output_If> port_Output;
+    sc_port<Output_If<BGPMessageHandle> > port_Output;
 
 
     //    void before_end_of_elaboration()
@@ -109,6 +133,18 @@ public:
      */
     virtual int resolveRoute(string  p_IPAddress);
 
+    /*! \brief
+     * \details
+     * \public
+     */
+    virtual int resolveRoute(unsigned p_IPAddress);
+
+    /*! \brief
+     * \details
+     * \public
+     */
+    virtual unsigned long getGeneration(void);
+
 
 
     /*! \brief Indicate the systemC producer that this module has a process.
@@ -117,7 +153,15 @@ public:
      */
     SC_HAS_PROCESS(RoutingTable);
 
-    bool addRouteToRawTable(string p_msg, int p_outputPort);
+    /*! \brief Collects the events that wake up the event-driven thread
+     * \details The data_written event of the receiving buffer, the
+     * validity changes of the sessions and the local wakeup
+     * \public
+     */
+    void end_of_elaboration();
+
+    // Add a route advertised by the peer in p_outputPort to its Adj-RIB-In
+    bool addRouteToRawTable(const struct_Prefix & p_prefix, unsigned char p_origin, const vector<unsigned> & p_ASPath, int p_outputPort);
     //void setMED(int p_routeId,)
 
     // Give preferred AS and some preference value to it.
@@ -141,7 +185,21 @@ public:
     // Remove all the routes from raw routing table and update maintable as well after that
     void clearRoutingTables();
 
-    virtual bool write(BGPMessage& p_BGPMsg);
+    // Withdraw a prefix originated by this AS from the peers. Return false if the prefix is not originated here
+    bool withdrawLocalPrefix(const struct_Prefix & p_prefix);
+
+    // Return the size of the RIBs. Syntax: Adj-RIB-In routes,best routes,estimated bytes,peak estimated bytes
+    string getRIBStatistics();
+
+    // Return the statistics of the FIB. Syntax: routes,groups,bytes,rebuild time,lookups,trie blocks
+    string getFIBStatistics();
+
+    // Return the bytes of the compiled FIB, 0 if the router has not forwarded any data
+    unsigned long getFIBMemory();
+
+    virtual bool write(BGPMessageHandle& p_BGPMsg);
+
+    virtual bool nb_write(BGPMessageHandle& p_BGPMsg);
 
 
     void killRoutingTable(void);
@@ -160,76 +218,82 @@ public:
 
 private:
 
-    sc_mutex m_ReceivingBufferMutex;
-
     /*! \brief Receiving buffer
-     * \details Data plain writes all the received BGP messages into
-     * this fifo
+     * \details The sessions move the received updates and
+     * notifications into this buffer
      * \private
      */
-    sc_fifo<BGPMessage> m_ReceivingBuffer;
+    SPSCChannel<BGPMessageHandle> m_ReceivingBuffer;
 
     void addLocalRoute(void);
 
-    // Advertise this route to peers
+    // Queue the current state of p_Key's prefix to be sent to the peer in p_Outputport
+    void queueRoute(RouteKey p_Key, int p_Outputport);
 
-    void advertiseRoute(struct_Route * p_route, int p_Outputport);
+    // Send the queued prefixes to the peer in p_Outputport packed into as few UPDATE-messages as possible.
+    // Nothing is sent before the MRAI of the session has expired
+    void flushOutboundQueue(int p_Outputport);
+
+    // Forget the outbound queue and the Adj-RIB-Out of the peer in p_Outputport
+    void clearAdjRibOut(int p_Outputport);
+
+    // Send the prefixes of m_UpdateOut to the peer in p_Outputport. The path attributes are kept for the next message
+    void sendUpdate(int p_Outputport);
 
 //=======
 //    void advertiseRoute(struct_Route * p_route, int p_outPutIf);
 //>>>>>>> 4ee3ed4b07096339af037a9f7c39dbd08e896861
 
-    // Construct new route from p_msg.
-    bool createRoute(string p_msg,int p_outputPort, struct_Route * p_route);
+    // Construct new route from an NLRI prefix and its path attributes.
+    bool createRoute(const struct_Prefix & p_prefix, unsigned char p_origin, const vector<unsigned> & p_ASPath, int p_outputPort, struct_Route * p_route);
+
+    // Delete p_route and release its path attributes
+    void releaseRoute(struct_Route * p_route);
 
     // Handle NOTIFICATION message type
     void handleNotification (BGPMessage NOTIFICATION_message);
 
-    // Return struct_Route which prefix is p_prefix
-    struct_Route * findRoute(string p_prefix);
-
-    // Return how many bits are the same from p_route and p_IP. Used for deciding which route to use
-    int matchLength(struct_Route * p_route, string p_IP);
-
-    // Update MainRoutingTable. Iterate through the RawRoutingTable and pick the preferred routes from there to MainRoutingTable
+    // Update MainRoutingTable. Run the decision process for the dirty prefixes and apply the change list
     void updateRoutingTable();
 
-    // Take two routes as a parameter and add the more preferred one to MainRoutingTable
-    void addPreferredRoute(struct_Route p_route1, struct_Route p_route2);
+    // Pick the preferred candidate of p_Key to MainRoutingTable. Append the change to the change list
+    // and return true if the best route changed. An identical re-advertisement is not a change
+    bool selectBestRoute(RouteKey p_Key);
+
+    // Update the FIB and queue the changed best route to the peers
+    void applyRouteChange(const struct_RouteChange & p_change);
 
-    // Add p_route to MainRoutingTable
-    void setRoute(struct_Route p_route);
+    // Return true if p_route1 is preferred over p_route2
+    bool isPreferred(struct_Route * p_route1, struct_Route * p_route2);
 
-    // Remove route from RawRoutingTable
-    void removeFromRawTable(int p_routeId);
+    // Return the highest preference value of the preferred ASes on the AS-path of p_route
+    int localPreference(struct_Route * p_route);
 
-    // Remove route from MainRoutingTable
-    void removeFromRoutingTable(int p_routeId);
+    // Unlink the route of p_Key from the Adj-RIB-In of p_outputPort and mark the prefix dirty.
+    // The route is deleted after the next update. Return true if the route was found
+    bool removeFromRawTable(int p_outputPort, RouteKey p_Key);
 
-    // Return true if p_route1 and p_route2 has the same prefix&mask combination
-    bool sameRoutes(struct_Route p_route1, struct_Route p_route2);
+    // Return the key of the prefix&mask combination
+    static RouteKey routeKey(unsigned p_prefix, int p_mask);
 
     // Return the ASPathLength of p_route
-    int ASpathLength(struct_Route p_route);
+    int ASpathLength(struct_Route * p_route);
 
     // Convert p_route to string. Syntax: ID,Prefix,Mask,Routers,ASes (e.g. 5,100100200050,8,2-4-6-7,100-4212-231-22)
     string routeToString(struct_Route p_route);
 
-    // Convert the hole RoutingTable to string. Start from p_route
-    string routingTableToString(struct_Route * p_route);
-
     // Delete routes from RawRoutingTable with given output port
     void deleteRoutes(int p_outputPort);
 
-    // Send withdraw-message to all peers
-    void sendWithdraw(struct_Route p_route, int p_OutputPort);
-
-    // Handle received withdraw message
-    void handleWithdraw(string p_message);
+    // Handle a withdrawn route received from the peer in p_outputPort
+    void handleWithdraw(const struct_Prefix & p_prefix, int p_outputPort);
 
     // Return the length of the table
     int tableLength();
 
+    // Return an estimate of the memory held by the RIBs in bytes
+    unsigned long ribMemory();
+
     // Advertise the whole RawRoutingTable to one peer
     void advertiseRawRoutingTable(int p_outputPort);
 
@@ -246,19 +310,116 @@ private:
      * \details
      * \private
      */
-    BGPMessage m_BGPMsg;
+    BGPMessageHandle m_BGPMsg;
 
-    // Pointer to the heads and ends of the tables
-    struct_Route * m_headOfRawTable;
-    struct_Route * m_endOfRawTable;
-    struct_Route * m_iterator;
+    /*! \brief RawRoutingTable as one Adj-RIB-In per peer
+     * \details Indexed by the output port. Each peer has at most one
+     * route per prefix&mask combination. The routes are owned by this table.
+     * \private
+     */
+    vector< unordered_map<RouteKey, struct_Route *> > m_AdjRibIn;
 
-    struct_Route * m_headOfRoutingTable;
-    struct_Route * m_endOfRoutingTable;
+    /*! \brief Candidate routes of each prefix from all the peers
+     * \details The decision process of a prefix only looks at its own
+     * candidates.
+     * \private
+     */
+    unordered_map<RouteKey, vector<struct_Route *> > m_Candidates;
+
+    /*! \brief MainRoutingTable
+     * \details The best route of each prefix. The routes point into the
+     * Adj-RIB-In of the peer they were learned from.
+     * \private
+     */
+    map<RouteKey, struct_Route *> m_MainTable;
+
+    // Id for the next route added to the RawRoutingTable
+    int m_NextRouteId;
+
+    /*! \brief Largest RIB memory estimate seen after an update
+     * \details Measured before the unlinked routes are released, so a
+     * route being replaced counts twice as it does in the heap
+     * \private
+     */
+    unsigned long m_PeakRIBMemory;
+
+    /*! \brief Prefixes whose candidates changed since the last update
+     * \details Filled by addRouteToRawTable, handleWithdraw and
+     * deleteRoutes. updateRoutingTable runs the decision process only
+     * for these prefixes, so an idle router does no table work.
+     * \private
+     */
+    unordered_set<RouteKey> m_DirtyPrefixes;
+
+    /*! \brief Best route changes produced by the decision process
+     * \details Drives the FIB updates and the advertisements.
+     * \private
+     */
+    vector<struct_RouteChange> m_ChangeList;
+
+    /*! \brief Routes unlinked from the Adj-RIB-In
+     * \details MainRoutingTable and the change list may still point to
+     * them, so they are deleted at the end of the update.
+     * \private
+     */
+    vector<struct_Route *> m_RemovedRoutes;
+
+    /*! \brief Outbound queue of each peer
+     * \details Indexed by the output port. Holds the prefixes whose
+     * state is to be sent to the peer. A prefix that changes several
+     * times before the queue is flushed is sent only once, with the
+     * best route it has at the time of the flush.
+     * \private
+     */
+    vector< set<RouteKey> > m_OutboundQueue;
+
+    /*! \brief Adj-RIB-Out of each peer
+     * \details Indexed by the output port. Holds the path attributes
+     * of the route last advertised to the peer for each prefix. A
+     * queued prefix whose route equals the advertised one is not sent
+     * again and only the prefixes found here are withdrawn. Each entry
+     * holds a reference to its attributes.
+     * \private
+     */
+    vector< unordered_map<RouteKey, const struct_PathAttributes *> > m_AdjRibOut;
+
+    /*! \brief Path attributes of all the routes
+     * \details The routes with the same ORIGIN and AS-path share one
+     * interned attribute set
+     * \private
+     */
+    PathAttributeTable m_PathAttributes;
+
+    /*! \brief Forwarding table compiled from the MainRoutingTable
+     * \details Kept up to date by applyRouteChange.
+     * resolveRoute answers the data plane from this table.
+     * \private
+     */
+    ForwardingTable m_FIB;
+
+    /*! \brief Generation of the forwarding table
+     * \details Incremented whenever the FIB changes or the routing
+     * table is killed or revived
+     * \private
+     */
+    unsigned long m_Generation;
 
     // This is used to save the previous state of each session. 1 - UP , 0 - DOWN
     vector<int> m_sessions;
 
+    // Notified when the local routes change outside of the thread
+    sc_event m_Wakeup;
+
+    // Any of these wakes up the thread in the event-driven build
+    sc_event_or_list m_WorkEvents;
+
+    // Check if a message, a dirty prefix, a queued change that may be sent or a session change is waiting.
+    // Otherwise p_nextExpiry is the earliest MRAI expiry of the peers with queued changes, SC_ZERO_TIME if none.
+    bool hasWork(sc_time & p_nextExpiry);
+
+    // Wait for the next clock edge. In the event-driven build sleep until there is work or an MRAI expires.
+    void waitForWork(void);
+
 
 
     // Preferred ASes and their preference values are stored in here
@@ -282,8 +443,6 @@ private:
 
     bool m_NewInputMsg;
 
-    BGPMessage m_PreviousInput;
-
     BGPMessage m_UpdateOut;
 
     sc_time limit;
@@ -296,8 +455,6 @@ private:
 
     sc_mutex m_UpMutex;
 
-    BGPMessage m_Previous;
-
 
 };
 
@@ -31,13 +31,30 @@ class RoutingTable_If: virtual public sc_interface
 public:
 
 
-    //TODO
-    /*! \brief Set new route to the Routing Table
-     * \details
+    /*! \brief Resolves the output port for a destination address
+     * \details The text form is for the GUI and the reports. The data
+     * plane uses the integer overload.
+     * @param[in] string p_IPAddress The destination in dotted decimal
+     * \return int: the output port or -1 if there is no route
      * \public
      */
     virtual int resolveRoute(string p_IPAddress) = 0;
 
+    /*! \brief Resolves the output port for a destination address
+     * @param[in] unsigned p_IPAddress The destination in host byte order
+     * \return int: the output port or -1 if there is no route
+     * \public
+     */
+    virtual int resolveRoute(unsigned p_IPAddress) = 0;
+
+    /*! \brief Returns the generation of the routing table
+     * \details The generation changes whenever the result of
+     * resolveRoute may change. Route caches compare it to the
+     * generation of their entries.
+     * \public
+     */
+    virtual unsigned long getGeneration(void) = 0;
+
 
 
 
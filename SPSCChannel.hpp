@@ -0,0 +1,185 @@
+/*! \file  SPSCChannel.hpp
+ *  \brief     Header file of SPSCChannel class template
+ *  \details   Defines a SystemC channel on top of SPSCRing
+ */
+
+/*!
+ * \class SPSCChannel
+ * \brief Bounded FIFO channel that moves its items through an SPSCRing
+ *  \details Replaces sc_fifo on the message paths inside a router. The
+ *  items are moved in and out of the ring, so a channel of message
+ *  handles passes the messages without copying them, and a packet
+ *  read out of it does not share its PDU with the slot. As in sc_fifo,
+ *  the items written during a delta cycle become readable and the
+ *  slots read during it are reported free only in the update phase,
+ *  which also notifies the data_written and data_read events. The
+ *  channel serves one consuming process, and its producers shall run
+ *  in the SystemC kernel thread, where they do not preempt each other.
+ *  A module that is moved to an OS thread of its own shall be
+ *  connected with an SPSCRing of the same items instead.
+ */
+
+
+#include "systemc"
+#include "Output_If.hpp"
+#include "Input_If.hpp"
+#include "SPSCRing.hpp"
+#include <utility>
+
+using namespace std;
+using namespace sc_core;
+
+
+#ifndef _SPSCCHANNEL_H_
+#define _SPSCCHANNEL_H_
+
+/*!
+ * The default number of slots, which is the default size of sc_fifo
+ */
+#define SPSC_CHANNEL_SIZE 16
+
+
+template <class T>
+class SPSCChannel: public sc_prim_channel, public Output_If<T>, public Input_If<T>
+{
+
+public:
+
+    /*! \fn SPSCChannel(unsigned p_Capacity)
+     * \brief Creates the channel
+     * @param [in] unsigned p_Capacity The number of slots. Shall be a
+     * power of two.
+     * \public
+     */
+    explicit SPSCChannel(unsigned p_Capacity = SPSC_CHANNEL_SIZE):m_Ring(p_Capacity), m_Available(0), m_Written(0), m_Read(0)
+    {
+    }
+
+    /*! \brief Moves the item into the channel
+     * \details Waits until there is a free slot, so it shall be called
+     * from a thread only
+     * \return bool: always true
+     * \public
+     */
+    virtual bool write(T& p_Item)
+    {
+        while(!nb_write(p_Item))
+            wait(m_DataRead);
+        return true;
+    }
+
+    /*! \brief Moves the item into the channel without waiting
+     * \return bool: false if the channel is full, in which case the
+     * item is left untouched
+     * \public
+     */
+    virtual bool nb_write(T& p_Item)
+    {
+        if(!m_Ring.push(move(p_Item)))
+            return false;
+        m_Written++;
+        request_update();
+        return true;
+    }
+
+    /*! \sa Input_If
+     */
+    virtual bool nb_read(T& p_Item)
+    {
+        if(m_Available == 0 || !m_Ring.pop(p_Item))
+            return false;
+        m_Available--;
+        m_Read++;
+        request_update();
+        return true;
+    }
+
+    /*! \fn void clear(void)
+     * \brief Drops the readable items
+     * \public
+     */
+    void clear(void)
+    {
+        T l_Item;
+        while(nb_read(l_Item))
+            ;
+    }
+
+    /*! \sa Input_If
+     */
+    virtual int num_available(void) const
+    {
+        return m_Available;
+    }
+
+    int num_free(void) const
+    {
+        return m_Ring.capacity() - m_Ring.size();
+    }
+
+    /*! \sa Input_If
+     */
+    virtual const sc_event& data_written_event(void) const
+    {
+        return m_DataWritten;
+    }
+
+    const sc_event& data_read_event(void) const
+    {
+        return m_DataRead;
+    }
+
+protected:
+
+    /*! \fn virtual void update(void)
+     * \brief Publishes the writes and the reads of the delta cycle
+     * \protected
+     */
+    virtual void update(void)
+    {
+        if(m_Written > 0)
+            {
+                m_Available += m_Written;
+                m_Written = 0;
+                m_DataWritten.notify(SC_ZERO_TIME);
+            }
+        if(m_Read > 0)
+            {
+                m_Read = 0;
+                m_DataRead.notify(SC_ZERO_TIME);
+            }
+    }
+
+private:
+
+    SPSCChannel(const SPSCChannel&);
+
+    SPSCChannel& operator = (const SPSCChannel&);
+
+    SPSCRing<T> m_Ring;
+
+    /*! \property int m_Available
+     * \brief The number of items that the reader may take
+     * \private
+     */
+    int m_Available;
+
+    /*! \property int m_Written
+     * \brief The number of items written during the delta cycle
+     * \private
+     */
+    int m_Written;
+
+    /*! \property int m_Read
+     * \brief The number of items read during the delta cycle
+     * \private
+     */
+    int m_Read;
+
+    sc_event m_DataWritten;
+
+    sc_event m_DataRead;
+};
+
+
+#endif /* _SPSCCHANNEL_H_ */
@@ -0,0 +1,217 @@
+/*! \file  SPSCRing.hpp
+ *  \brief     Header file of SPSCRing class template
+ *  \details   Defines a lock-free single producer single consumer ring
+ */
+
+/*!
+ * \class SPSCRing
+ * \brief Bounded lock-free queue between one producer and one consumer
+ *  \details The head is written only by the consumer and the tail only
+ *  by the producer. Both are free-running counters, so the ring is
+ *  empty when they are equal and full when they differ by the
+ *  capacity. The counters sit on cache lines of their own so that the
+ *  two sides do not invalidate each other's line on every access. The
+ *  ring may either own its slots or use slots given by the caller, for
+ *  example a region shared between processes. In the latter case the
+ *  ring object itself shall be placed into the same region. The items
+ *  are moved in and out, so a ring of handles passes the objects
+ *  without copying them.
+ */
+
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+using namespace std;
+
+
+#ifndef _SPSCRING_H_
+#define _SPSCRING_H_
+
+
+template <class T>
+class SPSCRing
+{
+
+public:
+
+    /*! \fn SPSCRing(unsigned p_Capacity)
+     * \brief Allocates the slots of the ring
+     * @param [in] unsigned p_Capacity The number of slots. Shall be a
+     * power of two.
+     * \public
+     */
+    explicit SPSCRing(unsigned p_Capacity):m_Slots(new T[p_Capacity]), m_Mask(p_Capacity - 1), m_Owner(true), m_Head(0), m_Tail(0)
+    {
+    }
+
+    /*! \fn SPSCRing(T *p_Slots, unsigned p_Capacity)
+     * \brief Uses the slots given by the caller
+     * \details The slots are not freed by the ring
+     * @param [in] T *p_Slots The slots
+     * @param [in] unsigned p_Capacity The number of slots. Shall be a
+     * power of two.
+     * \public
+     */
+    SPSCRing(T *p_Slots, unsigned p_Capacity):m_Slots(p_Slots), m_Mask(p_Capacity - 1), m_Owner(false), m_Head(0), m_Tail(0)
+    {
+    }
+
+    ~SPSCRing(void)
+    {
+        if(m_Owner)
+            delete[] m_Slots;
+    }
+
+    /*! \fn bool push(const T& p_Item)
+     * \brief Appends a copy of the item. Called by the producer only.
+     * \return bool: false if the ring is full
+     * \public
+     */
+    bool push(const T& p_Item)
+    {
+        unsigned l_Tail = m_Tail.load(memory_order_relaxed);
+        if(l_Tail - m_Head.load(memory_order_acquire) > m_Mask)
+            return false;
+        m_Slots[l_Tail & m_Mask] = p_Item;
+        m_Tail.store(l_Tail + 1, memory_order_release);
+        return true;
+    }
+
+    /*! \fn bool push(T&& p_Item)
+     * \brief Moves the item into the ring. Called by the producer only.
+     * \details The item is left untouched if the ring is full
+     * \return bool: false if the ring is full
+     * \public
+     */
+    bool push(T&& p_Item)
+    {
+        unsigned l_Tail = m_Tail.load(memory_order_relaxed);
+        if(l_Tail - m_Head.load(memory_order_acquire) > m_Mask)
+            return false;
+        m_Slots[l_Tail & m_Mask] = move(p_Item);
+        m_Tail.store(l_Tail + 1, memory_order_release);
+        return true;
+    }
+
+    /*! \fn T *claim(void)
+     * \brief Returns the next free slot to be filled in place
+     * \details The slot is published by commit(). Called by the
+     * producer only.
+     * \return T*: the slot or NULL if the ring is full
+     * \public
+     */
+    T *claim(void)
+    {
+        unsigned l_Tail = m_Tail.load(memory_order_relaxed);
+        if(l_Tail - m_Head.load(memory_order_acquire) > m_Mask)
+            return NULL;
+        return &m_Slots[l_Tail & m_Mask];
+    }
+
+    /*! \fn void commit(void)
+     * \brief Publishes the slot returned by claim()
+     * \public
+     */
+    void commit(void)
+    {
+        m_Tail.store(m_Tail.load(memory_order_relaxed) + 1, memory_order_release);
+    }
+
+    /*! \fn bool pop(T& p_Item)
+     * \brief Moves the oldest item out of the ring. Called by the
+     * consumer only.
+     * \return bool: false if the ring is empty
+     * \public
+     */
+    bool pop(T& p_Item)
+    {
+        unsigned l_Head = m_Head.load(memory_order_relaxed);
+        if(l_Head == m_Tail.load(memory_order_acquire))
+            return false;
+        p_Item = move(m_Slots[l_Head & m_Mask]);
+        m_Head.store(l_Head + 1, memory_order_release);
+        return true;
+    }
+
+    /*! \fn const T *front(void)
+     * \brief Returns the oldest item to be read in place
+     * \details The slot is freed by release(). Called by the consumer
+     * only.
+     * \return const T*: the item or NULL if the ring is empty
+     * \public
+     */
+    const T *front(void)
+    {
+        unsigned l_Head = m_Head.load(memory_order_relaxed);
+        if(l_Head == m_Tail.load(memory_order_acquire))
+            return NULL;
+        return &m_Slots[l_Head & m_Mask];
+    }
+
+    /*! \fn void release(void)
+     * \brief Frees the slot returned by front()
+     * \public
+     */
+    void release(void)
+    {
+        m_Head.store(m_Head.load(memory_order_relaxed) + 1, memory_order_release);
+    }
+
+    /*! \fn unsigned size(void) const
+     * \brief Returns the number of queued items
+     * \details Exact only when called by either side while the other
+     * side is idle
+     * \public
+     */
+    unsigned size(void) const
+    {
+        return m_Tail.load(memory_order_acquire) - m_Head.load(memory_order_acquire);
+    }
+
+    bool empty(void) const
+    {
+        return size() == 0;
+    }
+
+    unsigned capacity(void) const
+    {
+        return m_Mask + 1;
+    }
+
+private:
+
+    SPSCRing(const SPSCRing&);
+
+    SPSCRing& operator = (const SPSCRing&);
+
+    /*! \property T *m_Slots
+     * \brief The storage of the items
+     * \private
+     */
+    T *m_Slots;
+
+    /*! \property unsigned m_Mask
+     * \brief The capacity minus one
+     * \private
+     */
+    unsigned m_Mask;
+
+    bool m_Owner;
+
+    /*! \property atomic<unsigned> m_Head
+     * \brief The number of items popped
+     * \private
+     */
+    alignas(64) atomic<unsigned> m_Head;
+
+    /*! \property atomic<unsigned> m_Tail
+     * \brief The number of items pushed
+     * \private
+     */
+    alignas(64) atomic<unsigned> m_Tail;
+};
+
+
+#endif /* _SPSCRING_H_ */
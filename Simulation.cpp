@@ -10,12 +10,33 @@
 #include "Simulation.hpp"
 #include "ReportGlobals.hpp"
 #include "GUIProtocolTags.hpp"
+#include "ClockTick.hpp"
+#include <sys/resource.h>
 
-Simulation::Simulation(sc_module_name p_ModuleName, ServerSocket& p_GUISocket, SimulationConfig * const p_SimuConfiguration):sc_module(p_ModuleName), m_GUISocket(p_GUISocket), m_SimuConfiguration(p_SimuConfiguration)
+/*!
+ * \brief Tells whether a command changes the routing and thus starts a
+ * new convergence phase of a batch run
+ */
+static bool changesRouting(const string& p_Cmd)
 {
+	return p_Cmd.compare(RESET_ROUTER) == 0 || p_Cmd.compare(KILL_ROUTER) == 0 || p_Cmd.compare(REVIVE_ROUTER) == 0
+		|| p_Cmd.compare(CONNECT) == 0 || p_Cmd.compare(DISCONNECT) == 0 || p_Cmd.compare(SET_LOCAL_PREF) == 0
+		|| p_Cmd.compare(SET_KEEPALIVE) == 0 || p_Cmd.compare(SET_HOLDDOWN_MULT) == 0 || p_Cmd.compare(SET_MRAI) == 0
+		|| p_Cmd.compare(WITHDRAW_PREFIX) == 0;
+}
 
+Simulation::Simulation(sc_module_name p_ModuleName, ServerSocket& p_GUISocket, SimulationConfig * const p_SimuConfiguration):sc_module(p_ModuleName), m_GUISocket(p_GUISocket), m_SimuConfiguration(p_SimuConfiguration), m_PartitionId(0), m_Stopped(false), m_NextCommand(0)
+{
+	buildNetwork(vector<int>(), PartitionChannelMap(), SC_ZERO_TIME);
+}
 
+Simulation::Simulation(sc_module_name p_ModuleName, ServerSocket& p_GUISocket, SimulationConfig * const p_SimuConfiguration, const vector<int>& p_Assignment, int p_PartitionId, const PartitionChannelMap& p_Channels, const sc_time& p_Window):sc_module(p_ModuleName), m_GUISocket(p_GUISocket), m_SimuConfiguration(p_SimuConfiguration), m_PartitionId(p_PartitionId), m_Stopped(false), m_NextCommand(0)
+{
+	buildNetwork(p_Assignment, p_Channels, p_Window);
+}
 
+void Simulation::buildNetwork(const vector<int>& p_Assignment, const PartitionChannelMap& p_Channels, const sc_time& p_Window)
+{
 	//  DEBUGGING
 	m_Name.appendReportString("Router count: ");
 	SC_REPORT_INFO(g_DebugID, m_Name.appendReportString(m_SimuConfiguration->getNumberOfRouters()));
@@ -32,22 +53,35 @@ Simulation::Simulation(sc_module_name p_ModuleName, ServerSocket& p_GUISocket, S
 	m_Name.setBaseName("Router");
 
 
-	StringTools *l_HostName = new StringTools("Host");
-	/// \li Initiate the Router modules as m_Router
+	StringTools l_HostName("Host");
+	/// \li Initiate the Router modules of the partition as m_Router.
+	/// The names follow the index of the router, so they are the same
+	/// in every partition as in the single kernel run.
 	for(int i = 0; i < m_SimuConfiguration->getNumberOfRouters(); i++)
 	{
+		m_Router[i] = NULL;
+		m_Host[i] = NULL;
+		if(!p_Assignment.empty() && p_Assignment[i] != m_PartitionId)
+			continue;
+
 		/// \li Generate the routers
+		m_Name.setIdentifier(i);
+		l_HostName.setIdentifier(i);
 		m_Router[i] = new Router(m_Name.getNextName(), m_SimuConfiguration->getRouterConfigurationPtr(i));
-		m_Host[i] = new Host(l_HostName->getNextName(), m_SimuConfiguration->getHostConfigurationPtr(i));
+		m_Host[i] = new Host(l_HostName.getNextName(), m_SimuConfiguration->getHostConfigurationPtr(i));
 
 	}
 
 
 	///Build the network
 	RouterConfig *l_Handle;
+	StringTools l_LinkName("Link");
 	///connect all the routers
 	for (int i = 0; i < m_SimuConfiguration->getNumberOfRouters(); ++i)
 	{
+		if(m_Router[i] == NULL)
+			continue;
+
 		///get handle to the routers configuration object
 		l_Handle = m_SimuConfiguration->getRouterConfigurationPtr(i);
 
@@ -58,14 +92,34 @@ Simulation::Simulation(sc_module_name p_ModuleName, ServerSocket& p_GUISocket, S
 			///Connect only those interfaces that have been configured
 			if (l_Handle->isConnection(j))
 			{
+				int l_Neighbor = l_Handle->getNeighborRouterId(j);
+				int l_NeighborInterface = l_Handle->getNeighborInterfaceId(j);
+
 				///Connect the interfaces
-				if(l_Handle->getNeighborRouterId(j) == 0x7FFFFFFF)
+				if(l_Neighbor == 0x7FFFFFFF)
 				{
 					m_Router[i]->connectInterface(m_Host[i], j);
 				}
-				else if(m_Router[i]->connectInterface(m_Router[l_Handle->getNeighborRouterId(j)], j, l_Handle->getNeighborInterfaceId(j)))
+				else if(m_Router[l_Neighbor] != NULL)
 				{
-
+					m_Router[i]->connectInterface(m_Router[l_Neighbor], j, l_NeighborInterface);
+				}
+				else
+				{
+					///the neighbour is in another partition
+					PartitionChannelMap::const_iterator l_Outbound = p_Channels.find(make_pair(i, j));
+					PartitionChannelMap::const_iterator l_Inbound = p_Channels.find(make_pair(l_Neighbor, l_NeighborInterface));
+					if(l_Outbound == p_Channels.end() || l_Inbound == p_Channels.end())
+					{
+						SC_REPORT_WARNING(g_ErrorID, "No channel for a link between partitions");
+						continue;
+					}
+
+					PartitionLink *l_Link = new PartitionLink(l_LinkName.getNextName(), l_Outbound->second, l_Inbound->second, p_Window);
+					m_Link[make_pair(i, j)] = l_Link;
+					//the router with the lower index is the client
+					//as it connects first in the single kernel run
+					m_Router[i]->connectInterface(l_Link, j, i < l_Neighbor);
 				}
 			}
 		}
@@ -76,7 +130,9 @@ Simulation::Simulation(sc_module_name p_ModuleName, ServerSocket& p_GUISocket, S
 	m_SimuConfiguration->ifModes();
 	//cout << "Simulation elaboration finished" << endl;
 	SC_THREAD(simulationMain);
+#ifndef _EVENT_DRIVEN
 	sensitive << port_Clk.pos();
+#endif
 
 
 }
@@ -85,6 +141,9 @@ Simulation::~Simulation()
 {
 
 	/// \li Free all the memory
+	for(map<pair<int, int>, PartitionLink*>::iterator it = m_Link.begin(); it != m_Link.end(); ++it)
+		delete it->second;
+
 	for(int i = 0; i < m_SimuConfiguration->getNumberOfRouters(); i++)
 		delete m_Router[i];
 
@@ -109,6 +168,9 @@ void Simulation::simulationMain(void)
 
 #else
 
+	///the cold start is the first convergence phase
+	beginPhase("START");
+
 #endif
 	bool run = true;
 	// m_GUISocket.set_non_blocking(true);
@@ -116,7 +178,8 @@ void Simulation::simulationMain(void)
 	//  int t = 20;
 	while(run)
 	{
-		wait();
+		if(!waitForWork())
+			break;
 
 #ifdef _GUI_TEST
 
@@ -190,6 +253,8 @@ void Simulation::simulationMain(void)
 
 #else
 
+		runScript();
+
 #endif
 	}//end of process loop
 
@@ -364,6 +429,17 @@ void Simulation::socketRoutine(void)
 			//set next server state to SEND
 			enum_State = SEND;
 
+		}
+		else if (m_Cmd.compare(READ_ROUTE_CACHE) == 0 && l_Param) ///READ_ROUTE_CACHE
+		{
+			//get the router ID
+			fieldRoutine(1);
+
+			//call the mehtod that returns the route cache statistics
+			m_Word = m_Router[m_IntBuffer[0]]->getRouteCacheStatistics();
+			//set next server state to SEND
+			enum_State = SEND;
+
 		}
 		else if (m_Cmd.compare(SET_LOCAL_PREF) == 0 && l_Param) ///SET_LOCAL_PREF
 		{
@@ -408,6 +484,33 @@ void Simulation::socketRoutine(void)
 			//set next server state to SEND
 			enum_State = SEND;
 
+		}
+		else if (m_Cmd.compare(SET_MRAI) == 0 && l_Param) ///SET_MRAI
+		{
+			//get the router ID
+			fieldRoutine(2);
+			//get pointer to the correct configuration object
+			RouterConfig *l_RConfig = m_SimuConfiguration->getRouterConfigurationPtr(m_IntBuffer[0]);
+			l_RConfig->setMRAITime(m_IntBuffer[1]);
+			//send acknowledgement
+			m_Word = ACK;
+			//set next server state to SEND
+			enum_State = SEND;
+
+		}
+		else if (m_Cmd.compare(WITHDRAW_PREFIX) == 0 && l_Param) ///WITHDRAW_PREFIX
+		{
+			//get the router ID, the prefix and its length
+			fieldRoutine(3);
+
+			if(m_Router[m_IntBuffer[0]]->withdrawPrefix(StringTools().ipToUInt(m_FieldBuffer[1]), m_IntBuffer[2]))
+				m_Word = ACK;
+			else
+				m_Word = NACK;
+
+			//set next server state to SEND
+			enum_State = SEND;
+
 		}
 		else if (m_Cmd.compare(SHOW_IF) == 0 && l_Param) /// SHOW_IF
 		{
@@ -429,6 +532,195 @@ void Simulation::socketRoutine(void)
 
 }
 
+void Simulation::scheduleCommand(const struct_ScheduledCommand& p_Command)
+{
+	m_Script.push_back(p_Command);
+}
+
+bool Simulation::waitForWork(void)
+{
+#if !defined(_EVENT_DRIVEN)
+	wait();
+#elif defined (_GUI) || defined (_GUI_TEST)
+	//the GUI socket is polled on every edge
+	wait(timeToNextEdge(CLOCK_PERIOD));
+#else
+	//sleep until the edge of the next scheduled command
+	if(m_NextCommand >= m_Script.size())
+		return false;
+	wait(firstEdgeFrom(sc_time(m_Script[m_NextCommand].time, SC_SEC), CLOCK_PERIOD) - sc_time_stamp());
+#endif
+	return true;
+}
+
+void Simulation::runScript(void)
+{
+	while(m_NextCommand < m_Script.size() && m_Script[m_NextCommand].time <= sc_time_stamp().to_seconds())
+	{
+		const struct_ScheduledCommand& l_Command = m_Script[m_NextCommand++];
+
+		//every partition starts the phase, so the phases of the
+		//partitions can be merged
+		if(changesRouting(l_Command.command.substr(0, l_Command.command.find(','))))
+			beginPhase(l_Command.command);
+
+		//the command of a router is executed by its own partition only
+		int l_Router = ConfigurationParser::getCommandRouter(l_Command.command, m_SimuConfiguration->getNumberOfRouters());
+		if(l_Router >= 0 && m_Router[l_Router] == NULL)
+			continue;
+
+		//the commands are executed as if they came from the GUI
+		m_Word = string("<CMD>") + l_Command.command + "</CMD>";
+		enum_State = ACTIVE;
+		socketRoutine();
+
+		if(l_Router >= 0 || m_PartitionId == 0)
+			m_CommandLog << "COMMAND," << sc_time_stamp().to_seconds() << "," << l_Command.command << "," << m_Word << endl;
+
+		if(enum_State == TERMINATE)
+		{
+			m_Stopped = true;
+			sc_stop();
+		}
+	}
+}
+
+void Simulation::beginPhase(const string& p_Command)
+{
+	if(!m_Phases.empty())
+		closePhase();
+
+	struct_MessageCounters l_Total = sumMessageCounters();
+	struct_ConvergencePhase l_Phase;
+	l_Phase.start = sc_time_stamp().to_seconds();
+	l_Phase.command = p_Command;
+	//the counts are made relative when the phase is closed
+	l_Phase.updates = l_Total.updates;
+	l_Phase.withdrawnRoutes = l_Total.withdrawnRoutes;
+	l_Phase.convergenceTime = -1;
+	m_Phases.push_back(l_Phase);
+}
+
+void Simulation::closePhase(void)
+{
+	struct_ConvergencePhase& l_Phase = m_Phases.back();
+	if(l_Phase.convergenceTime >= 0)
+		return;
+
+	struct_MessageCounters l_Total = sumMessageCounters();
+	l_Phase.updates = l_Total.updates - l_Phase.updates;
+	l_Phase.withdrawnRoutes = l_Total.withdrawnRoutes - l_Phase.withdrawnRoutes;
+	//no UPDATE at all means that the routing was already converged
+	l_Phase.convergenceTime = l_Phase.updates > 0 ? l_Total.lastUpdate.to_seconds() - l_Phase.start : 0;
+}
+
+struct_MessageCounters Simulation::sumMessageCounters(void)
+{
+	struct_MessageCounters l_Total;
+	l_Total.opens = l_Total.updates = l_Total.notifications = l_Total.keepalives = 0;
+	l_Total.withdrawnRoutes = 0;
+	l_Total.lastUpdate = SC_ZERO_TIME;
+
+	for(int i = 0; i < m_SimuConfiguration->getNumberOfRouters(); i++)
+	{
+		if(m_Router[i] == NULL)
+			continue;
+		const struct_MessageCounters& l_Counters = m_Router[i]->getMessageCounters();
+		l_Total.opens += l_Counters.opens;
+		l_Total.updates += l_Counters.updates;
+		l_Total.notifications += l_Counters.notifications;
+		l_Total.keepalives += l_Counters.keepalives;
+		l_Total.withdrawnRoutes += l_Counters.withdrawnRoutes;
+		if(l_Total.lastUpdate < l_Counters.lastUpdate)
+			l_Total.lastUpdate = l_Counters.lastUpdate;
+	}
+	return l_Total;
+}
+
+unsigned long Simulation::getNumberOfMessages(void)
+{
+	struct_MessageCounters l_Total = sumMessageCounters();
+	return l_Total.opens + l_Total.updates + l_Total.notifications + l_Total.keepalives;
+}
+
+unsigned long Simulation::getFixedMemory(void)
+{
+	unsigned long l_Bytes = 0;
+	//each router has a host of its own
+	for(int i = 0; i < m_SimuConfiguration->getNumberOfRouters(); i++)
+		if(m_Router[i] != NULL)
+			l_Bytes += m_Router[i]->getFixedMemory() + m_Host[i]->getPacketPoolMemory();
+	return l_Bytes;
+}
+
+void Simulation::receiveLinks(void)
+{
+	for(map<pair<int, int>, PartitionLink*>::iterator it = m_Link.begin(); it != m_Link.end(); ++it)
+		it->second->receive();
+}
+
+unsigned long Simulation::getLinkOverflows(void)
+{
+	unsigned long l_Overflows = 0;
+	for(map<pair<int, int>, PartitionLink*>::iterator it = m_Link.begin(); it != m_Link.end(); ++it)
+		l_Overflows += it->second->getOverflows();
+	return l_Overflows;
+}
+
+bool Simulation::isStopped(void)
+{
+	return m_Stopped;
+}
+
+void Simulation::writeUsage(ostream& p_Output, double p_WallClock, long p_BaselineKB)
+{
+	p_Output << "WALL_CLOCK," << p_WallClock << endl;
+
+	int l_Sessions = 0;
+	for(int i = 0; i < m_SimuConfiguration->getNumberOfRouters(); i++)
+		if(m_Router[i] != NULL)
+			l_Sessions += m_SimuConfiguration->getRouterConfiguration(i).getNumberOfInterfaces() - 1;
+
+	struct rusage l_Usage;
+	getrusage(RUSAGE_SELF, &l_Usage);
+	long l_FixedKB = getFixedMemory() / 1024;
+	long l_SessionKB = l_Usage.ru_maxrss - p_BaselineKB - l_FixedKB;
+	p_Output << "MEMORY," << l_Sessions << "," << l_Usage.ru_maxrss << "," << p_BaselineKB << "," << l_FixedKB << "," << (l_Sessions > 0 ? l_SessionKB * 1024 / l_Sessions : 0) << endl;
+
+	unsigned long l_Messages = getNumberOfMessages();
+	p_Output << "THROUGHPUT," << l_Messages << "," << (p_WallClock > 0 ? l_Messages/p_WallClock : 0) << endl;
+}
+
+void Simulation::writeResults(ostream& p_Output)
+{
+	p_Output << m_CommandLog.str();
+
+	if(!m_Phases.empty())
+		closePhase();
+	for(unsigned k = 0; k < m_Phases.size(); k++)
+		p_Output << "CONVERGENCE," << m_Phases[k].start << "," << m_Phases[k].convergenceTime << "," << m_Phases[k].updates << "," << m_Phases[k].withdrawnRoutes << "," << m_Phases[k].command << endl;
+
+	for(int i = 0; i < m_SimuConfiguration->getNumberOfRouters(); i++)
+	{
+		if(m_Router[i] == NULL)
+			continue;
+		p_Output << "ROUTER," << i << "," << m_Router[i]->getRouteCacheStatistics() << endl;
+		for(int j = 0; j < m_SimuConfiguration->getRouterConfiguration(i).getNumberOfInterfaces(); j++)
+			p_Output << "INTERFACE," << i << "," << j << "," << m_Router[i]->getInterfaceStatistics(j) << endl;
+		p_Output << "TABLE," << i << "," << m_Router[i]->getRoutingTable() << endl;
+
+		const struct_MessageCounters& l_Counters = m_Router[i]->getMessageCounters();
+		p_Output << "MESSAGES," << i << "," << l_Counters.opens << "," << l_Counters.updates << "," << l_Counters.notifications << "," << l_Counters.keepalives << "," << l_Counters.withdrawnRoutes << endl;
+		p_Output << "RIB," << i << "," << m_Router[i]->getRIBStatistics() << endl;
+		p_Output << "FIB," << i << "," << m_Router[i]->getFIBStatistics() << endl;
+		p_Output << "POOL," << i << "," << m_Router[i]->getPacketPoolStatistics() << endl;
+		p_Output << "DUPLICATES," << i << "," << m_Router[i]->getDuplicateStatistics() << endl;
+	}
+
+	for(map<pair<int, int>, PartitionLink*>::iterator it = m_Link.begin(); it != m_Link.end(); ++it)
+		p_Output << "LINK," << it->first.first << "," << it->first.second << "," << it->second->getStatistics() << endl;
+}
+
 bool Simulation::sendRoutine(void)
 {
 
@@ -30,6 +30,11 @@
 #include "ServerSocket.h"
 #include "SocketException.h"
 #include "PacketProcessor.hpp"
+#include "ConfigurationParser.hpp"
+#include "PartitionLink.hpp"
+#include <map>
+#include <sstream>
+#include <vector>
 
 
 using namespace std;
@@ -37,13 +42,31 @@ using namespace sc_core;
 using namespace sc_dt;
 
 
+#ifndef _SIMULATION_H_
+#define _SIMULATION_H_
+
+/*!
+ * \brief A period of a batch run started by a command that changes
+ * the routing
+ */
+struct struct_ConvergencePhase
+{
+    double start;
+    string command;
+    unsigned long updates;          // UPDATEs sent during the phase
+    unsigned long withdrawnRoutes;  // prefixes withdrawn during the phase
+    double convergenceTime;         // from the start to the last UPDATE, -1 while the phase is open
+};
+
 
 class Simulation: public sc_module
 {
 
 public:
 
+#ifndef _EVENT_DRIVEN
     sc_in_clk port_Clk;
+#endif
 
     /*!
      * \brief Constructor
@@ -53,10 +76,132 @@ public:
      */
     Simulation(sc_module_name p_Name, ServerSocket& p_Socket, SimulationConfig * const p_SimuConfiguration);
 
+    /*!
+     * \brief Constructor
+     * \details Builds one partition of the simulation. Only the routers
+     * assigned to the partition and their hosts are built, with the
+     * same module names as in the single kernel run. A connection to a
+     * router of another partition is made through a PartitionLink.
+     * @param[in] p_Name The name of the module
+     * @param[in] const vector<int>& p_Assignment The partition of each
+     * router
+     * @param[in] int p_PartitionId The partition to be built
+     * @param[in] const PartitionChannelMap& p_Channels The channels
+     * between the partitions
+     * @param[in] const sc_time& p_Window The time window
+     * \public
+     */
+    Simulation(sc_module_name p_Name, ServerSocket& p_Socket, SimulationConfig * const p_SimuConfiguration, const vector<int>& p_Assignment, int p_PartitionId, const PartitionChannelMap& p_Channels, const sc_time& p_Window);
+
     ~Simulation();
 
     void simulationMain(void);
 
+    /*!
+     * \fn void scheduleCommand(const struct_ScheduledCommand& p_Command)
+     * \brief Schedules a simulation command of a batch run
+     * \details The command has the syntax of the GUI protocol without
+     * the command tags. It is executed on the first clock edge at or
+     * after its time. The commands shall be scheduled in the order of
+     * their times. In a partition the command of a router is executed
+     * only by the partition of the router, and a command without a
+     * router by all the partitions.
+     * \public
+     */
+    void scheduleCommand(const struct_ScheduledCommand& p_Command);
+
+    /*!
+     * \fn void writeResults(ostream& p_Output)
+     * \brief Writes the results of a batch run
+     * \details One line per record:
+     * \li COMMAND,[TIME],[COMMAND],[REPLY] for each executed command
+     * \li ROUTER,[ROUTER_ID],[ROUTE_CACHE_STATISTICS]
+     * \li INTERFACE,[ROUTER_ID],[IF_ID],[INTERFACE_STATISTICS]
+     * \li TABLE,[ROUTER_ID],[ROUTING_TABLE]
+     * \li MESSAGES,[ROUTER_ID],[OPEN],[UPDATE],[NOTIFICATION],[KEEPALIVE],[WITHDRAWN_ROUTES]
+     * for the messages sent by the router
+     * \li RIB,[ROUTER_ID],[RIB_STATISTICS]
+     * \li FIB,[ROUTER_ID],[FIB_STATISTICS]
+     * \li POOL,[ROUTER_ID],[PACKET_POOL_STATISTICS]
+     * \li DUPLICATES,[ROUTER_ID],[ACCEPTED],[DUPLICATES],[RESTARTS]
+     * for the messages received by the sessions of the router
+     * \li CONVERGENCE,[START],[CONVERGENCE_TIME],[UPDATES],[WITHDRAWN_ROUTES],[COMMAND]
+     * for the start of the run and for each command that changes the
+     * routing. The convergence time is measured from the command to
+     * the last UPDATE sent before the next such command, so the
+     * commands shall be far enough apart.
+     * \li LINK,[ROUTER_ID],[IF_ID],[PARTITION_LINK_STATISTICS] for each
+     * link to another partition
+     *
+     * A partition writes the records of its own routers only.
+     * \public
+     */
+    void writeResults(ostream& p_Output);
+
+    /*!
+     * \fn void writeUsage(ostream& p_Output, double p_WallClock, long p_BaselineKB)
+     * \brief Writes the resource usage of a batch run
+     * \details One line per record:
+     * \li WALL_CLOCK,[SECONDS]
+     * \li MEMORY,[SESSIONS],[PEAK_KB],[BASELINE_KB],[FIXED_KB],[BYTES_PER_SESSION]
+     * where the packet pools and the forwarding tables (FIXED_KB) and
+     * the resident size before the model was built (BASELINE_KB) are
+     * taken off the peak resident size before it is divided by the
+     * sessions
+     * \li THROUGHPUT,[MESSAGES],[MESSAGES_PER_SECOND] for the BGP
+     * messages sent through the control planes per wall clock second
+     * @param[in] double p_WallClock The wall clock time of the run in
+     * seconds
+     * @param[in] long p_BaselineKB The resident size before the model
+     * was built
+     * \public
+     */
+    void writeUsage(ostream& p_Output, double p_WallClock, long p_BaselineKB);
+
+    /*!
+     * \fn unsigned long getNumberOfMessages(void)
+     * \brief Returns the number of BGP messages sent by all the routers
+     * \details The OPEN, UPDATE, NOTIFICATION and KEEPALIVE messages
+     * written through the control planes
+     * \public
+     */
+    unsigned long getNumberOfMessages(void);
+
+    /*!
+     * \fn unsigned long getFixedMemory(void)
+     * \brief Returns the bytes that do not grow with the number of
+     * sessions
+     * \details The packet pools of the routers and the hosts and the
+     * forwarding tables of the routers
+     * \public
+     */
+    unsigned long getFixedMemory(void);
+
+    /*!
+     * \fn void receiveLinks(void)
+     * \brief Drains the inbound channels of the links to the other
+     * partitions
+     * \sa PartitionLink::receive
+     * \public
+     */
+    void receiveLinks(void);
+
+    /*!
+     * \fn unsigned long getLinkOverflows(void)
+     * \brief Returns the number of frames lost by the links to the
+     * other partitions
+     * \sa PartitionLink::getOverflows
+     * \public
+     */
+    unsigned long getLinkOverflows(void);
+
+    /*!
+     * \fn bool isStopped(void)
+     * \brief Tells whether a STOP command has stopped the simulation
+     * \public
+     */
+    bool isStopped(void);
+
     SC_HAS_PROCESS(Simulation);
 
 private:
@@ -135,6 +280,52 @@ private:
     int m_IntBuffer[3];
 
     Host **m_Host;
+
+    /*!
+     * \property  map<pair<int,int>, PartitionLink*> m_Link
+     * \brief The links to the other partitions by the router and the
+     * interface
+     * \private
+     */
+    map<pair<int, int>, PartitionLink*> m_Link;
+
+    /*!
+     * \property  int m_PartitionId
+     * \brief The partition that is built. 0 in the single kernel run.
+     * \private
+     */
+    int m_PartitionId;
+
+    bool m_Stopped;
+
+    /*!
+     * \property  vector<struct_ScheduledCommand> m_Script
+     * \brief The commands of a batch run
+     * \private
+     */
+    vector<struct_ScheduledCommand> m_Script;
+
+    /*!
+     * \property  unsigned m_NextCommand
+     * \brief The index of the next command to be executed
+     * \private
+     */
+    unsigned m_NextCommand;
+
+    /*!
+     * \property  ostringstream m_CommandLog
+     * \brief The executed commands and their replies
+     * \private
+     */
+    ostringstream m_CommandLog;
+
+    /*!
+     * \property  vector<struct_ConvergencePhase> m_Phases
+     * \brief The convergence phases of a batch run
+     * \private
+     */
+    vector<struct_ConvergencePhase> m_Phases;
+
     /*!
      * \property  enum ServerStates{RECEIVE, PROCESS, SEND, TERMINATE} enum_State
      * \brief Defines the socket server states
@@ -142,6 +333,15 @@ private:
      */
     enum ServerStates{ACTIVE, PROCESS, SEND, TERMINATE} enum_State, prev_State;
 
+    /*!
+     * \fn void buildNetwork(const vector<int>& p_Assignment, const PartitionChannelMap& p_Channels, const sc_time& p_Window)
+     * \brief Builds the routers and the hosts of the partition and
+     * connects them
+     * \details An empty assignment builds all the routers
+     * \private
+     */
+    void buildNetwork(const vector<int>& p_Assignment, const PartitionChannelMap& p_Channels, const sc_time& p_Window);
+
     /*!
      * \fn void socketRoutine(void) 
      * \brief Determines the type of the received command
@@ -149,6 +349,48 @@ private:
      */
     void socketRoutine(void);
 
+    /*!
+     * \fn bool waitForWork(void)
+     * \brief Waits for the next clock edge
+     * \details In the event-driven batch run the thread sleeps until
+     * the edge of the next scheduled command
+     * \return bool: false if no command is left to wait for
+     * \private
+     */
+    bool waitForWork(void);
+
+    /*!
+     * \fn void runScript(void)
+     * \brief Executes the scheduled commands whose time has come
+     * \private
+     */
+    void runScript(void);
+
+    /*!
+     * \fn void beginPhase(const string& p_Command)
+     * \brief Closes the current convergence phase and starts a new
+     * one
+     * \private
+     */
+    void beginPhase(const string& p_Command);
+
+    /*!
+     * \fn void closePhase(void)
+     * \brief Stores the message counts and the convergence time of the
+     * current phase
+     * \private
+     */
+    void closePhase(void);
+
+    /*!
+     * \fn struct_MessageCounters sumMessageCounters(void)
+     * \brief Sums the message counters of all the routers
+     * \details The time of the last UPDATE is the latest one of all
+     * the routers.
+     * \private
+     */
+    struct_MessageCounters sumMessageCounters(void);
+
     /*!
      * \fn bool sendRoutine(void)
      * \brief Writes the content of m_Word to the socket
@@ -185,3 +427,5 @@ private:
 
 };
 
+
+#endif /* _SIMULATION_H_ */
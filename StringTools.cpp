@@ -319,7 +319,7 @@ bool StringTools::ipToUChar(string p_IPAddress, unsigned char *p_IPBinAddress)
 
 /*! \sa StringTools
  */
-string StringTools::ipToString(unsigned char *p_IPBinAddress)
+string StringTools::ipToString(const unsigned char *p_IPBinAddress)
 {
 	string l_IP = "";
     //Loop through all the octets
@@ -333,3 +333,45 @@ string StringTools::ipToString(unsigned char *p_IPBinAddress)
     return l_IP;
 }
 
+
+/*! \sa StringTools
+ */
+unsigned StringTools::ipToUInt(const string& p_IPAddress)
+{
+    unsigned l_IP = 0, l_Octet = 0;
+    int l_Count = 0;
+
+    //Loop through the characters until all the octets are read
+    for (unsigned i = 0; i < p_IPAddress.size() && l_Count < 4; i++)
+    {
+        char l_Char = p_IPAddress[i];
+        if(l_Char >= '0' && l_Char <= '9')
+            l_Octet = l_Octet*10 + (l_Char - '0');
+        else
+        {
+            l_IP = (l_IP << 8) | (l_Octet & 0xFF);
+            l_Octet = 0;
+            l_Count++;
+        }
+    }
+
+    //the last octet is terminated by the end of the string
+    if(l_Count < 4)
+    {
+        l_IP = (l_IP << 8) | (l_Octet & 0xFF);
+        l_Count++;
+    }
+
+    //return
+    return l_IP << (8*(4-l_Count));
+}
+
+string StringTools::uIntToIp(unsigned p_IPAddress)
+{
+    unsigned char l_IPBinAddress[4];
+    //high order octet first
+    for(int i = 0; i < 4; i++)
+        l_IPBinAddress[i] = (p_IPAddress >> (24 - 8*i)) & 0xFF;
+
+    return ipToString(l_IPBinAddress);
+}
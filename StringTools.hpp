@@ -103,14 +103,33 @@ public:
      */
     bool ipToUChar(string p_IPAddress, unsigned char *p_IPBinAddress);
 
-    /*! \fn string ipToString(unsigned char *ptr_IPBinAddress); 
+    /*! \fn string ipToString(const unsigned char *ptr_IPBinAddress); 
      * \brief Converts IP address from four byte binary form to string form
      * \details 
      * @param [in] unsigned p_IPBinAddress The ip address in binary form
      * \return string: The IP address in string 
      * \public
      */
-    string ipToString(unsigned char *ptr_IPBinAddress);
+    string ipToString(const unsigned char *ptr_IPBinAddress);
+
+    /*! \fn unsigned ipToUInt(string p_IPAddress);
+     * \brief Converts string type IP address to a 32-bit integer
+     * \details Parses the dotted decimal notation without any
+     * temporary objects. Anything after the fourth octet, e.g. the
+     * /-notation of a prefix, is ignored.
+     * @param [in] string p_IPAddress
+     * \return unsigned: The IP address in host byte order
+     * \public
+     */
+    unsigned ipToUInt(const string& p_IPAddress);
+
+    /*! \fn string uIntToIp(unsigned p_IPAddress);
+     * \brief Converts a 32-bit integer IP address to string form
+     * @param [in] unsigned p_IPAddress The IP address in host byte order
+     * \return string: The IP address in dotted decimal notation
+     * \public
+     */
+    string uIntToIp(unsigned p_IPAddress);
     
     
 
@@ -0,0 +1,228 @@
+/*! \file TimerService.cpp
+ *  \brief     Implementation of TimerService.
+ *  \details
+ */
+
+
+#include "TimerService.hpp"
+#include <cmath>
+#include <cstring>
+
+/*!
+ * Marks that m_Wakeup is not notified
+ */
+#define TIMER_NEVER (~(uint64_t)0)
+
+/*!
+ * \brief Returns the index of the lowest set bit of a non-zero bitmap
+ */
+static inline int lowestBit(uint64_t p_Bitmap)
+{
+    return __builtin_ctzll(p_Bitmap);
+}
+
+
+TimerService::TimerService(sc_module_name p_ModuleName):sc_module(p_ModuleName), m_Now(0), m_Scheduled(TIMER_NEVER), m_Count(0), m_Resolution(TIMER_RESOLUTION, SC_SEC)
+{
+    memset(m_Slots, 0, sizeof(m_Slots));
+    memset(m_Occupied, 0, sizeof(m_Occupied));
+
+    SC_METHOD(expireTimers);
+    sensitive << m_Wakeup;
+    dont_initialize();
+}
+
+/*! \sa TimerService
+ */
+void TimerService::startTimer(struct_Timer& p_Timer, double p_Delay)
+{
+    //move the wheel to the current time, so that the levels are
+    //chosen relative to it. The timers due now are left to
+    //expireTimers.
+    uint64_t l_Tick = currentTick();
+    if(l_Tick > m_Now + 1)
+        advance(l_Tick - 1, false);
+
+    if(p_Timer.running)
+        unlink(p_Timer);
+    else
+        m_Count++;
+
+    uint64_t l_Expiry = (uint64_t)ceil((sc_time_stamp() + sc_time(p_Delay, SC_SEC)) / m_Resolution);
+    p_Timer.expiry = l_Expiry > m_Now ? l_Expiry : m_Now + 1;
+    p_Timer.running = true;
+    link(p_Timer);
+    schedule();
+}
+
+/*! \sa TimerService
+ */
+void TimerService::stopTimer(struct_Timer& p_Timer)
+{
+    //the wakeup is left as it is, an early one just finds nothing
+    if(!p_Timer.running)
+        return;
+    unlink(p_Timer);
+    p_Timer.running = false;
+    m_Count--;
+}
+
+/*! \sa TimerService
+ */
+int TimerService::getNumberOfTimers(void)
+{
+    return m_Count;
+}
+
+/*! \sa TimerService
+ */
+void TimerService::expireTimers(void)
+{
+    m_Scheduled = TIMER_NEVER;
+    advance(currentTick(), true);
+    schedule();
+}
+
+/*! \sa TimerService
+ */
+uint64_t TimerService::currentTick(void)
+{
+    return (uint64_t)floor(sc_time_stamp() / m_Resolution);
+}
+
+/*! \sa TimerService
+ */
+void TimerService::link(struct_Timer& p_Timer)
+{
+    ///find the lowest level at which the expiration shares the block
+    ///of the next level with the current tick
+    uint64_t l_Difference = p_Timer.expiry ^ m_Now;
+    int l_Level = 0;
+    while(l_Level < TIMER_LEVELS && (l_Difference >> (TIMER_SLOT_BITS*(l_Level + 1))) != 0)
+        l_Level++;
+
+    p_Timer.level = l_Level;
+    p_Timer.slot = l_Level < TIMER_LEVELS ? (int)((p_Timer.expiry >> (TIMER_SLOT_BITS*l_Level)) & (TIMER_SLOTS - 1)) : 0;
+
+    struct_Timer *&l_Head = m_Slots[l_Level][p_Timer.slot];
+    p_Timer.prev = 0;
+    p_Timer.next = l_Head;
+    if(l_Head)
+        l_Head->prev = &p_Timer;
+    l_Head = &p_Timer;
+
+    if(l_Level < TIMER_LEVELS)
+        m_Occupied[l_Level] |= (uint64_t)1 << p_Timer.slot;
+}
+
+/*! \sa TimerService
+ */
+void TimerService::unlink(struct_Timer& p_Timer)
+{
+    struct_Timer *&l_Head = m_Slots[p_Timer.level][p_Timer.slot];
+    if(p_Timer.prev)
+        p_Timer.prev->next = p_Timer.next;
+    else
+        l_Head = p_Timer.next;
+    if(p_Timer.next)
+        p_Timer.next->prev = p_Timer.prev;
+    p_Timer.prev = p_Timer.next = 0;
+
+    if(!l_Head && p_Timer.level < TIMER_LEVELS)
+        m_Occupied[p_Timer.level] &= ~((uint64_t)1 << p_Timer.slot);
+}
+
+/*! \sa TimerService
+ */
+void TimerService::cascade(int p_Level, int p_Slot)
+{
+    struct_Timer *l_Timer = m_Slots[p_Level][p_Slot];
+    m_Slots[p_Level][p_Slot] = 0;
+    if(p_Level < TIMER_LEVELS)
+        m_Occupied[p_Level] &= ~((uint64_t)1 << p_Slot);
+
+    while(l_Timer)
+        {
+            struct_Timer *l_Next = l_Timer->next;
+            link(*l_Timer);
+            l_Timer = l_Next;
+        }
+}
+
+/*! \sa TimerService
+ */
+bool TimerService::nextTick(uint64_t& p_Tick)
+{
+    ///the occupied slots of a level are after the current tick, so the
+    ///first slot of the lowest non-empty level comes first
+    for(int l_Level = 0; l_Level < TIMER_LEVELS; l_Level++)
+        if(m_Occupied[l_Level])
+            {
+                int l_Block = TIMER_SLOT_BITS*(l_Level + 1);
+                p_Tick = (m_Now >> l_Block << l_Block) | ((uint64_t)lowestBit(m_Occupied[l_Level]) << (TIMER_SLOT_BITS*l_Level));
+                return true;
+            }
+
+    ///the overflow list is linked again at the start of the next block
+    ///of the highest level
+    if(m_Slots[TIMER_LEVELS][0])
+        {
+            int l_Block = TIMER_SLOT_BITS*TIMER_LEVELS;
+            p_Tick = ((m_Now >> l_Block) + 1) << l_Block;
+            return true;
+        }
+    return false;
+}
+
+/*! \sa TimerService
+ */
+void TimerService::advance(uint64_t p_Tick, bool p_Expire)
+{
+    uint64_t l_Next;
+    while(nextTick(l_Next) && l_Next <= p_Tick)
+        {
+            m_Now = l_Next;
+
+            ///move down the timers of the blocks that start now, from
+            ///the highest level to the lowest
+            if((m_Now & (((uint64_t)1 << (TIMER_SLOT_BITS*TIMER_LEVELS)) - 1)) == 0)
+                cascade(TIMER_LEVELS, 0);
+            for(int l_Level = TIMER_LEVELS - 1; l_Level > 0; l_Level--)
+                if((m_Now & (((uint64_t)1 << (TIMER_SLOT_BITS*l_Level)) - 1)) == 0)
+                    cascade(l_Level, (int)((m_Now >> (TIMER_SLOT_BITS*l_Level)) & (TIMER_SLOTS - 1)));
+
+            if(!p_Expire)
+                continue;
+
+            ///expire the timers of the tick. A client may restart its
+            ///timers, which are linked after the current tick.
+            struct_Timer *&l_Head = m_Slots[0][m_Now & (TIMER_SLOTS - 1)];
+            while(l_Head)
+                {
+                    struct_Timer *l_Timer = l_Head;
+                    unlink(*l_Timer);
+                    l_Timer->running = false;
+                    m_Count--;
+                    l_Timer->client->timerExpired(l_Timer->id);
+                }
+        }
+
+    if(p_Tick > m_Now)
+        m_Now = p_Tick;
+}
+
+/*! \sa TimerService
+ */
+void TimerService::schedule(void)
+{
+    uint64_t l_Tick;
+    if(!nextTick(l_Tick) || l_Tick >= m_Scheduled)
+        return;
+
+    m_Scheduled = l_Tick;
+    sc_time l_Time = m_Resolution * (double)l_Tick;
+    if(l_Time > sc_time_stamp())
+        m_Wakeup.notify(l_Time - sc_time_stamp());
+    else
+        m_Wakeup.notify(SC_ZERO_TIME);
+}
@@ -0,0 +1,176 @@
+/*! \file  TimerService.hpp
+ *  \brief     Header file of TimerService module
+ *  \details   Runs the timers of the BGP sessions of a router
+ */
+
+/*!
+ * \class TimerService
+ * \brief Hierarchical timing wheel shared by the sessions of a router
+ *  \details Time is counted in ticks of half a clock period, the
+ *  resolution at which the session FSMs run. The wheel has
+ *  TIMER_LEVELS levels of TIMER_SLOTS slots. A timer is linked to the
+ *  lowest level at which its expiration tick and the current tick
+ *  fall into the same block of the next level, so level 0 holds the
+ *  timers of the next 64 ticks, level 1 those of the next 4096 ticks
+ *  and so on. Longer timers wait in an overflow list. When the current
+ *  tick enters a block, the timers of its slot are moved down to the
+ *  lower levels.
+ *
+ *  The slots are doubly linked lists and a bitmap per level tells
+ *  which of them are occupied, so starting, restarting and stopping a
+ *  timer take constant time. A single SystemC method wakes up at the
+ *  next occupied tick, expires the timers of the tick and schedules
+ *  its next wakeup. It replaces the three timer threads each session
+ *  had before.
+ */
+
+
+#include "systemc"
+#include "TimerService_If.hpp"
+#include "ClockTick.hpp"
+#include <stdint.h>
+
+using namespace std;
+using namespace sc_core;
+
+
+#ifndef _TIMERSERVICE_H_
+#define _TIMERSERVICE_H_
+
+/*!
+ * The length of a tick in seconds
+ */
+#define TIMER_RESOLUTION (CLOCK_PERIOD/2.0)
+
+/*!
+ * The number of bits of the slot index
+ */
+#define TIMER_SLOT_BITS 6
+
+/*!
+ * The number of slots on each level
+ */
+#define TIMER_SLOTS (1 << TIMER_SLOT_BITS)
+
+/*!
+ * The number of levels. Four levels cover 2^24 ticks, about 97 days
+ * of simulation time.
+ */
+#define TIMER_LEVELS 4
+
+
+class TimerService: public sc_module, public TimerService_If
+{
+
+public:
+
+    /*! \brief Elaborates the TimerService module
+     * \public
+     */
+    TimerService(sc_module_name p_ModuleName);
+
+    /*! \sa TimerService_If
+     */
+    virtual void startTimer(struct_Timer& p_Timer, double p_Delay);
+
+    /*! \sa TimerService_If
+     */
+    virtual void stopTimer(struct_Timer& p_Timer);
+
+    /*! \fn int getNumberOfTimers(void)
+     *  \brief Returns the number of running timers
+     * \public
+     */
+    int getNumberOfTimers(void);
+
+    /*! \fn void expireTimers(void)
+     *  \brief Expires the timers that are due
+     * \details A SystemC method, which is sensitive to m_Wakeup
+     * \public
+     */
+    void expireTimers(void);
+
+    /*! \brief Indicate the systemC producer that this module has a process.
+     * \sa http://www.iro.umontreal.ca/~lablasso/docs/SystemC2.0.1/html/classproducer.html
+     * \public
+     */
+    SC_HAS_PROCESS(TimerService);
+
+private:
+
+    /*! \property struct_Timer *m_Slots[TIMER_LEVELS+1][TIMER_SLOTS]
+     *  \brief The heads of the slot lists
+     * \details The extra level holds the overflow list in its first slot
+     * \private
+     */
+    struct_Timer *m_Slots[TIMER_LEVELS+1][TIMER_SLOTS];
+
+    /*! \property uint64_t m_Occupied[TIMER_LEVELS]
+     *  \brief The bitmaps of the non-empty slots of each level
+     * \private
+     */
+    uint64_t m_Occupied[TIMER_LEVELS];
+
+    /*! \property uint64_t m_Now
+     *  \brief The tick up to which the wheel has been processed
+     * \private
+     */
+    uint64_t m_Now;
+
+    /*! \property uint64_t m_Scheduled
+     *  \brief The tick at which m_Wakeup is notified
+     * \private
+     */
+    uint64_t m_Scheduled;
+
+    int m_Count;
+
+    const sc_time m_Resolution;
+
+    /*! \property sc_event m_Wakeup
+     *  \brief Wakes up expireTimers at the next occupied tick
+     * \private
+     */
+    sc_event m_Wakeup;
+
+    /*! \fn uint64_t currentTick(void)
+     *  \brief Returns the tick of the current simulation time
+     * \private
+     */
+    uint64_t currentTick(void);
+
+    void link(struct_Timer& p_Timer);
+
+    void unlink(struct_Timer& p_Timer);
+
+    /*! \fn void cascade(int p_Level, int p_Slot)
+     *  \brief Links the timers of the slot again relative to m_Now
+     * \private
+     */
+    void cascade(int p_Level, int p_Slot);
+
+    /*! \fn bool nextTick(uint64_t& p_Tick)
+     *  \brief Finds the next tick at which a slot has to be processed
+     * \return bool: false if no timer is running
+     * \private
+     */
+    bool nextTick(uint64_t& p_Tick);
+
+    /*! \fn void advance(uint64_t p_Tick, bool p_Expire)
+     *  \brief Processes the wheel up to p_Tick
+     * \details Without p_Expire the timers are only moved down and
+     * p_Tick must be before the expiration of any of them
+     * \private
+     */
+    void advance(uint64_t p_Tick, bool p_Expire);
+
+    /*! \fn void schedule(void)
+     *  \brief Notifies m_Wakeup if the next tick is earlier than the
+     *  scheduled one
+     * \private
+     */
+    void schedule(void);
+};
+
+
+#endif /* _TIMERSERVICE_H_ */
@@ -0,0 +1,87 @@
+/*! \file  TimerService_If.hpp
+ *  \brief     Interface of the timer service
+ *  \details   Defines the timers and the interfaces between the timer
+ *  service and its clients
+ */
+
+/*!
+ * \class TimerService_If
+ * \brief Starts and stops the timers of a router
+ *  \details A client owns its struct_Timer objects and the service
+ *  links them into its timing wheel while they run. When a timer
+ *  expires the service calls timerExpired of its client with the id
+ *  of the timer. The call is made from a SystemC method, so the
+ *  client must not wait in it.
+ */
+
+
+#include "systemc"
+#include <stdint.h>
+
+using namespace std;
+using namespace sc_core;
+
+
+#ifndef TIMERSERVICE_IF_H
+#define TIMERSERVICE_IF_H
+
+
+class TimerClient_If
+{
+
+public:
+
+    virtual ~TimerClient_If(void){}
+
+    /*! \fn virtual void timerExpired(int p_Timer) = 0
+     *  \brief Called when a timer of the client expires
+     *  @param[in] int p_Timer The id of the timer
+     * \public
+     */
+    virtual void timerExpired(int p_Timer) = 0;
+};
+
+
+/*!
+ * \brief A timer of a client
+ * \details The links and the position in the wheel are maintained by
+ * the timer service
+ */
+struct struct_Timer
+{
+    struct_Timer(void):client(0), id(0), expiry(0), level(0), slot(0), running(false), prev(0), next(0){}
+
+    TimerClient_If *client;
+    int id;
+    uint64_t expiry;    // expiration tick
+    int level;
+    int slot;
+    bool running;
+    struct_Timer *prev;
+    struct_Timer *next;
+};
+
+
+class TimerService_If: virtual public sc_interface
+{
+
+public:
+
+    /*! \fn virtual void startTimer(struct_Timer& p_Timer, double p_Delay) = 0
+     *  \brief Starts the timer or restarts it if it is running
+     *  @param[in] struct_Timer& p_Timer The timer, whose client and id
+     *  are set
+     *  @param[in] double p_Delay The time to the expiration in seconds
+     * \public
+     */
+    virtual void startTimer(struct_Timer& p_Timer, double p_Delay) = 0;
+
+    /*! \fn virtual void stopTimer(struct_Timer& p_Timer) = 0
+     *  \brief Stops the timer if it is running
+     * \public
+     */
+    virtual void stopTimer(struct_Timer& p_Timer) = 0;
+};
+
+
+#endif
@@ -0,0 +1,267 @@
+/*! \file TopologyGenerator.cpp
+ *  \brief     Implementation of TopologyGenerator class.
+ *  \details
+ */
+
+
+#include "TopologyGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+/*!
+ * The first address of the synthetic prefixes, 64.0.0.0
+ */
+#define SYNTHETIC_PREFIX_START 0x40000000u
+
+/*!
+ * The end of the unicast address space, 224.0.0.0
+ */
+#define SYNTHETIC_PREFIX_END 0xE0000000u
+
+/*!
+ * \brief The share of each prefix length in the global routing table
+ * in per mille
+ */
+static const struct
+{
+    int length;
+    int share;
+} s_PrefixLengths[] = {
+    {16, 25}, {17, 13}, {18, 22}, {19, 34}, {20, 55},
+    {21, 58}, {22, 105}, {23, 100}, {24, 588}
+};
+
+
+TopologyGenerator::TopologyGenerator(unsigned long p_Seed):m_Random(p_Seed), m_PrefixesPerAS(0), m_KeepaliveTime(60), m_HoldDownTimeFactor(3), m_NextPrefix(SYNTHETIC_PREFIX_START)
+{
+}
+
+/*! \sa TopologyGenerator
+ */
+bool TopologyGenerator::generate(SimulationConfig& p_Config, Topology p_Topology, int p_NumberOfRouters, int p_Parameter)
+{
+    if(p_NumberOfRouters < 2 || p_NumberOfRouters > TOPOLOGY_MAX_ROUTERS || p_Parameter < 0)
+        return false;
+
+    m_Links.clear();
+    m_NextPrefix = SYNTHETIC_PREFIX_START;
+
+    switch(p_Topology)
+        {
+        case LINE:
+            linkLine(p_NumberOfRouters);
+            break;
+        case RING:
+            linkLine(p_NumberOfRouters);
+            //two routers are linked only once
+            if(p_NumberOfRouters > 2)
+                m_Links.push_back(make_pair(p_NumberOfRouters - 1, 0));
+            break;
+        case GRID:
+            if(p_Parameter == 0)
+                p_Parameter = (int)ceil(sqrt((double)p_NumberOfRouters));
+            linkGrid(p_NumberOfRouters, p_Parameter);
+            break;
+        case FULL_MESH:
+            linkFullMesh(p_NumberOfRouters);
+            break;
+        case BARABASI_ALBERT:
+            linkBarabasiAlbert(p_NumberOfRouters, p_Parameter == 0 ? 2 : p_Parameter);
+            break;
+        default:
+            return false;
+        }
+
+    ///the last interface of each router connects the host
+    vector<int> l_Degree(p_NumberOfRouters, 0);
+    for(unsigned k = 0; k < m_Links.size(); k++)
+        {
+            l_Degree[m_Links[k].first]++;
+            l_Degree[m_Links[k].second]++;
+        }
+
+    p_Config.init(p_NumberOfRouters);
+
+    for(int i = 0; i < p_NumberOfRouters; i++)
+        {
+            p_Config.addRouterConfig(i, l_Degree[i] + 1);
+            p_Config.addBGPSessionParameters(i, m_KeepaliveTime, m_HoldDownTimeFactor);
+
+            ostringstream l_Prefix;
+            l_Prefix << 1 + i/256 << "." << i%256 << ".0.0/16";
+
+            RouterConfig& l_Router = p_Config.getRouterConfiguration(i);
+            l_Router.setASNumber(i + 1);
+            l_Router.setPrefix(l_Prefix.str());
+            l_Router.setMED(0);
+            l_Router.setLocalPref(100);
+        }
+
+    ///number the links to the interfaces in their order
+    vector<int> l_NextInterface(p_NumberOfRouters, 0);
+    for(unsigned k = 0; k < m_Links.size(); k++)
+        {
+            int l_First = m_Links[k].first, l_Second = m_Links[k].second;
+            int l_FirstInterface = l_NextInterface[l_First]++;
+            int l_SecondInterface = l_NextInterface[l_Second]++;
+
+            p_Config.addConnectionConfig(l_First, l_FirstInterface, l_SecondInterface, l_Second);
+            p_Config.addConnectionConfig(l_Second, l_SecondInterface, l_FirstInterface, l_First);
+        }
+
+    ///originate the synthetic prefixes
+    for(int i = 0; i < p_NumberOfRouters; i++)
+        for(int k = 0; k < m_PrefixesPerAS; k++)
+            {
+                int l_Length = randomPrefixLength();
+                unsigned l_Prefix;
+                if(!allocatePrefix(l_Length, l_Prefix))
+                    return false;
+                p_Config.getRouterConfiguration(i).addOriginatedPrefix(l_Prefix, l_Length);
+            }
+
+    return true;
+}
+
+/*! \sa TopologyGenerator
+ */
+void TopologyGenerator::setPrefixesPerAS(int p_Count)
+{
+    m_PrefixesPerAS = p_Count > 0 ? p_Count : 0;
+}
+
+/*! \sa TopologyGenerator
+ */
+void TopologyGenerator::setSessionParameters(int p_KeepaliveTime, int p_HoldDownTimeFactor)
+{
+    m_KeepaliveTime = p_KeepaliveTime;
+    m_HoldDownTimeFactor = p_HoldDownTimeFactor;
+}
+
+/*! \sa TopologyGenerator
+ */
+int TopologyGenerator::getNumberOfLinks(void)
+{
+    return m_Links.size();
+}
+
+/*! \sa TopologyGenerator
+ */
+bool TopologyGenerator::parseTopology(const string& p_Name, Topology& p_Topology)
+{
+    if(p_Name.compare("line") == 0)
+        p_Topology = LINE;
+    else if(p_Name.compare("ring") == 0)
+        p_Topology = RING;
+    else if(p_Name.compare("grid") == 0)
+        p_Topology = GRID;
+    else if(p_Name.compare("mesh") == 0)
+        p_Topology = FULL_MESH;
+    else if(p_Name.compare("ba") == 0)
+        p_Topology = BARABASI_ALBERT;
+    else
+        return false;
+    return true;
+}
+
+/*! \sa TopologyGenerator
+ */
+void TopologyGenerator::linkLine(int p_NumberOfRouters)
+{
+    for(int i = 0; i + 1 < p_NumberOfRouters; i++)
+        m_Links.push_back(make_pair(i, i + 1));
+}
+
+/*! \sa TopologyGenerator
+ */
+void TopologyGenerator::linkGrid(int p_NumberOfRouters, int p_Width)
+{
+    for(int i = 0; i < p_NumberOfRouters; i++)
+        {
+            //the right and the lower neighbour
+            if((i + 1) % p_Width != 0 && i + 1 < p_NumberOfRouters)
+                m_Links.push_back(make_pair(i, i + 1));
+            if(i + p_Width < p_NumberOfRouters)
+                m_Links.push_back(make_pair(i, i + p_Width));
+        }
+}
+
+/*! \sa TopologyGenerator
+ */
+void TopologyGenerator::linkFullMesh(int p_NumberOfRouters)
+{
+    for(int i = 0; i < p_NumberOfRouters; i++)
+        for(int j = i + 1; j < p_NumberOfRouters; j++)
+            m_Links.push_back(make_pair(i, j));
+}
+
+/*! \sa TopologyGenerator
+ */
+void TopologyGenerator::linkBarabasiAlbert(int p_NumberOfRouters, int p_Links)
+{
+    int l_Seed = min(p_Links + 1, p_NumberOfRouters);
+    linkFullMesh(l_Seed);
+
+    //each router appears once per link, so a uniform pick from the
+    //list is proportional to the degree
+    vector<int> l_Ends;
+    for(unsigned k = 0; k < m_Links.size(); k++)
+        {
+            l_Ends.push_back(m_Links[k].first);
+            l_Ends.push_back(m_Links[k].second);
+        }
+
+    vector<int> l_Targets;
+    for(int i = l_Seed; i < p_NumberOfRouters; i++)
+        {
+            l_Targets.clear();
+            while((int)l_Targets.size() < p_Links)
+                {
+                    //the output of mt19937 is specified by the standard
+                    //unlike the distributions
+                    int l_Target = l_Ends[m_Random() % l_Ends.size()];
+                    if(find(l_Targets.begin(), l_Targets.end(), l_Target) == l_Targets.end())
+                        l_Targets.push_back(l_Target);
+                }
+
+            for(unsigned k = 0; k < l_Targets.size(); k++)
+                {
+                    m_Links.push_back(make_pair(l_Targets[k], i));
+                    l_Ends.push_back(l_Targets[k]);
+                    l_Ends.push_back(i);
+                }
+        }
+}
+
+/*! \sa TopologyGenerator
+ */
+int TopologyGenerator::randomPrefixLength(void)
+{
+    int l_Draw = m_Random() % 1000;
+    int l_Count = sizeof(s_PrefixLengths)/sizeof(s_PrefixLengths[0]);
+
+    for(int i = 0; i < l_Count; i++)
+        {
+            if(l_Draw < s_PrefixLengths[i].share)
+                return s_PrefixLengths[i].length;
+            l_Draw -= s_PrefixLengths[i].share;
+        }
+    return 24;
+}
+
+/*! \sa TopologyGenerator
+ */
+bool TopologyGenerator::allocatePrefix(int p_Length, unsigned& p_Prefix)
+{
+    unsigned l_Size = 1u << (32 - p_Length);
+
+    //a prefix is aligned to its size
+    unsigned l_Start = (m_NextPrefix + l_Size - 1) & ~(l_Size - 1);
+    if(l_Start < m_NextPrefix || l_Start >= SYNTHETIC_PREFIX_END || SYNTHETIC_PREFIX_END - l_Start < l_Size)
+        return false;
+
+    p_Prefix = l_Start;
+    m_NextPrefix = l_Start + l_Size;
+    return true;
+}
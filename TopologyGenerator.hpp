@@ -0,0 +1,166 @@
+/*! \file  TopologyGenerator.hpp
+ *  \brief     Header file of TopologyGenerator class
+ *  \details   Builds simulation configurations of synthetic topologies
+ */
+
+/*!
+ * \class TopologyGenerator
+ * \brief Builds a SimulationConfig for a parametric topology
+ *  \details Each router is an AS of its own. Router i gets the AS
+ *  number i+1 and the prefix 1.0.0.0/16 + i. The links are numbered
+ *  to the interfaces of a router in the order they are generated and
+ *  the last interface connects the host. The supported topologies are
+ *  \li LINE, RING and FULL_MESH
+ *  \li GRID of the given width, by default the square root of the
+ *  number of routers
+ *  \li BARABASI_ALBERT: preferential attachment where each new router
+ *  links to the given number of existing routers, by default two,
+ *  with a probability proportional to their degrees. The degrees
+ *  follow a power law like the AS graph of the Internet.
+ *
+ *  In addition, each AS may originate a set of synthetic prefixes.
+ *  Their lengths follow the distribution of the prefix lengths in the
+ *  global routing table, where more than half of the prefixes are /24.
+ *  The synthetic prefixes are allocated from 64.0.0.0 upwards, so they
+ *  do not overlap each other or the prefixes of the routers.
+ *
+ *  The random numbers are drawn from a Mersenne Twister whose output
+ *  is fully specified by its seed, so the same seed gives the same
+ *  configuration on every platform.
+ */
+
+
+#include "Configuration.hpp"
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+
+#ifndef _TOPOLOGYGENERATOR_H_
+#define _TOPOLOGYGENERATOR_H_
+
+/*!
+ * The maximum number of routers. The prefixes of the routers are the
+ * /16 blocks below the synthetic prefixes.
+ */
+#define TOPOLOGY_MAX_ROUTERS (63*256)
+
+
+class TopologyGenerator
+{
+
+public:
+
+    /*!
+     * \brief The supported topologies
+     */
+    enum Topology{LINE, RING, GRID, FULL_MESH, BARABASI_ALBERT};
+
+    /*! \fn TopologyGenerator(unsigned long p_Seed)
+     * \brief Constructor
+     * @param [in] unsigned long p_Seed The seed of the random numbers
+     * \public
+     */
+    TopologyGenerator(unsigned long p_Seed);
+
+    /*! \fn bool generate(SimulationConfig& p_Config, Topology p_Topology, int p_NumberOfRouters, int p_Parameter)
+     * \brief Builds the configuration of the topology
+     * @param [out] SimulationConfig& p_Config The configuration
+     * @param [in] Topology p_Topology The topology
+     * @param [in] int p_NumberOfRouters The number of routers, at least
+     * two
+     * @param [in] int p_Parameter The width of a GRID or the number of
+     * links of a new router in BARABASI_ALBERT. Zero selects the
+     * default.
+     * \return bool: false if the parameters are out of range
+     * \public
+     */
+    bool generate(SimulationConfig& p_Config, Topology p_Topology, int p_NumberOfRouters, int p_Parameter);
+
+    /*! \fn void setPrefixesPerAS(int p_Count)
+     * \brief Sets the number of synthetic prefixes originated by each
+     * AS. The default is zero.
+     * \public
+     */
+    void setPrefixesPerAS(int p_Count);
+
+    /*! \fn void setSessionParameters(int p_KeepaliveTime, int p_HoldDownTimeFactor)
+     * \brief Sets the BGP timers of all the routers. The default is 60
+     * seconds and 3.
+     * \public
+     */
+    void setSessionParameters(int p_KeepaliveTime, int p_HoldDownTimeFactor);
+
+    /*! \fn int getNumberOfLinks(void)
+     * \brief Returns the number of links of the last topology
+     * \public
+     */
+    int getNumberOfLinks(void);
+
+    /*! \fn static bool parseTopology(const string& p_Name, Topology& p_Topology)
+     * \brief Converts a name such as "ring" or "ba" into a topology
+     * \return bool: false if the name is unknown
+     * \public
+     */
+    static bool parseTopology(const string& p_Name, Topology& p_Topology);
+
+private:
+
+    /*! \property mt19937 m_Random
+     * \brief The random number generator
+     * \private
+     */
+    mt19937 m_Random;
+
+    int m_PrefixesPerAS;
+
+    int m_KeepaliveTime;
+
+    int m_HoldDownTimeFactor;
+
+    /*! \property vector<pair<int, int> > m_Links
+     * \brief The links between the routers
+     * \private
+     */
+    vector<pair<int, int> > m_Links;
+
+    /*! \property unsigned m_NextPrefix
+     * \brief The first unallocated address of the synthetic prefixes
+     * \private
+     */
+    unsigned m_NextPrefix;
+
+    void linkLine(int p_NumberOfRouters);
+
+    void linkGrid(int p_NumberOfRouters, int p_Width);
+
+    void linkFullMesh(int p_NumberOfRouters);
+
+    /*! \fn void linkBarabasiAlbert(int p_NumberOfRouters, int p_Links)
+     * \brief Links the routers by preferential attachment
+     * \details The routers are started from a full mesh of p_Links+1
+     * routers
+     * \private
+     */
+    void linkBarabasiAlbert(int p_NumberOfRouters, int p_Links);
+
+    /*! \fn int randomPrefixLength(void)
+     * \brief Draws a prefix length from the distribution of the
+     * global routing table
+     * \private
+     */
+    int randomPrefixLength(void);
+
+    /*! \fn bool allocatePrefix(int p_Length, unsigned& p_Prefix)
+     * \brief Allocates the next free prefix of the given length
+     * \return bool: false if the address space is exhausted
+     * \private
+     */
+    bool allocatePrefix(int p_Length, unsigned& p_Prefix);
+};
+
+
+#endif /* _TOPOLOGYGENERATOR_H_ */
@@ -0,0 +1,83 @@
+/*! \file  BenchTools.hpp
+ *  \brief     Header file of the micro benchmark helpers
+ *  \details   Defines the timer and the result line shared by the
+ *  programs in bench/
+ */
+
+/*!
+ * \class BenchTimer
+ * \brief Wall clock stopwatch of a micro benchmark
+ *  \details The programs in bench/ time one code path of the model
+ *  each and print one line per measurement:
+ *  BENCH,[NAME],[OPERATIONS],[NS_PER_OPERATION]
+ */
+
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdint.h>
+
+using namespace std;
+
+
+#ifndef _BENCHTOOLS_H_
+#define _BENCHTOOLS_H_
+
+
+class BenchTimer
+{
+
+public:
+
+    /*! \brief Starts the stopwatch
+     * \public
+     */
+    BenchTimer(void):m_Start(chrono::steady_clock::now()){};
+
+    /*! \fn double elapsedNs(void)
+     * \brief Returns the nanoseconds since the stopwatch was started
+     * \public
+     */
+    double elapsedNs(void)
+    {
+        return chrono::duration<double, nano>(chrono::steady_clock::now() - m_Start).count();
+    };
+
+    /*! \fn void report(const char *p_Name, unsigned long p_Operations)
+     * \brief Prints the BENCH line of the measurement
+     * @param [in] const char *p_Name The name of the measured path
+     * @param [in] unsigned long p_Operations The number of operations timed
+     * \public
+     */
+    void report(const char *p_Name, unsigned long p_Operations)
+    {
+        double l_Ns = elapsedNs();
+        printf("BENCH,%s,%lu,%.2f\n", p_Name, p_Operations, p_Operations ? l_Ns/p_Operations : 0.0);
+    };
+
+private:
+
+    chrono::steady_clock::time_point m_Start;
+};
+
+/*! \fn inline uint32_t benchRandom(uint32_t &p_State)
+ * \brief Returns the next value of a xorshift generator
+ * \details The benchmarks use a fixed seed so that the runs are repeatable
+ */
+inline uint32_t benchRandom(uint32_t &p_State)
+{
+    p_State ^= p_State << 13;
+    p_State ^= p_State >> 17;
+    p_State ^= p_State << 5;
+    return p_State;
+}
+
+/*!
+ * Keeps the result of a timed loop alive so that the compiler cannot
+ * remove the loop
+ */
+#define BENCH_KEEP(x) do { volatile long l_Keep = (long)(x); (void)l_Keep; } while(0)
+
+
+#endif /* _BENCHTOOLS_H_ */
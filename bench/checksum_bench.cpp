@@ -0,0 +1,88 @@
+/*! \file checksum_bench.cpp
+ *  \brief     Micro benchmark of the Internet checksum kernels
+ *  \details   Times the verification of 20 octet IPv4 headers one at a
+ *  time with the scalar reference and with the selected kernel, and in
+ *  bursts with Checksum::verifyBatch. The sum of a whole PDU is timed
+ *  as well.
+ */
+
+
+#include "../Checksum.hpp"
+#include "../PacketBuffer.hpp"
+#include "BenchTools.hpp"
+#include <cstring>
+#include <vector>
+
+/*!
+ * The number of headers in the working set
+ */
+#define CHECKSUM_BENCH_HEADERS 1024
+
+/*!
+ * The number of headers in a burst, as in the DataPlane
+ */
+#define CHECKSUM_BENCH_BURST 32
+
+/*!
+ * The number of times the working set is verified
+ */
+#define CHECKSUM_BENCH_ROUNDS 2000
+
+
+int main(void)
+{
+    uint32_t l_Seed = 362436069u;
+    vector<unsigned char> l_Storage(CHECKSUM_BENCH_HEADERS * 20);
+    const unsigned char *l_Headers[CHECKSUM_BENCH_HEADERS];
+    unsigned l_Lengths[CHECKSUM_BENCH_HEADERS];
+    bool l_Valid[CHECKSUM_BENCH_HEADERS];
+
+    for (int i = 0; i < CHECKSUM_BENCH_HEADERS; i++)
+        {
+            unsigned char *l_Header = &l_Storage[i * 20];
+            for (int j = 0; j < 20; j++)
+                l_Header[j] = benchRandom(l_Seed) & 0xFF;
+            Checksum::fill(l_Header, 20, 10);
+            l_Headers[i] = l_Header;
+            l_Lengths[i] = 20;
+        }
+
+    const unsigned long l_Operations = (unsigned long)CHECKSUM_BENCH_HEADERS * CHECKSUM_BENCH_ROUNDS;
+    long l_ValidCount = 0;
+    printf("Checksum kernel: %s\n", Checksum::getKernel());
+
+    BenchTimer l_ReferenceTimer;
+    for (int r = 0; r < CHECKSUM_BENCH_ROUNDS; r++)
+        for (int i = 0; i < CHECKSUM_BENCH_HEADERS; i++)
+            l_ValidCount += Checksum::referenceSum(l_Headers[i], 20) == 0xFFFF;
+    l_ReferenceTimer.report("checksum_verify_reference", l_Operations);
+
+    BenchTimer l_VerifyTimer;
+    for (int r = 0; r < CHECKSUM_BENCH_ROUNDS; r++)
+        for (int i = 0; i < CHECKSUM_BENCH_HEADERS; i++)
+            l_ValidCount += Checksum::verify(l_Headers[i], 20);
+    l_VerifyTimer.report("checksum_verify", l_Operations);
+
+    BenchTimer l_BatchTimer;
+    for (int r = 0; r < CHECKSUM_BENCH_ROUNDS; r++)
+        for (int i = 0; i < CHECKSUM_BENCH_HEADERS; i += CHECKSUM_BENCH_BURST)
+            l_ValidCount += Checksum::verifyBatch(&l_Headers[i], &l_Lengths[i], CHECKSUM_BENCH_BURST, &l_Valid[i]);
+    l_BatchTimer.report("checksum_verify_batch", l_Operations);
+
+    if(l_ValidCount != 3 * (long)l_Operations)
+        {
+            fprintf(stderr, "checksum_bench: valid headers were rejected\n");
+            return 1;
+        }
+
+    unsigned char l_PDU[MTU];
+    memcpy(l_PDU, &l_Storage[0], MTU);
+    long l_Sum = 0;
+    BenchTimer l_PDUTimer;
+    for (int r = 0; r < CHECKSUM_BENCH_ROUNDS * 100; r++)
+        l_Sum += Checksum::sum(l_PDU, MTU);
+    l_PDUTimer.report("checksum_sum_mtu", CHECKSUM_BENCH_ROUNDS * 100);
+    BENCH_KEEP(l_Sum);
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+/*! \file fib_bench.cpp
+ *  \brief     Micro benchmark of the forwarding table
+ *  \details   Compiles a table of random prefixes into ForwardingTable
+ *  and times the lookups of random addresses. The table is compiled by
+ *  the first lookup, which is timed separately. The same addresses are
+ *  looked up from LPMTrie, the table that the FIB replaced on the
+ *  forwarding path, for comparison. The size of the compiled table is
+ *  printed as MEMORY,fib,[BYTES].
+ */
+
+
+#include "../ForwardingTable.hpp"
+#include "BenchTools.hpp"
+#include <cstdio>
+#include <vector>
+
+/*!
+ * The number of prefixes in the table
+ */
+#define FIB_BENCH_PREFIXES 100000
+
+/*!
+ * The number of timed lookups
+ */
+#define FIB_BENCH_LOOKUPS 10000000
+
+
+int main(void)
+{
+    uint32_t l_Seed = 88172645u;
+    ForwardingTable l_Fib;
+    LPMTrie<int> l_Trie;
+    vector<unsigned> l_Addresses;
+
+    BenchTimer l_SetTimer;
+    for(int i = 0; i < FIB_BENCH_PREFIXES; i++)
+        {
+            unsigned l_Prefix = benchRandom(l_Seed);
+            int l_Length = benchRandom(l_Seed) % 4 ? 24 : 8 + benchRandom(l_Seed) % 25;
+            l_Fib.setRoute(l_Prefix, l_Length, i % 16);
+            l_Trie.insert(l_Prefix, l_Length, i % 16);
+            l_Addresses.push_back(l_Prefix);
+        }
+    l_SetTimer.report("fib_set_route", FIB_BENCH_PREFIXES);
+
+    //half of the addresses hit an inserted prefix, the other half are random
+    for(unsigned i = 0; i < l_Addresses.size(); i += 2)
+        l_Addresses[i] = benchRandom(l_Seed);
+
+    BenchTimer l_CompileTimer;
+    long l_Sum = l_Fib.lookup(l_Addresses[0]);
+    l_CompileTimer.report("fib_compile", FIB_BENCH_PREFIXES);
+    printf("MEMORY,fib,%lu\n", l_Fib.getMemoryUsage());
+
+    BenchTimer l_FibTimer;
+    for(int i = 0; i < FIB_BENCH_LOOKUPS; i++)
+        l_Sum += l_Fib.lookup(l_Addresses[i % l_Addresses.size()]);
+    l_FibTimer.report("fib_lookup", FIB_BENCH_LOOKUPS);
+
+    int l_Port;
+    BenchTimer l_TrieTimer;
+    for(int i = 0; i < FIB_BENCH_LOOKUPS; i++)
+        l_Sum += l_Trie.lookup(l_Addresses[i % l_Addresses.size()], l_Port) ? l_Port : -1;
+    l_TrieTimer.report("fib_trie_lookup", FIB_BENCH_LOOKUPS);
+    BENCH_KEEP(l_Sum);
+
+    return 0;
+}
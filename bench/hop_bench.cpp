@@ -0,0 +1,92 @@
+/*! \file hop_bench.cpp
+ *  \brief     Micro benchmark of the PDU copies on the forwarding path
+ *  \details   Passes IP packets hop by hop through
+ *  PacketProcessor::forwardBurst, which validates each packet and
+ *  rewrites its TTL and checksum through Packet::mutablePDU, as the
+ *  data plane does. Two hops are timed:
+ *  \li hop_fifo: the frame is copied into a FIFO slot and read out of
+ *  it as sc_fifo does, so the slot still shares the PDU when the TTL
+ *  is rewritten
+ *  \li hop_channel: the frame is moved through the SPSCRing of the
+ *  SPSCChannel that connects the interfaces to the data plane
+ *
+ *  Besides the BENCH line, each hop prints the number of PDU copies
+ *  per hop: COPIES,[NAME],[HOPS],[COPIES_PER_HOP]
+ */
+
+
+#include "../PacketProcessor.hpp"
+#include "../SPSCChannel.hpp"
+#include "BenchTools.hpp"
+#include <utility>
+
+const char *g_ReportID = "Level_info:";
+const char *g_DebugID = "Level_debug:";
+const char *g_DebugCPID = "Level_debug_CP";
+const char *g_DebugBSID = "Level_debug_BS";
+const char *g_DebugRTID = "Level_debug_RT";
+const char *g_ErrorID = "Level_error";
+
+/*!
+ * The number of timed hops of each kind
+ */
+#define HOP_BENCH_HOPS 1000000
+
+
+/*! \fn static void runHops(const char *p_Name, bool p_Fifo)
+ * \brief Forwards packets for HOP_BENCH_HOPS hops and prints the results
+ * @param [in] const char *p_Name The name of the measurement
+ * @param [in] bool p_Fifo true: the frame passes a FIFO slot - false:
+ * the frame is moved through the channel
+ */
+static void runHops(const char *p_Name, bool p_Fifo)
+{
+    PacketPool l_Pool(64);
+    PacketProcessor l_Processor(p_Name);
+    l_Processor.setPacketPool(&l_Pool);
+
+    SPSCRing<Packet> l_Channel(SPSC_CHANNEL_SIZE);
+    Packet l_Frame, l_Slot, l_Read;
+    bool l_Ready;
+    unsigned long l_Copies = 0;
+    BenchTimer l_Timer;
+    for(int i = 0; i < HOP_BENCH_HOPS; i++)
+        {
+            //a new packet when the TTL of the previous one runs out
+            if(!l_Frame.hasPDU())
+                {
+                    l_Frame = move(l_Processor.buildIPPacket("10.0.0.2", "10.0.0.1", "bench"));
+                    l_Frame.setProtocolType(TYPE_IP);
+                }
+
+            if(p_Fifo)
+                {
+                    l_Slot = l_Frame;
+                    l_Frame.clearPacket();
+                    l_Read = l_Slot;
+                }
+            else
+                {
+                    l_Channel.push(move(l_Frame));
+                    l_Channel.pop(l_Read);
+                }
+
+            const unsigned char *l_Received = l_Read.getPDU();
+            if(l_Processor.forwardBurst(&l_Read, 1, &l_Ready) == 1)
+                {
+                    l_Copies += l_Read.getPDU() != l_Received;
+                    l_Frame = move(l_Read);
+                }
+            else
+                l_Read.clearPacket();
+        }
+    l_Timer.report(p_Name, HOP_BENCH_HOPS);
+    printf("COPIES,%s,%d,%.2f\n", p_Name, HOP_BENCH_HOPS, (double)l_Copies/HOP_BENCH_HOPS);
+}
+
+int sc_main(int argc, char *argv[])
+{
+    runHops("hop_fifo", true);
+    runHops("hop_channel", false);
+    return 0;
+}
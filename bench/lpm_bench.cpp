@@ -0,0 +1,142 @@
+/*! \file lpm_bench.cpp
+ *  \brief     Micro benchmark of the longest prefix match trie
+ *  \details   Inserts a table of random prefixes into LPMTrie and times
+ *  the lookups of random addresses. The lengths are drawn from /8 to
+ *  /32 with most of them at /24, as in the routing tables of the
+ *  simulations.
+ *
+ *  The baseline is the routing table that the trie replaced: a list of
+ *  routes with the prefixes as dotted strings, walked from head to
+ *  tail for every lookup, keeping the last route with the longest
+ *  common leading characters. It is timed with fewer lookups, as each
+ *  of them visits every route.
+ */
+
+
+#include "../LPMTrie.hpp"
+#include "BenchTools.hpp"
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*!
+ * The number of prefixes in the trie
+ */
+#define LPM_BENCH_PREFIXES 100000
+
+/*!
+ * The number of timed lookups
+ */
+#define LPM_BENCH_LOOKUPS 10000000
+
+/*!
+ * The number of timed lookups of the list baseline
+ */
+#define LPM_BENCH_LIST_LOOKUPS 1000
+
+/*!
+ * \brief A route of the list baseline
+ */
+struct struct_ListRoute
+{
+    string prefix;
+    int mask;
+    int OutputPort;
+};
+
+/*! \fn static string toDotted(unsigned p_Address)
+ * \brief Returns the address in the dotted decimal notation
+ */
+static string toDotted(unsigned p_Address)
+{
+    ostringstream l_Dotted;
+    l_Dotted << (p_Address >> 24) << "." << ((p_Address >> 16) & 0xff) << "." << ((p_Address >> 8) & 0xff) << "." << (p_Address & 0xff);
+    return l_Dotted.str();
+}
+
+/*! \fn static int matchLength(const struct_ListRoute& p_Route, const string& p_IP)
+ * \brief The match length of the list baseline: the number of leading
+ * characters that the address and the prefix have in common
+ */
+static int matchLength(const struct_ListRoute& p_Route, const string& p_IP)
+{
+    int l_Length = 0;
+    for(unsigned i = 0; i < p_IP.size() && i < p_Route.prefix.size(); i++)
+        {
+            if(p_IP[i] != p_Route.prefix[i])
+                break;
+            l_Length++;
+        }
+    return l_Length;
+}
+
+/*! \fn static int findRoute(const list<struct_ListRoute>& p_Table, const string& p_IP)
+ * \brief The lookup of the list baseline
+ * \return int: the output port of the last route with the longest match
+ */
+static int findRoute(const list<struct_ListRoute>& p_Table, const string& p_IP)
+{
+    int l_LongestMatch = 0, l_Port = -1;
+    for(list<struct_ListRoute>::const_iterator it = p_Table.begin(); it != p_Table.end(); ++it)
+        {
+            int l_Length = matchLength(*it, p_IP);
+            if(l_Length >= l_LongestMatch)
+                {
+                    l_LongestMatch = l_Length;
+                    l_Port = it->OutputPort;
+                }
+        }
+    return l_Port;
+}
+
+
+int main(void)
+{
+    uint32_t l_Seed = 2463534242u;
+    LPMTrie<int> l_Trie;
+    list<struct_ListRoute> l_List;
+    vector<unsigned> l_Addresses;
+    vector<int> l_Lengths;
+
+    BenchTimer l_InsertTimer;
+    for(int i = 0; i < LPM_BENCH_PREFIXES; i++)
+        {
+            unsigned l_Prefix = benchRandom(l_Seed);
+            int l_Length = benchRandom(l_Seed) % 4 ? 24 : 8 + benchRandom(l_Seed) % 25;
+            l_Trie.insert(l_Prefix, l_Length, i);
+            l_Addresses.push_back(l_Prefix);
+            l_Lengths.push_back(l_Length);
+        }
+    l_InsertTimer.report("lpm_insert", LPM_BENCH_PREFIXES);
+
+    for(int i = 0; i < LPM_BENCH_PREFIXES; i++)
+        {
+            struct_ListRoute l_Route = {toDotted(LPMTrie<int>::maskPrefix(l_Addresses[i], l_Lengths[i])), l_Lengths[i], i};
+            l_List.push_back(l_Route);
+        }
+
+    //half of the addresses hit an inserted prefix, the other half are random
+    for(unsigned i = 0; i < l_Addresses.size(); i += 2)
+        l_Addresses[i] = benchRandom(l_Seed);
+
+    long l_Hits = 0;
+    int l_Value;
+    BenchTimer l_LookupTimer;
+    for(int i = 0; i < LPM_BENCH_LOOKUPS; i++)
+        l_Hits += l_Trie.lookup(l_Addresses[i % l_Addresses.size()], l_Value);
+    l_LookupTimer.report("lpm_lookup", LPM_BENCH_LOOKUPS);
+
+    //the old path was given the destination as a string
+    vector<string> l_Dotted;
+    for(int i = 0; i < LPM_BENCH_LIST_LOOKUPS; i++)
+        l_Dotted.push_back(toDotted(l_Addresses[i % l_Addresses.size()]));
+
+    BenchTimer l_ListTimer;
+    for(int i = 0; i < LPM_BENCH_LIST_LOOKUPS; i++)
+        l_Hits += findRoute(l_List, l_Dotted[i]);
+    l_ListTimer.report("lpm_list_lookup", LPM_BENCH_LIST_LOOKUPS);
+    BENCH_KEEP(l_Hits);
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*! \file update_bench.cpp
+ *  \brief     Micro benchmark of the UPDATE message codec
+ *  \details   Times the encoding and the decoding of UPDATE messages
+ *  that carry an AS_PATH of typical length and a varying number of
+ *  NLRI prefixes. The comma separated m_Message strings of the old
+ *  model, one route per message, are built and parsed from the same
+ *  routes as the baseline.
+ */
+
+
+#include "../BGPUpdate.hpp"
+#include "BenchTools.hpp"
+#include <string>
+#include <sstream>
+#include <vector>
+
+/*!
+ * The number of timed encodes and decodes of each message size
+ */
+#define UPDATE_BENCH_ROUNDS 200000
+
+/*!
+ * The number of timed builds and parses of the string messages of
+ * each message size
+ */
+#define UPDATE_BENCH_STRING_ROUNDS 20000
+
+
+/*! \fn static string toDotted(unsigned p_Address)
+ * \brief Returns the address in the dotted form of the old routes
+ */
+static string toDotted(unsigned p_Address)
+{
+    stringstream ss;
+    ss << (p_Address >> 24) << "." << ((p_Address >> 16) & 0xff) << "."
+       << ((p_Address >> 8) & 0xff) << "." << (p_Address & 0xff);
+    return ss.str();
+}
+
+/*! \fn static string buildMessage(const string& p_Prefix, int p_Mask, const string& p_ASes)
+ * \brief Builds the advertisement string the way the old routing
+ * table did, e.g. "1,10.0.0.0,8,100-200-300"
+ */
+static string buildMessage(const string& p_Prefix, int p_Mask, const string& p_ASes)
+{
+    stringstream ss;
+    string l_Message = "1,";
+    l_Message.append(p_Prefix);
+    l_Message.append(",");
+    ss << p_Mask;
+    l_Message.append(ss.str());
+    l_Message.append(",");
+    l_Message.append(p_ASes);
+    return l_Message;
+}
+
+/*! \fn static int parseMessage(const string& p_Message, string& p_Prefix, vector<unsigned>& p_ASPath)
+ * \brief Splits the advertisement string with find and substr the way
+ * the old routing table did and returns the mask
+ */
+static int parseMessage(const string& p_Message, string& p_Prefix, vector<unsigned>& p_ASPath)
+{
+    int l_PrefixEnd = p_Message.find(",", 2);
+    int l_MaskEnd = p_Message.find(",", l_PrefixEnd + 1);
+    p_Prefix = p_Message.substr(2, l_PrefixEnd - 2);
+    int l_Mask = atoi(p_Message.substr(l_PrefixEnd + 1, l_MaskEnd - l_PrefixEnd - 1).c_str());
+    string l_ASes = p_Message.substr(l_MaskEnd + 1);
+
+    p_ASPath.clear();
+    size_t l_Position = 0;
+    size_t l_Next;
+    while((l_Next = l_ASes.find("-", l_Position)) != string::npos)
+        {
+            p_ASPath.push_back(atoi(l_ASes.substr(l_Position, l_Next - l_Position).c_str()));
+            l_Position = l_Next + 1;
+        }
+    p_ASPath.push_back(atoi(l_ASes.substr(l_Position).c_str()));
+    return l_Mask;
+}
+
+
+int main(void)
+{
+    uint32_t l_Seed = 1812433253u;
+    unsigned char l_Buffer[BGP_MAX_MESSAGE_LENGTH];
+    const int l_Sizes[] = {1, 10, 100};
+
+    for(unsigned s = 0; s < sizeof(l_Sizes)/sizeof(l_Sizes[0]); s++)
+        {
+            BGPUpdate l_Update;
+            l_Update.m_Origin = ORIGIN_IGP;
+            l_Update.m_NextHop = benchRandom(l_Seed);
+            for(int i = 0; i < 5; i++)
+                l_Update.m_ASPath.push_back(1 + benchRandom(l_Seed) % 65000);
+            for(int i = 0; i < l_Sizes[s]; i++)
+                {
+                    int l_Length = 16 + i % 9;
+                    l_Update.addNLRI(benchRandom(l_Seed) & (0xffffffffu << (32 - l_Length)), l_Length);
+                }
+
+            string l_Suffix = "_" + to_string(l_Sizes[s]) + "_nlri";
+            long l_Octets = 0;
+            BenchTimer l_EncodeTimer;
+            for(int i = 0; i < UPDATE_BENCH_ROUNDS; i++)
+                l_Octets += l_Update.encode(l_Buffer, sizeof(l_Buffer));
+            l_EncodeTimer.report(("update_encode" + l_Suffix).c_str(), UPDATE_BENCH_ROUNDS);
+
+            int l_Encoded = l_Update.encode(l_Buffer, sizeof(l_Buffer));
+            BGPUpdate l_Decoded;
+            BenchTimer l_DecodeTimer;
+            for(int i = 0; i < UPDATE_BENCH_ROUNDS; i++)
+                l_Octets += l_Decoded.decode(l_Buffer, l_Encoded);
+            l_DecodeTimer.report(("update_decode" + l_Suffix).c_str(), UPDATE_BENCH_ROUNDS);
+            BENCH_KEEP(l_Octets);
+
+            if(!(l_Decoded == l_Update))
+                {
+                    fprintf(stderr, "update_bench: decoded message differs from the encoded one\n");
+                    return 1;
+                }
+
+            //the old path sends one string message per prefix
+            vector<string> l_Prefixes;
+            for(unsigned i = 0; i < l_Update.m_NLRI.size(); i++)
+                l_Prefixes.push_back(toDotted(l_Update.m_NLRI[i].prefix));
+            string l_ASes;
+            for(unsigned i = 0; i < l_Update.m_ASPath.size(); i++)
+                l_ASes += (i ? "-" : "") + to_string(l_Update.m_ASPath[i]);
+
+            vector<string> l_Messages(l_Prefixes.size());
+            BenchTimer l_BuildTimer;
+            for(int r = 0; r < UPDATE_BENCH_STRING_ROUNDS; r++)
+                for(unsigned i = 0; i < l_Prefixes.size(); i++)
+                    {
+                        l_Messages[i] = buildMessage(l_Prefixes[i], l_Update.m_NLRI[i].length, l_ASes);
+                        l_Octets += l_Messages[i].size();
+                    }
+            l_BuildTimer.report(("update_string_build" + l_Suffix).c_str(), UPDATE_BENCH_STRING_ROUNDS);
+
+            string l_Prefix;
+            vector<unsigned> l_ASPath;
+            BenchTimer l_ParseTimer;
+            for(int r = 0; r < UPDATE_BENCH_STRING_ROUNDS; r++)
+                for(unsigned i = 0; i < l_Messages.size(); i++)
+                    l_Octets += parseMessage(l_Messages[i], l_Prefix, l_ASPath);
+            l_ParseTimer.report(("update_string_parse" + l_Suffix).c_str(), UPDATE_BENCH_STRING_ROUNDS);
+            BENCH_KEEP(l_Octets);
+
+            if(l_Prefix != l_Prefixes.back() || l_ASPath != l_Update.m_ASPath)
+                {
+                    fprintf(stderr, "update_bench: parsed string differs from the built one\n");
+                    return 1;
+                }
+        }
+    return 0;
+}
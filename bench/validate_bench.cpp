@@ -0,0 +1,89 @@
+/*! \file validate_bench.cpp
+ *  \brief     Micro benchmark of the IPv4 header validation
+ *  \details   Times PacketProcessor::processFrame for valid packets and
+ *  for packets with a bad checksum, and PacketProcessor::forwardBurst
+ *  for bursts of valid packets. The drop reports of the invalid
+ *  packets are disabled, as they are at the default report level.
+ */
+
+
+#include "../PacketProcessor.hpp"
+#include "BenchTools.hpp"
+#include <cstring>
+#include <utility>
+
+const char *g_ReportID = "Level_info:";
+const char *g_DebugID = "Level_debug:";
+const char *g_DebugCPID = "Level_debug_CP";
+const char *g_DebugBSID = "Level_debug_BS";
+const char *g_DebugRTID = "Level_debug_RT";
+const char *g_ErrorID = "Level_error";
+
+/*!
+ * The number of timed packets of each kind
+ */
+#define VALIDATE_BENCH_PACKETS 2000000
+
+/*!
+ * The number of packets in a burst
+ */
+#define VALIDATE_BENCH_BURST 32
+
+
+int sc_main(int argc, char *argv[])
+{
+    sc_report_handler::set_actions(g_ErrorID, SC_WARNING, SC_DO_NOTHING);
+
+    PacketProcessor l_Processor("validate_bench");
+    Packet l_Valid(move(l_Processor.buildIPPacket("10.0.0.2", "10.0.0.1", "bench")));
+    l_Valid.setProtocolType(TYPE_IP);
+    Packet l_Invalid(l_Valid);
+    l_Invalid.mutablePDU()[CHECKSUM_FIELD] ^= 0xff;
+
+    long l_Accepted = 0;
+    BenchTimer l_ValidTimer;
+    for(int i = 0; i < VALIDATE_BENCH_PACKETS; i++)
+        l_Accepted += l_Processor.processFrame(l_Valid);
+    l_ValidTimer.report("process_frame_valid", VALIDATE_BENCH_PACKETS);
+
+    BenchTimer l_InvalidTimer;
+    for(int i = 0; i < VALIDATE_BENCH_PACKETS; i++)
+        l_Accepted += l_Processor.processFrame(l_Invalid);
+    l_InvalidTimer.report("process_frame_invalid", VALIDATE_BENCH_PACKETS);
+
+    if(l_Accepted != VALIDATE_BENCH_PACKETS)
+        {
+            fprintf(stderr, "validate_bench: unexpected validation results\n");
+            return 1;
+        }
+
+    //each frame gets a PDU of its own, and its header is restored
+    //after every burst so that the TTL never runs out
+    Packet l_Burst[VALIDATE_BENCH_BURST];
+    bool l_Ready[VALIDATE_BENCH_BURST];
+    unsigned char l_Header[HEADER_LENGTH];
+    memcpy(l_Header, l_Valid.getPDU(), HEADER_LENGTH);
+    for(int i = 0; i < VALIDATE_BENCH_BURST; i++)
+        {
+            l_Burst[i].setProtocolType(TYPE_IP);
+            l_Burst[i].setPDU(l_Valid.getPDU());
+        }
+
+    long l_Forwarded = 0;
+    BenchTimer l_BurstTimer;
+    for(int i = 0; i < VALIDATE_BENCH_PACKETS/VALIDATE_BENCH_BURST; i++)
+        {
+            l_Forwarded += l_Processor.forwardBurst(l_Burst, VALIDATE_BENCH_BURST, l_Ready);
+            for(int j = 0; j < VALIDATE_BENCH_BURST; j++)
+                memcpy(l_Burst[j].mutablePDU(), l_Header, HEADER_LENGTH);
+        }
+    l_BurstTimer.report("forward_burst", l_Forwarded);
+
+    if(l_Forwarded != VALIDATE_BENCH_PACKETS/VALIDATE_BENCH_BURST*VALIDATE_BENCH_BURST)
+        {
+            fprintf(stderr, "validate_bench: packets were dropped from the bursts\n");
+            return 1;
+        }
+
+    return 0;
+}
@@ -12,6 +12,11 @@
 #include "Configuration.hpp"
 #include "GUIProtocolTags.hpp"
 #include "PacketProcessor.hpp"
+#include "PartitionedSimulation.hpp"
+#include "ConfigurationParser.hpp"
+#include <chrono>
+#include <fstream>
+#include <sys/resource.h>
 
 //!Defines the file name for the VCD output.
 //#define VCD_FILE_NAME "anjosi_ex3_vcd"
@@ -41,16 +46,11 @@ const char* g_SimulationVersion = "Test run";
 int sc_main(int argc, char * argv [])
 {
 
-    ///field parsing states
-    enum fieldStates{S_AS_ID, S_PREFIX, S_MED, S_LOCAL_PREF, S_KEEPALIVE, S_HOLDDOWNMUL, S_PORT_ID};
-
-    ///Initiate a Server socket and bind it to port
-    ServerSocket SimulationServer ( PORT );
-    ///Declare a Server socket for the GUI connection
-    ServerSocket GUISocket;
     ///Instantiate a SimulationConfig object to store simulation
     ///configuration received from the GUI
     SimulationConfig l_Config;
+    ///Parses the configuration from the GUI or from a batch file
+    ConfigurationParser l_Parser;
 
 
     StringTools converter;
@@ -85,8 +85,10 @@ int sc_main(int argc, char * argv [])
 
     StringTools l_DebugReport("Main");
 #if defined (_GUI) || defined(_GUI_TEST)
-    RouterConfig *ptr_Router;
-
+    ///Initiate a Server socket and bind it to port
+    ServerSocket SimulationServer ( PORT );
+    ///Declare a Server socket for the GUI connection
+    ServerSocket GUISocket;
     ///Accept the GUI connection
     cout << "Waiting the GUI to connect..." << endl;
     SimulationServer.accept ( GUISocket );
@@ -94,7 +96,7 @@ int sc_main(int argc, char * argv [])
     GUISocket.set_non_blocking(true);
     ///String buffer for received data
     string DataWord, temp;
-    bool setupLoop = true, retrans = false;
+    bool setupLoop = true;
     cout << "Receiving from the GUI..." << endl;
 
     //Simulation loop
@@ -122,17 +124,8 @@ int sc_main(int argc, char * argv [])
                 {
                     SC_REPORT_INFO(g_DebugMainID, l_DebugReport.newReportString("Start tag found"));
 
-                    ///start tag found. Continue to parse the
-                    ///configuration string
-
-                    ///Set the string index
-                    unsigned i_End, i_Start = START_TAG_LENGTH;
-
-                    ///find the end tag
-                    i_End = DataWord.find(END_TAG, i_Start);
-
                     ///check that end tag was found
-                    if(i_End == string::npos)
+                    if(DataWord.find(END_TAG, START_TAG_LENGTH) == string::npos)
                         {
                             ///If end tag was not found, send NACK to
                             ///GUI and continue receiving
@@ -140,194 +133,10 @@ int sc_main(int argc, char * argv [])
                             continue;
                         }
 
-                    ///Determine the number of routers
-                    unsigned count = 1;
-                    while(i_Start < i_End)
-                        {
-                            i_Start = DataWord.find(ROUTER_SEPARATOR, i_Start+1);
-                            if (i_Start != string::npos)
-                                {
-                                    count++;
-                                }
-                            else
-                                break;
-                        }
-
-                    l_DebugReport.newReportString("Count: ");
-                    SC_REPORT_INFO(g_DebugMainID, l_DebugReport.appendReportString(count));
-
-                    ///set the number of routers
-                    l_Config.init(count);
-
-                    ///reset the i_Start
-                    i_Start = START_TAG_LENGTH;
-
-                    ///define an index and initiate it to zero
-                    unsigned l_Idx = 0;
-
-                    ///Parse the fields of all the routers
-                    while(l_Idx < count) //Start of router field loop
-                        {
-
-                            l_DebugReport.newReportString("Router field #");
-                            SC_REPORT_INFO(g_DebugMainID, l_DebugReport.appendReportString(l_Idx));
-
-                            ///declare and set the end and start
-                            ///indeices for router parameters
-                            unsigned j_Start = i_Start, j_End;
-
-                            ///find the end of the router field
-                            if(l_Idx == count-1) //the last router
-                                {
-                                    j_End = DataWord.find(END_TAG, i_Start);
-                                    setupLoop = false;
-                                }
-                            else //other than the last router
-                                j_End = DataWord.find(ROUTER_SEPARATOR, i_Start);
-
-                            ///set the state to AS_ID
-                            fieldStates state = S_AS_ID;
-                            unsigned k_End = j_End;
-
-                            ///Init router configuration object for
-                            ///this
-                            l_Config.addRouterConfig(l_Idx, IF_COUNT);
-
-                            ///refer to the previous
-                            ptr_Router = l_Config.getRouterConfigurationPtr(l_Idx);
-
-                            bool parse = true;
-
-                            ///parse until all the fields are extracted
-                            while(parse) //Start of field loop
-                                {
-
-                                    string field;
-
-                                    ///parse the fields one by one
-                                    k_End = DataWord.find(FIELD_SEPARATOR, j_Start);
-
-                                    ///check the exception cases
-                                    if (k_End > j_End || k_End == string::npos)
-                                        {
-                                            ///this is the end of the router field
-                                            k_End = j_End; //set the end index accordingly
-                                            parse = false;  //this is the final iteration in the while loop
-                                            SC_REPORT_INFO(g_DebugMainID, l_DebugReport.newReportString("End of router field."));
-
-                                        }
-                                    l_DebugReport.newReportString("j_Start: ");
-                                    SC_REPORT_INFO(g_DebugMainID, l_DebugReport.appendReportString(j_Start));
-                                    l_DebugReport.newReportString("k_End: ");
-                                    SC_REPORT_INFO(g_DebugMainID, l_DebugReport.appendReportString(k_End));
-
-
-                                    ///get the field
-                                    field = DataWord.substr(j_Start, k_End-j_Start);
-
-                                    l_DebugReport.newReportString("Field: ");
-                                    SC_REPORT_INFO(g_DebugMainID, l_DebugReport.appendReportString(field.c_str()));
-
-
-
-                                    int l_IntField = 0;
-
-                                    string subField = "";
-                                    int m_Start = 0, m_End, tempFields[3];
-
-                                    ///store the field
-                                    switch (state)
-                                        {
-                                        case S_AS_ID:
-                                        	istringstream(field) >> l_IntField;
-                                            ptr_Router->setASNumber(l_IntField);
-                                            state = S_PREFIX;
-                                            break;
-                                        case S_PREFIX:
-                                        	ptr_Router->setPrefix(field);
-                                            state = S_MED;
-                                            break;
-                                        case S_MED:
-                                           	istringstream(field) >> l_IntField;
-                                            ptr_Router->setMED(l_IntField);
-                                            state = S_LOCAL_PREF;
-                                            break;
-                                        case S_LOCAL_PREF:
-                                           	istringstream(field) >> l_IntField;
-                                            ptr_Router->setLocalPref(l_IntField);
-                                            state = S_KEEPALIVE;
-                                            break;
-                                        case S_KEEPALIVE:
-                                           	istringstream(field) >> l_IntField;
-                                            ptr_Router->setKeepaliveTime(l_IntField);
-                                            state = S_HOLDDOWNMUL;
-                                            break;
-                                        case S_HOLDDOWNMUL:
-                                           	istringstream(field) >> l_IntField;
-                                            ptr_Router->setHoldDownTimeFactor(l_IntField);
-                                            state = S_PORT_ID;
-                                            break;
-                                        case S_PORT_ID:
-
-                                            for(int i = 0; i < 3; i++)
-                                                {
-                                                    //parse each
-                                                    //connecion field:
-                                                    //local port id,
-                                                    //client port id,
-                                                    //client id
-                                                    m_End = field.find(CONNECTION_SEPARATOR, m_Start);
-
-                                                    ///store the sub field
-                                                    subField = field.substr(m_Start, m_End-m_Start);
-
-
-                                                    l_DebugReport.newReportString("subField: ");
-                                                    SC_REPORT_INFO(g_DebugMainID, l_DebugReport.appendReportString(subField.c_str()));
-
-
-                                                    ///Store each
-                                                    ///sub field into a
-                                                    ///temporary array
-                                                    istringstream(subField) >> tempFields[i];
-
-                                                    ///update the
-                                                    ///index for the
-                                                    ///next iteration
-                                                    m_Start = m_End + 1;
-                                                }
-
-                                            ///Store the connection
-                                            ///parameters to the
-                                            ///connection confi object
-                                            ptr_Router->addConnectionConfig(tempFields[0], tempFields[1], tempFields[2]);
-
-                                            break;
-                                        default:
-                                            retrans = true;
-                                        }
-
-                                    j_Start = k_End + 1;
-
-                                    if(retrans)
-                                        break;
-
-                                    i_Start = k_End + 1;
-                                }//end of field loop
-
-                            if(retrans)
-                                break;
-
-
-                            l_Idx++;
-
-                        } //End of router field loop
-
-                    if(retrans)
-                        {
-                            retrans = false;
-                            continue;
-                        }
+                    ///Parse the fields of all the routers. A
+                    ///malformed configuration is received again.
+                    if(l_Parser.parseConfiguration(DataWord, l_Config))
+                        setupLoop = false;
 
                 }
             else
@@ -392,44 +201,80 @@ int sc_main(int argc, char * argv [])
 
 #else
 
-    cout << "CONF"<< endl;
-//testing the simulation configuration
-    ///set the number of routers
-    l_Config.init(3);
-
-    l_Config.addRouterConfig(0, 4);
-    l_Config.addRouterConfig(1, 4);
-    l_Config.addRouterConfig(2, 4);
-    cout << "CONF"<< endl;
-    l_Config.addBGPSessionParameters(0, 60, 3);
-    l_Config.addBGPSessionParameters(1, 60, 3);
-    l_Config.addBGPSessionParameters(2, 60, 3);
-	
-	//set AS number here
-    l_Config.getRouterConfiguration(0).setASNumber(101);
-    l_Config.getRouterConfiguration(1).setASNumber(201);
-    l_Config.getRouterConfiguration(2).setASNumber(301);
-
-    //set Prefix
-    string l_Prefix = "11.0.0.0/8";
-    l_Config.getRouterConfiguration(0).setPrefix(l_Prefix);
-    l_Prefix = "12.0.0.0/8";
-    l_Config.getRouterConfiguration(1).setPrefix(l_Prefix);
-    l_Prefix = "13.0.0.0/8";
-    l_Config.getRouterConfiguration(2).setPrefix(l_Prefix);
-
-    //    int p_LocalRouterId, int p_LocalInterfaceId, int p_NeighborInterfaceId, int p_NeighborRouterId
-    l_Config.addConnectionConfig(0, 0, 0, 1 );
-    l_Config.addConnectionConfig(1, 0, 0, 0 );
-    l_Config.addConnectionConfig(1, 1, 0, 2 );
-    l_Config.addConnectionConfig(2, 0, 1, 1 );
-    l_Config.addConnectionConfig(2, 1, 1, 0 );
-    l_Config.addConnectionConfig(0, 1, 1, 2 );
+    ///Headless batch mode: the configuration, the duration and the
+    ///commands are read from the file given as the first argument
+    bool l_Batch = argc > 1;
+    ///No port is bound, so batch runs can run next to each other and
+    ///next to a GUI session. The socket of the simulation stays
+    ///unconnected.
+    ServerSocket GUISocket;
 
+    if(l_Batch)
+        {
+            if(!l_Parser.readBatchFile(argv[1], l_Config))
+                {
+                    cerr << "Cannot read the batch file " << argv[1] << endl;
+                    return 1;
+                }
+        }
+    else
+        {
+            cout << "CONF"<< endl;
+            //testing the simulation configuration
+            ///set the number of routers
+            l_Config.init(3);
+
+            l_Config.addRouterConfig(0, 4);
+            l_Config.addRouterConfig(1, 4);
+            l_Config.addRouterConfig(2, 4);
+            cout << "CONF"<< endl;
+            l_Config.addBGPSessionParameters(0, 60, 3);
+            l_Config.addBGPSessionParameters(1, 60, 3);
+            l_Config.addBGPSessionParameters(2, 60, 3);
+
+            //set AS number here
+            l_Config.getRouterConfiguration(0).setASNumber(101);
+            l_Config.getRouterConfiguration(1).setASNumber(201);
+            l_Config.getRouterConfiguration(2).setASNumber(301);
+
+            //set Prefix
+            string l_Prefix = "11.0.0.0/8";
+            l_Config.getRouterConfiguration(0).setPrefix(l_Prefix);
+            l_Prefix = "12.0.0.0/8";
+            l_Config.getRouterConfiguration(1).setPrefix(l_Prefix);
+            l_Prefix = "13.0.0.0/8";
+            l_Config.getRouterConfiguration(2).setPrefix(l_Prefix);
+
+            //    int p_LocalRouterId, int p_LocalInterfaceId, int p_NeighborInterfaceId, int p_NeighborRouterId
+            l_Config.addConnectionConfig(0, 0, 0, 1 );
+            l_Config.addConnectionConfig(1, 0, 0, 0 );
+            l_Config.addConnectionConfig(1, 1, 0, 2 );
+            l_Config.addConnectionConfig(2, 0, 1, 1 );
+            l_Config.addConnectionConfig(2, 1, 1, 0 );
+            l_Config.addConnectionConfig(0, 1, 1, 2 );
+        }
+
+    ///the resident size before the model is built
+    struct rusage l_BaselineUsage;
+    getrusage(RUSAGE_SELF, &l_BaselineUsage);
+    long l_BaselineKB = l_BaselineUsage.ru_maxrss;
+
+
+#ifdef _PARTITIONED
+    ///run the routers in parallel partitions, one per processor
+    PartitionedSimulation l_Partitioned(&l_Config, PartitionedSimulation::getDefaultNumberOfPartitions());
+    cout << "START " << l_Partitioned.getNumberOfPartitions() << " partitions" << endl;
+    ///the partitions write their results and they are merged into the
+    ///file given as the second argument
+    bool l_Finished = l_Partitioned.run(sc_time(l_Parser.getDuration(), SC_SEC), l_Parser.getCommands(), l_Batch ? string(argc > 2 ? argv[2] : RESULTS_FILE_NAME) : string());
+    SC_REPORT_INFO(g_ReportID, StringTools("Main").newReportString("Simulation ends"));
+    return l_Finished ? 0 : 1;
+#endif
 
 #endif
 
 
+#ifndef _EVENT_DRIVEN
   /* Clock period intialization.
    * The clock period is 10 ns.
    */
@@ -444,6 +289,14 @@ int sc_main(int argc, char * argv [])
 
   ///connect the clock
   test.port_Clk(clk);
+#else
+  ///initiate the simulation, whose processes wait for their events
+  Simulation test("Test", GUISocket, &l_Config);
+#endif
+
+  ///schedule the commands of the batch file
+  for(unsigned i = 0; i < l_Parser.getCommands().size(); i++)
+      test.scheduleCommand(l_Parser.getCommands()[i]);
   SC_REPORT_INFO(g_ReportID, StringTools("Main").newReportString("Simulation starts"));
 
 
@@ -456,7 +309,23 @@ cout << "START"<< endl;
 
   //  ptr_Router = NULL;
 #else
-  sc_start(SIMULATION_DURATION, SC_SEC);
+  chrono::steady_clock::time_point l_WallClockStart = chrono::steady_clock::now();
+  sc_start(l_Parser.getDuration(), SC_SEC);
+  double l_WallClock = chrono::duration<double>(chrono::steady_clock::now() - l_WallClockStart).count();
+
+  if(l_Batch)
+      {
+          ///write the results into the file given as the second
+          ///argument
+          ofstream l_Results(argc > 2 ? argv[2] : RESULTS_FILE_NAME);
+          test.writeUsage(l_Results, l_WallClock, l_BaselineKB);
+          test.writeResults(l_Results);
+          if(!l_Results)
+              {
+                  cerr << "Cannot write the results" << endl;
+                  return 1;
+              }
+      }
 #endif
 
 
@@ -113,6 +113,12 @@
  */
 #define READ_RAW_TABLE "READ_RAW_TABLE" //READ_RAW_TABLE,[ROUTER_ID]
 
+/*!
+ * Reads the route cache statistics of the given router:
+ * cache_size,hits,misses
+ */
+#define READ_ROUTE_CACHE "READ_ROUTE_CACHE" //READ_ROUTE_CACHE,[ROUTER_ID]
+
 /*!
  * Set the local preference value for the give AS in the given router
  */
@@ -128,6 +134,16 @@
  */
 #define SET_HOLDDOWN_MULT "SET_HOLDDOWN_MULT" // SET_HOLDDOWN_MULT,[ROUTER_ID],[VALUE]
 
+/*!
+ * Set the MinRouteAdvertisementInterval for the given router
+ */
+#define SET_MRAI "SET_MRAI" // SET_MRAI,[ROUTER_ID],[VALUE]
+
+/*!
+ * Withdraw a prefix originated by the given router from its peers
+ */
+#define WITHDRAW_PREFIX "WITHDRAW_PREFIX" // WITHDRAW_PREFIX,[ROUTER_ID],[PREFIX],[LENGTH]
+
 /*!
  * return the interface status information as a string:
  * receivingbuf_available_slot_count, forwardingbuf_available_slot_count, interface_state
@@ -135,6 +151,41 @@
 #define SHOW_IF "SHOW_IF" // SHOW_IF,[ROUTER_ID],[IF_ID]
 
 
+///************************ Batch file *******************************
+
+/*!
+ * Sets the duration of a batch run in seconds
+ */
+#define DURATION_TAG "DURATION" //DURATION,[SECONDS]
+
+/*!
+ * Schedules a simulation command of a batch run
+ */
+#define AT_TAG "AT" //AT,[SECONDS],[COMMAND],[PARAMETERS]
+
+/*!
+ * Generates the configuration instead of a configuration string
+ */
+#define TOPOLOGY_TAG "TOPOLOGY" //TOPOLOGY,[line|ring|grid|mesh|ba],[ROUTERS],[PARAMETER],[SEED],[PREFIXES_PER_AS]
+
+/*!
+ * Sets the number of packets that the data plane and the interfaces
+ * handle per clock, for all the routers or for the given one
+ */
+#define BURST_TAG "BURST" //BURST,[PACKETS],[ROUTER_ID]
+
+/*!
+ * Sets the number of packet buffers in the pool of the data plane, for
+ * all the routers or for the given one
+ */
+#define PACKET_POOL_TAG "PACKET_POOL" //PACKET_POOL,[BUFFERS],[ROUTER_ID]
+
+/*!
+ * Default name of the results file of a batch run
+ */
+#define RESULTS_FILE_NAME "results.txt"
+
+
 ///************************ Program modes *******************************
 
 #define SIMULATION_DURATION 10
@@ -0,0 +1,43 @@
+/*! \file  TestTools.hpp
+ *  \brief     Header file of the unit test helpers
+ *  \details   Defines the check macro shared by the programs in tests/
+ */
+
+/*!
+ * \details Each program in tests/ checks one module of the model. A
+ * failed check prints its file, line and expression, and the program
+ * exits with the number of failed checks. The last line of a program
+ * is TEST,[NAME],[CHECKS],[FAILURES]
+ */
+
+
+#include <cstdio>
+
+using namespace std;
+
+
+#ifndef _TESTTOOLS_H_
+#define _TESTTOOLS_H_
+
+/*!
+ * The number of checks done and failed by the program
+ */
+static int g_Checks = 0;
+static int g_Failures = 0;
+
+/*!
+ * Checks that the expression is true
+ */
+#define CHECK(x) do { g_Checks++; if(!(x)) { g_Failures++; fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #x); } } while(0)
+
+/*! \fn inline int testResult(const char *p_Name)
+ * \brief Prints the TEST line and returns the exit status of the program
+ */
+inline int testResult(const char *p_Name)
+{
+    printf("TEST,%s,%d,%d\n", p_Name, g_Checks, g_Failures);
+    return g_Failures;
+}
+
+
+#endif /* _TESTTOOLS_H_ */
@@ -0,0 +1,173 @@
+/*! \file checksum_test.cpp
+ *  \brief     Unit tests of the Checksum module
+ *  \details   Checks the sums against the known vectors of RFC 1071
+ *  and RFC 1624, and the selected and batched kernels against the
+ *  scalar reference
+ */
+
+
+#include "../Checksum.hpp"
+#include "TestTools.hpp"
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+/*!
+ * The IPv4 header of a UDP packet from 192.168.0.1 to 192.168.0.199
+ * with the checksum 0xB861
+ */
+static const unsigned char s_Header[20] = {0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11,
+                                           0xB8, 0x61, 0xC0, 0xA8, 0x00, 0x01, 0xC0, 0xA8, 0x00, 0xC7};
+
+
+/*! \fn static void storeSum(unsigned short p_Sum, unsigned char *p_Octets)
+ * \brief Stores a sum in the host byte order as the octets of the wire
+ */
+static void storeSum(unsigned short p_Sum, unsigned char *p_Octets)
+{
+    memcpy(p_Octets, &p_Sum, sizeof(p_Sum));
+}
+
+/*! \fn static void testRFC1071(void)
+ * \brief The example of section 3 of RFC 1071
+ * \details The octets 00 01 f2 03 f4 f5 f6 f7 sum to dd f2
+ */
+static void testRFC1071(void)
+{
+    const unsigned char l_Data[8] = {0x00, 0x01, 0xF2, 0x03, 0xF4, 0xF5, 0xF6, 0xF7};
+    unsigned char l_Sum[2];
+
+    storeSum(Checksum::sum(l_Data, sizeof(l_Data)), l_Sum);
+    CHECK(l_Sum[0] == 0xDD && l_Sum[1] == 0xF2);
+    storeSum(Checksum::referenceSum(l_Data, sizeof(l_Data)), l_Sum);
+    CHECK(l_Sum[0] == 0xDD && l_Sum[1] == 0xF2);
+
+    //an odd last octet is padded with zero: dd f2 + f8 00 = d5 f3
+    const unsigned char l_Odd[9] = {0x00, 0x01, 0xF2, 0x03, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8};
+    storeSum(Checksum::sum(l_Odd, sizeof(l_Odd)), l_Sum);
+    CHECK(l_Sum[0] == 0xD5 && l_Sum[1] == 0xF3);
+}
+
+/*! \fn static void testHeader(void)
+ * \brief Verifies and fills the checksum of a known IPv4 header
+ */
+static void testHeader(void)
+{
+    unsigned char l_Header[20];
+    memcpy(l_Header, s_Header, sizeof(l_Header));
+    CHECK(Checksum::verify(l_Header, sizeof(l_Header)));
+
+    l_Header[10] = l_Header[11] = 0xAA;
+    CHECK(!Checksum::verify(l_Header, sizeof(l_Header)));
+    Checksum::fill(l_Header, sizeof(l_Header), 10);
+    CHECK(l_Header[10] == 0xB8 && l_Header[11] == 0x61);
+
+    l_Header[8] ^= 0x01;
+    CHECK(!Checksum::verify(l_Header, sizeof(l_Header)));
+}
+
+/*! \fn static void testRFC1624(void)
+ * \brief The example of section 4 of RFC 1624 and a TTL decrement
+ * \details HC = 0xDD2F, m = 0x5555 and m' = 0x3285 give HC' = 0x0000
+ */
+static void testRFC1624(void)
+{
+    CHECK(Checksum::update(0xDD2F, 0x5555, 0x3285) == 0x0000);
+
+    //the incremental update of a TTL decrement equals a full recompute
+    unsigned char l_Header[20];
+    memcpy(l_Header, s_Header, sizeof(l_Header));
+    uint16_t l_Old, l_New, l_Checksum;
+    memcpy(&l_Old, &l_Header[8], sizeof(l_Old));
+    l_Header[8]--;
+    memcpy(&l_New, &l_Header[8], sizeof(l_New));
+    memcpy(&l_Checksum, &l_Header[10], sizeof(l_Checksum));
+    l_Checksum = Checksum::update(l_Checksum, l_Old, l_New);
+    memcpy(&l_Header[10], &l_Checksum, sizeof(l_Checksum));
+    CHECK(Checksum::verify(l_Header, sizeof(l_Header)));
+
+    unsigned char l_Filled[20];
+    memcpy(l_Filled, l_Header, sizeof(l_Filled));
+    Checksum::fill(l_Filled, sizeof(l_Filled), 10);
+    CHECK(memcmp(l_Filled, l_Header, sizeof(l_Header)) == 0);
+}
+
+/*! \fn static void testKernels(void)
+ * \brief Compares the selected kernel to the scalar reference
+ * \details All the lengths up to 200 octets and all the alignments
+ * within 32 octets are summed
+ */
+static void testKernels(void)
+{
+    unsigned char l_Data[256];
+    srand(1071);
+    for (unsigned i = 0; i < sizeof(l_Data); i++)
+        l_Data[i] = rand() & 0xFF;
+
+    bool l_Equal = true;
+    for (unsigned l_Offset = 0; l_Offset < 32; l_Offset++)
+        for (unsigned l_Length = 0; l_Length <= 200; l_Length++)
+            l_Equal = l_Equal && Checksum::sum(&l_Data[l_Offset], l_Length) == Checksum::referenceSum(&l_Data[l_Offset], l_Length);
+    CHECK(l_Equal);
+
+    //all ones in every octet exercise the carries
+    memset(l_Data, 0xFF, sizeof(l_Data));
+    CHECK(Checksum::sum(l_Data, sizeof(l_Data)) == 0xFFFF);
+}
+
+/*! \fn static void testBatch(void)
+ * \brief Compares verifyBatch to verify
+ * \details The batches mix headers with and without options and with
+ * valid and corrupted checksums, and their sizes cover the partial
+ * groups of the vector kernels
+ */
+static void testBatch(void)
+{
+    srand(1624);
+    const int l_Max = 40;
+    vector<unsigned char> l_Storage(l_Max * 24 + 1);
+    const unsigned char *l_Headers[l_Max];
+    unsigned l_Lengths[l_Max];
+    bool l_Valid[l_Max];
+
+    for (int l_Round = 0; l_Round < 50; l_Round++)
+        for (int l_Count = 0; l_Count <= l_Max; l_Count++)
+            {
+                int l_Expected = 0;
+                bool l_Equal = true;
+                //the headers start at odd offsets to test unaligned loads
+                unsigned char *l_Next = &l_Storage[1];
+                for (int i = 0; i < l_Count; i++)
+                    {
+                        l_Lengths[i] = (l_Round % 2 == 0 || rand() % 8) ? 20 : 24;
+                        for (unsigned j = 0; j < l_Lengths[i]; j++)
+                            l_Next[j] = rand() & 0xFF;
+                        Checksum::fill(l_Next, l_Lengths[i], 10);
+                        if(rand() % 3 == 0)
+                            l_Next[rand() % l_Lengths[i]] ^= 1 << (rand() % 8);
+                        l_Headers[i] = l_Next;
+                        l_Next += l_Lengths[i];
+                    }
+
+                int l_ValidCount = Checksum::verifyBatch(l_Headers, l_Lengths, l_Count, l_Valid);
+                for (int i = 0; i < l_Count; i++)
+                    {
+                        bool l_Reference = Checksum::referenceSum(l_Headers[i], l_Lengths[i]) == 0xFFFF;
+                        l_Equal = l_Equal && l_Valid[i] == l_Reference;
+                        l_Expected += l_Reference;
+                    }
+                CHECK(l_Equal && l_ValidCount == l_Expected);
+            }
+}
+
+
+int main(void)
+{
+    printf("Checksum kernel: %s\n", Checksum::getKernel());
+    testRFC1071();
+    testHeader();
+    testRFC1624();
+    testKernels();
+    testBatch();
+    return testResult("checksum");
+}
@@ -0,0 +1,92 @@
+/*! \file duplicatefilter_test.cpp
+ *  \brief     Unit tests of the DuplicateFilter module
+ *  \details   Checks the window of the message ids, the epochs of a
+ *  restarted peer and the reset of a stopped session
+ */
+
+
+#include "../DuplicateFilter.hpp"
+#include "TestTools.hpp"
+
+
+/*! \fn static void testWindow(void)
+ * \brief Repeated and reordered ids within one epoch
+ */
+static void testWindow(void)
+{
+    DuplicateFilter l_Filter;
+
+    CHECK(l_Filter.accept(0, 1));
+    CHECK(l_Filter.accept(0, 2));
+    CHECK(!l_Filter.accept(0, 2));
+    CHECK(!l_Filter.accept(0, 1));
+
+    //a reordered id inside the window is accepted once
+    CHECK(l_Filter.accept(0, 5));
+    CHECK(l_Filter.accept(0, 4));
+    CHECK(!l_Filter.accept(0, 4));
+    CHECK(l_Filter.accept(0, 3));
+
+    //the oldest id of the window and the first one beyond it
+    CHECK(l_Filter.accept(0, 5 + DUPLICATE_WINDOW - 1));
+    CHECK(!l_Filter.accept(0, 5));
+    CHECK(l_Filter.accept(0, 5 + DUPLICATE_WINDOW));
+    CHECK(!l_Filter.accept(0, 5));
+
+    CHECK(l_Filter.getAccepted() == 7);
+    CHECK(l_Filter.getDuplicates() == 5);
+    CHECK(l_Filter.getRestarts() == 0);
+}
+
+/*! \fn static void testEpochs(void)
+ * \brief A revived peer numbers its messages from 1 again
+ * \details The session of the receiver is not stopped in between, so
+ * only the epoch tells the new messages from the late copies
+ */
+static void testEpochs(void)
+{
+    DuplicateFilter l_Filter;
+
+    for(unsigned long i = 1; i <= 100; i++)
+        CHECK(l_Filter.accept(0, i));
+
+    //the peer is killed and revived
+    CHECK(l_Filter.accept(1, 1));
+    CHECK(l_Filter.accept(1, 2));
+    CHECK(!l_Filter.accept(1, 1));
+    CHECK(l_Filter.getRestarts() == 1);
+
+    //a late copy from before the restart, even with a new looking id
+    CHECK(!l_Filter.accept(0, 3));
+    CHECK(!l_Filter.accept(0, 100));
+    CHECK(l_Filter.accept(1, 3));
+
+    CHECK(l_Filter.getAccepted() == 103);
+    CHECK(l_Filter.getDuplicates() == 3);
+}
+
+/*! \fn static void testReset(void)
+ * \brief A stopped session forgets the ids but not the epoch
+ */
+static void testReset(void)
+{
+    DuplicateFilter l_Filter;
+
+    CHECK(l_Filter.accept(2, 1));
+    CHECK(l_Filter.accept(2, 2));
+    l_Filter.reset();
+
+    CHECK(l_Filter.accept(2, 1));
+    CHECK(!l_Filter.accept(1, 7));
+    CHECK(l_Filter.getRestarts() == 1);
+    CHECK(l_Filter.getStatistics() == "3,1,1");
+}
+
+
+int main(void)
+{
+    testWindow();
+    testEpochs();
+    testReset();
+    return testResult("duplicatefilter");
+}
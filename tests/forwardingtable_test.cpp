@@ -0,0 +1,81 @@
+/*! \file forwardingtable_test.cpp
+ *  \brief     Unit tests of the ForwardingTable module
+ *  \details   Checks the lookups of short and long prefixes, the
+ *  removal of routes and the blocks that are looked up in the trie
+ *  once the second level groups are used up
+ */
+
+
+#include "../ForwardingTable.hpp"
+#include "TestTools.hpp"
+#include <string>
+
+/*!
+ * The number of /24 blocks with a longer prefix, more than the groups
+ */
+#define FIB_TEST_BLOCKS (FIB_MAX_GROUPS + 1000)
+
+
+/*! \fn static void testLongestMatch(void)
+ * \brief The most specific route wins on both levels
+ */
+static void testLongestMatch(void)
+{
+    ForwardingTable l_Fib;
+
+    l_Fib.setRoute(0x0A000000, 8, 1);
+    l_Fib.setRoute(0x0A010200, 24, 2);
+    l_Fib.setRoute(0x0A010280, 25, 3);
+
+    CHECK(l_Fib.lookup(0x0A7F0001) == 1);
+    CHECK(l_Fib.lookup(0x0A010201) == 2);
+    CHECK(l_Fib.lookup(0x0A0102FF) == 3);
+    CHECK(l_Fib.lookup(0x0B000001) == -1);
+
+    //the covered entries fall back to the less specific routes
+    l_Fib.removeRoute(0x0A010280, 25);
+    CHECK(l_Fib.lookup(0x0A0102FF) == 2);
+    l_Fib.removeRoute(0x0A010200, 24);
+    CHECK(l_Fib.lookup(0x0A0102FF) == 1);
+}
+
+/*! \fn static void testGroupOverflow(void)
+ * \brief The blocks beyond FIB_MAX_GROUPS resolve through the trie
+ */
+static void testGroupOverflow(void)
+{
+    ForwardingTable l_Fib;
+
+    //a /24 and a /25 with another port in each block
+    for(unsigned i = 0; i < FIB_TEST_BLOCKS; i++)
+        {
+            l_Fib.setRoute(i << 8, 24, 1);
+            l_Fib.setRoute((i << 8) | 0x80, 25, 2 + i % 7);
+        }
+
+    int l_Wrong = 0;
+    for(unsigned i = 0; i < FIB_TEST_BLOCKS; i++)
+        if(l_Fib.lookup((i << 8) | 0x01) != 1 || l_Fib.lookup((i << 8) | 0x81) != 2 + (int)(i % 7))
+            l_Wrong++;
+    CHECK(l_Wrong == 0);
+    CHECK(l_Fib.getStatistics().substr(l_Fib.getStatistics().rfind(',') + 1) == "1000");
+
+    //a block left without long prefixes returns to the first level
+    for(unsigned i = 0; i < FIB_TEST_BLOCKS; i++)
+        l_Fib.removeRoute((i << 8) | 0x80, 25);
+
+    l_Wrong = 0;
+    for(unsigned i = 0; i < FIB_TEST_BLOCKS; i++)
+        if(l_Fib.lookup((i << 8) | 0x81) != 1)
+            l_Wrong++;
+    CHECK(l_Wrong == 0);
+    CHECK(l_Fib.getStatistics().substr(l_Fib.getStatistics().rfind(',') + 1) == "0");
+}
+
+
+int main(void)
+{
+    testLongestMatch();
+    testGroupOverflow();
+    return testResult("forwardingtable");
+}